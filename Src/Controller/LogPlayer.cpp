@@ -9,6 +9,7 @@
 #include <QImage>
 #include "LogPlayer.h"
 #include "Representations/Perception/JPEGImage.h"
+#include "Representations/Perception/LosslessImage.h"
 #include "Platform/SystemCall.h"
 #include "Platform/BHAssert.h"
 #include "Platform/File.h"
@@ -53,8 +54,12 @@ bool LogPlayer::open(const char* fileName)
         file >> *this;
         break;
       case logFileCompressed://compressed log file
+      case logFileChunked://log file with compressed and uncompressed chunks, e.g. images
         while(!file.eof())
         {
+          bool compressed = true;
+          if(magicByte == logFileChunked)
+            file >> compressed;
           unsigned compressedSize;
           file >> compressedSize;
           ASSERT(compressedSize > 0);
@@ -62,11 +67,16 @@ bool LogPlayer::open(const char* fileName)
           compressedBuffer.resize(compressedSize);
           file.read(&compressedBuffer[0], (int)compressedSize);
 
-          size_t uncompressedSize = 0;
-          snappy_uncompressed_length(&compressedBuffer[0], compressedSize, &uncompressedSize);
+          size_t uncompressedSize = compressedSize;
           std::vector<char> uncompressBuffer;
-          uncompressBuffer.resize(uncompressedSize);
-          snappy_uncompress(&compressedBuffer[0], compressedSize, &uncompressBuffer[0], &uncompressedSize);
+          if(compressed)
+          {
+            snappy_uncompressed_length(&compressedBuffer[0], compressedSize, &uncompressedSize);
+            uncompressBuffer.resize(uncompressedSize);
+            snappy_uncompress(&compressedBuffer[0], compressedSize, &uncompressBuffer[0], &uncompressedSize);
+          }
+          else
+            uncompressBuffer.swap(compressedBuffer);
           InBinaryMemory mem(&uncompressBuffer[0], uncompressedSize);
           totalUncompressedSize += uncompressedSize;
 
@@ -146,7 +156,7 @@ void LogPlayer::stepForward()
     do
     {
       copyMessage(++currentMessageNumber, targetQueue);
-      if(queue.getMessageID() == idImage || queue.getMessageID() == idJPEGImage)
+      if(queue.getMessageID() == idImage || queue.getMessageID() == idJPEGImage || queue.getMessageID() == idLosslessImage)
         lastImageFrameNumber = currentFrameNumber;
     }
     while(queue.getMessageID() != idProcessFinished);
@@ -225,6 +235,12 @@ bool LogPlayer::saveImages(const bool raw, const char* fileName)
       in.bin >> jpegImage;
       jpegImage.toImage(image);
     }
+    else if(queue.getMessageID() == idLosslessImage)
+    {
+      LosslessImage losslessImage;
+      in.bin >> losslessImage;
+      losslessImage.toImage(image);
+    }
     else
       continue;
 
@@ -280,7 +296,7 @@ bool LogPlayer::replay()
       do
       {
         copyMessage(++currentMessageNumber, targetQueue);
-        if(queue.getMessageID() == idImage || queue.getMessageID() == idJPEGImage)
+        if(queue.getMessageID() == idImage || queue.getMessageID() == idJPEGImage || queue.getMessageID() == idLosslessImage)
           lastImageFrameNumber = currentFrameNumber;
       }
       while(queue.getMessageID() != idProcessFinished && currentMessageNumber < numberOfMessagesWithinCompleteFrames - 1);
@@ -23,6 +23,7 @@ TimeInfo::TimeInfo(const std::string& name) : processName(name)
 void TimeInfo::reset()
 {
   infos.clear();
+  counterInfos.clear();
   lastFrameNo = 0;
 }
 
@@ -82,6 +83,27 @@ bool TimeInfo::handleMessage(InMessage& message)
     lastStartTime = processStartTime;
     return true;
   }
+  else if(message.getMessageID() == idPerformanceCounters)
+  {
+    timeStamp = SystemCall::getCurrentSystemTime();
+    unsigned char counterCount;
+    unsigned short dataCount;
+    message.bin >> counterCount >> dataCount;
+    for(int i = 0; i < dataCount; ++i)
+    {
+      unsigned short watchId;
+      message.bin >> watchId;
+      CounterInfo& counterInfo = counterInfos[watchId];
+      for(int j = 0; j < counterCount; ++j)
+      {
+        unsigned long long count;
+        message.bin.read(&count, sizeof(count));
+        if(j < PerformanceCounters::numOfCounters)
+          counterInfo[j].add(static_cast<float>(count));
+      }
+    }
+    return true;
+  }
   else
     return false;
 }
@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <unordered_map>
 #include "Tools/RingBufferWithSum.h"
+#include "Tools/Debugging/PerformanceCounters.h"
 
 class InMessage;
 
@@ -32,6 +34,9 @@ public:
   typedef RingBufferWithSum<float, ringBufferSize> Info;
   typedef std::unordered_map<unsigned short, Info> Infos;
   Infos infos;
+  typedef std::array<Info, PerformanceCounters::numOfCounters> CounterInfo; /**< The counts of each performance counter. */
+  typedef std::unordered_map<unsigned short, CounterInfo> CounterInfos;
+  CounterInfos counterInfos; /**< The performance counters of the stop watches. Empty if they are not measured. */
   unsigned int timeStamp; /**< The time stamp of the last change. */
 
   /**
@@ -47,9 +52,9 @@ public:
   TimeInfo(const std::string& name);
 
   /**
-  * The function handles a stop watch message.
+  * The function handles a stop watch or a performance counters message.
   * @param message The message.
-  * @return Was it a stop watch message?
+  * @return Was it a stop watch or a performance counters message?
   */
   bool handleMessage(InMessage& message);
 
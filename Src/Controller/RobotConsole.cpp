@@ -28,6 +28,7 @@
 #include "Views/StateMachineBehaviorView.h"
 #include "Views/ViewBike/ViewBike.h"
 #include "Representations/Perception/JPEGImage.h"
+#include "Representations/Perception/LosslessImage.h"
 #include "TeamRobot.h"
 #include "Platform/File.h"
 #include "Tools/Debugging/DebugDataStreamer.h"
@@ -276,6 +277,15 @@ bool RobotConsole::handleMessage(InMessage& message)
       jpi.toImage(*incompleteImages["raw image"].image);
       return true;
     }
+    case idLosslessImage:
+    {
+      if(!incompleteImages["raw image"].image)
+        incompleteImages["raw image"].image = new Image(false);
+      LosslessImage li;
+      message.bin >> li;
+      li.toImage(*incompleteImages["raw image"].image);
+      return true;
+    }
     case idDebugImage:
     {
       std::string id;
@@ -512,6 +522,7 @@ bool RobotConsole::handleMessage(InMessage& message)
       activationGraphReceived = SystemCall::getCurrentSystemTime();
       return true;
     case idStopwatch:
+    case idPerformanceCounters:
       ASSERT(timeInfos.find(processIdentifier == 'd' ? 'c' : processIdentifier) != timeInfos.end());
         timeInfos.at(processIdentifier == 'd' ? 'c' : processIdentifier).handleMessage(message);
       return true;
@@ -1344,7 +1355,7 @@ bool RobotConsole::log(In& stream)
       if(frequency[i])
       {
         std::string representation = std::string(::getName(MessageID(i))).substr(2);
-        if(representation == "JPEGImage")
+        if(representation == "JPEGImage" || representation == "LosslessImage")
           representation = "Image";
 
         std::string provider;
@@ -205,15 +205,16 @@ private slots:
   void saveColorCalibration()
   {
     ColorReference& cr = imageView.console.colorReference;
-    char buffer[1000];
+    char buffer[1200];
     sprintf(buffer, 
-    "set parameters:ColorProvider minHGreen = %f; maxHGreen = %f; minSGreen = %f; maxSGreen = %f; minVGreen = %f; maxVGreen = %f; minHYellow = %f; maxHYellow = %f; minSYellow = %f; maxSYellow = %f; minVYellow = %f; maxVYellow = %f; minHOrange = %f; maxHOrange = %f; minSOrange = %f; maxSOrange = %f; minVOrange = %f; maxVOrange = %f; minHRed = %f; maxHRed = %f; minSRed = %f; maxSRed = %f; minVRed = %f; maxVRed = %f; minHBlue = %f; maxHBlue = %f; minSBlue = %f; maxSBlue = %f; minVBlue = %f; maxVBlue = %f; minRWhite = %d; minBWhite = %d; minRBWhite = %d; cbBlack = 128; crBlack = 128; maxYBlack = 60;",
+    "set parameters:ColorProvider minHGreen = %f; maxHGreen = %f; minSGreen = %f; maxSGreen = %f; minVGreen = %f; maxVGreen = %f; minHYellow = %f; maxHYellow = %f; minSYellow = %f; maxSYellow = %f; minVYellow = %f; maxVYellow = %f; minHOrange = %f; maxHOrange = %f; minSOrange = %f; maxSOrange = %f; minVOrange = %f; maxVOrange = %f; minHRed = %f; maxHRed = %f; minSRed = %f; maxSRed = %f; minVRed = %f; maxVRed = %f; minHBlue = %f; maxHBlue = %f; minSBlue = %f; maxSBlue = %f; minVBlue = %f; maxVBlue = %f; minRWhite = %d; minBWhite = %d; minRBWhite = %d; cbBlack = 128; crBlack = 128; maxYBlack = 60; layout = %s; yBits = %d; cbBits = %d; crBits = %d;",
     cr.thresholdGreen.hue.min, cr.thresholdGreen.hue.max, cr.thresholdGreen.saturation.min, cr.thresholdGreen.saturation.max, cr.thresholdGreen.value.min, cr.thresholdGreen.value.max,
     cr.thresholdYellow.hue.min, cr.thresholdYellow.hue.max, cr.thresholdYellow.saturation.min, cr.thresholdYellow.saturation.max, cr.thresholdYellow.value.min, cr.thresholdYellow.value.max,
     cr.thresholdOrange.hue.min, cr.thresholdOrange.hue.max, cr.thresholdOrange.saturation.min, cr.thresholdOrange.saturation.max, cr.thresholdOrange.value.min, cr.thresholdOrange.value.max,
     cr.thresholdRed.hue.min, cr.thresholdRed.hue.max, cr.thresholdRed.saturation.min, cr.thresholdRed.saturation.max, cr.thresholdRed.value.min, cr.thresholdRed.value.max,
     cr.thresholdBlue.hue.min, cr.thresholdBlue.hue.max, cr.thresholdBlue.saturation.min, cr.thresholdBlue.saturation.max, cr.thresholdBlue.value.min, cr.thresholdBlue.value.max,
-    cr.thresholdWhite.first, cr.thresholdWhite.second, cr.thresholdWhite.third
+    cr.thresholdWhite.first, cr.thresholdWhite.second, cr.thresholdWhite.third,
+    ColorReference::getName(cr.layout), cr.yBits, cr.cbBits, cr.crBits
     );
     imageView.console.handleConsole(std::string(buffer));
     imageView.console.handleConsole("save parameters:ColorProvider");
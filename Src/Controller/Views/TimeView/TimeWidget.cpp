@@ -31,16 +31,25 @@ struct Row
   NumberTableWidgetItem* min;
   NumberTableWidgetItem* max;
   NumberTableWidgetItem* avg;
+  NumberTableWidgetItem* counters[PerformanceCounters::numOfCounters]; //the average counts, only shown if they are measured
+  NumberTableWidgetItem* ipc; //instructions per cycle
 };
 
+/**The columns of the performance counters. The instructions per cycle are shown after the instructions.*/
+static const int counterColumns[PerformanceCounters::numOfCounters] = {4, 5, 7, 8, 9};
+static const int ipcColumn = 6;
+static const int numOfColumns = 10;
+
 
 TimeWidget::TimeWidget(TimeView& timeView) : timeView(timeView), lastTimeInfoTimeStamp(0)
 {
   table = new QTableWidget();
-  table->setColumnCount(4);
+  table->setColumnCount(numOfColumns);
   QStringList headerNames;
-  headerNames << "Stopwatch" << "Min" << "Max" << "Avg";
+  headerNames << "Stopwatch" << "Min" << "Max" << "Avg" << "Cycles" << "Instructions" << "IPC" << "L1D misses" << "LLC misses" << "Branch misses";
   table->setHorizontalHeaderLabels(headerNames);
+  for(int i = 4; i < numOfColumns; ++i)
+    table->setColumnHidden(i, true);
   table->verticalHeader()->setVisible(false);
   table->setEditTriggers(QAbstractItemView::NoEditTriggers);
   table->verticalHeader()->setResizeMode(QHeaderView::Fixed);
@@ -103,12 +112,19 @@ void TimeWidget::update()
         currentRow->max = new NumberTableWidgetItem();
         currentRow->min = new NumberTableWidgetItem();
         currentRow->name = new QTableWidgetItem();
+        currentRow->ipc = new NumberTableWidgetItem();
         const int rowCount = table->rowCount();
         table->setRowCount(rowCount + 1);
         table->setItem(rowCount, 0, currentRow->name);
         table->setItem(rowCount, 1, currentRow->min);
         table->setItem(rowCount, 2, currentRow->max);
         table->setItem(rowCount, 3, currentRow->avg);
+        for(int j = 0; j < PerformanceCounters::numOfCounters; ++j)
+        {
+          currentRow->counters[j] = new NumberTableWidgetItem();
+          table->setItem(rowCount, counterColumns[j], currentRow->counters[j]);
+        }
+        table->setItem(rowCount, ipcColumn, currentRow->ipc);
         items[i->first] = currentRow;
       }
       float minTime = -1, maxTime = -1, avgTime = -1;
@@ -117,7 +133,19 @@ void TimeWidget::update()
       currentRow->min->setText(QString::number(minTime));
       currentRow->max->setText(QString::number(maxTime));
       currentRow->name->setText(QString(name.c_str())); //refresh name every time to eliminate unknown
+
+      TimeInfo::CounterInfos::const_iterator counterInfo = timeView.info.counterInfos.find(i->first);
+      if(counterInfo != timeView.info.counterInfos.end())
+      {
+        for(int j = 0; j < PerformanceCounters::numOfCounters; ++j)
+          currentRow->counters[j]->setText(QString::number(counterInfo->second[j].getAverage(), 'f', 0));
+        const float cycles = counterInfo->second[PerformanceCounters::cycles].getAverage();
+        const float instructions = counterInfo->second[PerformanceCounters::instructions].getAverage();
+        currentRow->ipc->setText(cycles > 0.f ? QString::number(instructions / cycles, 'f', 2) : QString());
+      }
     }
+    for(int i = 4; i < numOfColumns; ++i)
+      table->setColumnHidden(i, timeView.info.counterInfos.empty());
   }
   applyFilter();
   table->setSortingEnabled(true);
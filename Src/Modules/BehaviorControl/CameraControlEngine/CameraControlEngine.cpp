@@ -10,7 +10,7 @@
 
 #include "CameraControlEngine.h"
 
-MAKE_MODULE(CameraControlEngine, Behavior Control);
+MAKE_PURE_MODULE(CameraControlEngine, Behavior Control);
 
 CameraControlEngine::CameraControlEngine()
 {
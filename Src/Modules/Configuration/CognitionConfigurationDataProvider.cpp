@@ -53,6 +53,8 @@ void CognitionConfigurationDataProvider::update(FieldDimensions& fieldDimensions
     delete theFieldDimensions;
     theFieldDimensions = 0;
   }
+  else
+    keepVersion();
   EXECUTE_ONLY_IN_DEBUG(fieldDimensions.drawPolygons(theOwnTeamInfo.teamColor););
 }
 
@@ -64,6 +66,8 @@ void CognitionConfigurationDataProvider::update(CameraSettings& cameraSettings)
     delete theCameraSettings;
     theCameraSettings = 0;
   }
+  else
+    keepVersion();
 }
 
 void CognitionConfigurationDataProvider::update(CameraCalibration& cameraCalibration)
@@ -74,6 +78,8 @@ void CognitionConfigurationDataProvider::update(CameraCalibration& cameraCalibra
     delete theCameraCalibration;
     theCameraCalibration = 0;
   }
+  else
+    keepVersion();
 }
 
 void CognitionConfigurationDataProvider::update(RobotDimensions& robotDimensions)
@@ -84,6 +90,8 @@ void CognitionConfigurationDataProvider::update(RobotDimensions& robotDimensions
     delete theRobotDimensions;
     theRobotDimensions = 0;
   }
+  else
+    keepVersion();
 }
 
 void CognitionConfigurationDataProvider::update(DamageConfiguration& damageConfiguration)
@@ -94,6 +102,8 @@ void CognitionConfigurationDataProvider::update(DamageConfiguration& damageConfi
     delete theDamageConfiguration;
     theDamageConfiguration = 0;
   }
+  else
+    keepVersion();
 }
 
 void CognitionConfigurationDataProvider::update(HeadLimits& headLimits)
@@ -104,6 +114,8 @@ void CognitionConfigurationDataProvider::update(HeadLimits& headLimits)
     delete theHeadLimits;
     theHeadLimits = 0;
   }
+  else
+    keepVersion();
 }
 
 void CognitionConfigurationDataProvider::readFieldDimensions()
@@ -46,6 +46,8 @@ void MotionConfigurationDataProvider::update(JointCalibration& jointCalibration)
     delete theJointCalibration;
     theJointCalibration = 0;
   }
+  else
+    keepVersion();
   DEBUG_RESPONSE_ONCE("representation:JointCalibration", OUTPUT(idJointCalibration, bin, jointCalibration););
 }
 
@@ -57,6 +59,8 @@ void MotionConfigurationDataProvider::update(SensorCalibration& sensorCalibratio
     delete theSensorCalibration;
     theSensorCalibration = 0;
   }
+  else
+    keepVersion();
 }
 
 void MotionConfigurationDataProvider::update(RobotDimensions& robotDimensions)
@@ -67,6 +71,8 @@ void MotionConfigurationDataProvider::update(RobotDimensions& robotDimensions)
     delete theRobotDimensions;
     theRobotDimensions = 0;
   }
+  else
+    keepVersion();
   DEBUG_RESPONSE_ONCE("representation:RobotDimensions", OUTPUT(idRobotDimensions, bin, robotDimensions););
 }
 
@@ -78,6 +84,8 @@ void MotionConfigurationDataProvider::update(MassCalibration& massCalibration)
     delete theMassCalibration;
     theMassCalibration = 0;
   }
+  else
+    keepVersion();
 }
 
 void MotionConfigurationDataProvider::update(HardnessSettings& hardnessSettings)
@@ -88,6 +96,8 @@ void MotionConfigurationDataProvider::update(HardnessSettings& hardnessSettings)
     delete theHardnessSettings;
     theHardnessSettings = 0;
   }
+  else
+    keepVersion();
 }
 
 void MotionConfigurationDataProvider::update(DamageConfiguration& damageConfiguration)
@@ -98,6 +108,8 @@ void MotionConfigurationDataProvider::update(DamageConfiguration& damageConfigur
     delete theDamageConfiguration;
     theDamageConfiguration = 0;
   }
+  else
+    keepVersion();
 }
 
 void MotionConfigurationDataProvider::readJointCalibration()
@@ -7,14 +7,18 @@
 #include <cstdio>
 
 #include "CameraProvider.h"
-#include "Representations/Perception/JPEGImage.h"
+#include "Tools/ImageProcessing/JPEGEncoder.h"
 #include "Platform/SystemCall.h"
 #include "Tools/Streams/InStreams.h"
 #include "Tools/Debugging/Stopwatch.h"
 
 PROCESS_WIDE_STORAGE(CameraProvider) CameraProvider::theInstance = 0;
 
-CameraProvider::CameraProvider() : currentImageCamera(0)
+/** The number of threads that compress slices of the image in parallel. */
+static const int numOfJPEGWorkers = 2;
+
+CameraProvider::CameraProvider() : currentImageCamera(0), halfResolution(false),
+  halfResolutionImage(maxResolutionWidth * maxResolutionHeight / 2), jpegEncoder(0)
 #ifdef CAMERA_INCLUDED
 , imageTimeStamp(0), otherImageTimeStamp(0), lastImageTimeStamp(0), lastImageTimeStampLL(0)
 #endif
@@ -46,6 +50,8 @@ CameraProvider::~CameraProvider()
   if(lowerCamera)
     delete lowerCamera;
 #endif
+  if(jpegEncoder)
+    delete jpegEncoder;
   theInstance = 0;
 }
 
@@ -62,6 +68,7 @@ void CameraProvider::update(Image& image)
     upperCamera->setSettings(theCameraSettings);
     upperCamera->writeCameraSettings();
     currentImageCamera = upperCamera;
+    halfResolution = theProcessingResolution.isHalf(CameraInfo::upper);
   }
   else if(lowerCamera->hasImage())
   {
@@ -72,13 +79,18 @@ void CameraProvider::update(Image& image)
     lowerCamera->setSettings(theCameraSettings);
     lowerCamera->writeCameraSettings();
     currentImageCamera = lowerCamera;
+    halfResolution = theProcessingResolution.isHalf(CameraInfo::lower);
   }
+  if(halfResolution)
+    ProcessingResolution::subsample(image, halfResolutionImage.data());
   ASSERT(image.timeStamp >= lastImageTimeStamp);
   lastImageTimeStamp = image.timeStamp;
 #endif // CAMERA_INCLUDED
-  STOP_TIME_ON_REQUEST("compressJPEG",
+  DEBUG_RESPONSE("representation:JPEGImage",
   {
-    DEBUG_RESPONSE("representation:JPEGImage", OUTPUT(idJPEGImage, bin, JPEGImage(image)););
+    if(!jpegEncoder)
+      jpegEncoder = new JPEGEncoder(numOfJPEGWorkers);
+    jpegEncoder->start(image);
   });
 }
 
@@ -100,6 +112,9 @@ void CameraProvider::update(CameraInfo& cameraInfo)
     cameraInfo = upperCameraInfo;
   else
     cameraInfo = lowerCameraInfo;
+
+  if(halfResolution)
+    ProcessingResolution::subsample(cameraInfo);
 }
 
 bool CameraProvider::isFrameDataComplete()
@@ -181,6 +196,22 @@ void CameraProvider::waitForFrameData2()
 #endif
 }
 
+void CameraProvider::outputJPEGImage()
+{
+  if(theInstance && theInstance->jpegEncoder && theInstance->jpegEncoder->isBusy())
+    STOP_TIME_ON_REQUEST("compressJPEG", OUTPUT(idJPEGImage, bin, theInstance->jpegEncoder->finish()););
+}
+
+#ifdef CAMERA_INCLUDED
+NaoCamera::Lease CameraProvider::getImageLease()
+{
+  if(theInstance && theInstance->currentImageCamera)
+    return theInstance->currentImageCamera->getLease();
+  else
+    return NaoCamera::Lease();
+}
+#endif
+
 void CameraProvider::waitForFrameData()
 {
 #ifdef CAMERA_INCLUDED
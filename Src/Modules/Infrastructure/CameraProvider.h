@@ -7,6 +7,7 @@
 #pragma once
 
 class NaoCamera;
+class JPEGEncoder;
 
 #include "Tools/Module/Module.h"
 #include "Platform/Camera.h"
@@ -14,10 +15,13 @@ class NaoCamera;
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
+#include <vector>
 
 MODULE(CameraProvider)
   REQUIRES(CameraSettings)
   REQUIRES(Image)
+  REQUIRES(ProcessingResolution)
   PROVIDES_WITH_OUTPUT(Image)
   PROVIDES_WITH_MODIFY_AND_OUTPUT(FrameInfo)
   PROVIDES_WITH_MODIFY(CognitionFrameInfo)
@@ -35,6 +39,9 @@ private:
   CameraInfo upperCameraInfo;
   CameraInfo lowerCameraInfo;
   float cycleTime;
+  bool halfResolution; /**< Is the current image subsampled to half of the resolution of its camera? */
+  std::vector<Image::Pixel> halfResolutionImage; /**< The buffer for the subsampled image. */
+  JPEGEncoder* jpegEncoder; /**< Compresses the image while the other modules are executed. Created when it is needed first. */
 #ifdef CAMERA_INCLUDED
   unsigned int imageTimeStamp;
   unsigned int otherImageTimeStamp;
@@ -68,5 +75,22 @@ public:
   * The method waits for a new image.
   */
   static void waitForFrameData();
+
+  /**
+  * The method sends the JPEG-compressed image if it was requested in this frame.
+  * It must be called after all modules were executed. It only has to wait
+  * if compressing the image took longer than executing the modules.
+  */
+  static void outputJPEGImage();
+
+#ifdef CAMERA_INCLUDED
+  /**
+  * The method returns a lease of the camera buffer the current image was taken from.
+  * The image only references this buffer if it was not subsampled.
+  * @return The lease. It is empty if there is no current image.
+  */
+  static NaoCamera::Lease getImageLease();
+#endif
+
   void waitForFrameData2();
 };
@@ -122,6 +122,17 @@ bool CognitionLogDataProvider::handleMessage2(InMessage& message)
     ((FrameInfo&) *representationBuffer[idFrameInfo]).time = ((Image&) *representationBuffer[idImage]).timeStamp;
     return true;
 
+  case idLosslessImage:
+    ALLOC(Image)
+    {
+      LosslessImage losslessImage;
+      message.bin >> losslessImage;
+      losslessImage.toImage((Image&) *representationBuffer[idImage]);
+    }
+    ALLOC(FrameInfo)
+    ((FrameInfo&) *representationBuffer[idFrameInfo]).time = ((Image&) *representationBuffer[idImage]).timeStamp;
+    return true;
+
   default:
     return false;
   }
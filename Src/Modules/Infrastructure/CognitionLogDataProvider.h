@@ -13,6 +13,7 @@
 #include "LogDataProvider.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Configuration/FieldDimensions.h"
 #include "Representations/Perception/LinePercept.h"
 #include "Representations/Perception/BallPercept.h"
@@ -23,6 +24,7 @@
 #include "Representations/Modeling/BallModel.h"
 #include "Representations/Modeling/RobotsModel.h"
 #include "Representations/Perception/JPEGImage.h"
+#include "Representations/Perception/LosslessImage.h"
 #include "Representations/Infrastructure/JointData.h"
 #include "Representations/Infrastructure/RobotHealth.h"
 #include "Representations/Infrastructure/Thumbnail.h"
@@ -43,6 +45,7 @@ MODULE(CognitionLogDataProvider)
   PROVIDES_WITH_MODIFY_AND_OUTPUT(CameraInfo)
   USES(CameraInfo)
   PROVIDES_WITH_OUTPUT(Image)
+  REQUIRES(ProcessingResolution)
   REQUIRES(FieldDimensions)
   PROVIDES_WITH_MODIFY_AND_OUTPUT(FrameInfo)
   USES(FrameInfo)
@@ -91,8 +94,20 @@ private:
 
 #define DISTANCE 300
 
+  /**
+  * The method returns whether the image of the current frame is processed at half resolution.
+  * @return Must the logged image and camera info be subsampled?
+  */
+  bool isHalfResolution() const
+  {
+    const CameraInfo* cameraInfo = (const CameraInfo*) representationBuffer[idCameraInfo];
+    return theProcessingResolution.isHalf(cameraInfo ? cameraInfo->camera : theCameraInfo.camera);
+  }
+
   UPDATE2(Image,
   {
+    if(representationBuffer[idImage] && isHalfResolution())
+      ProcessingResolution::subsample(_Image);
     DECLARE_DEBUG_DRAWING3D("representation:Image", "camera");
     IMAGE3D("representation:Image", DISTANCE, 0, 0, 0, 0, 0,
             DISTANCE * theCameraInfo.width / theCameraInfo.focalLength,
@@ -100,7 +115,11 @@ private:
             _Image);
     DEBUG_RESPONSE("representation:JPEGImage", OUTPUT(idJPEGImage, bin, JPEGImage(_Image)););
   })
-  UPDATE(CameraInfo)
+  UPDATE2(CameraInfo,
+  {
+    if(representationBuffer[idCameraInfo] && isHalfResolution())
+      ProcessingResolution::subsample(_CameraInfo);
+  })
   UPDATE(FrameInfo)
   UPDATE2(FieldBoundary, _FieldBoundary.width = theImage.width;);
   UPDATE(Thumbnail)
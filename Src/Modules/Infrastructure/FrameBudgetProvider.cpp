@@ -0,0 +1,15 @@
+/**
+* @file FrameBudgetProvider.cpp
+* This file implements a module that provides the decisions of the module manager
+* about skipping optional modules.
+*/
+
+#include "FrameBudgetProvider.h"
+#include "Tools/Module/ModuleManager.h"
+
+void FrameBudgetProvider::update(FrameBudget& frameBudget)
+{
+  frameBudget = ModuleManager::getFrameBudget();
+}
+
+MAKE_MODULE(FrameBudgetProvider, Cognition Infrastructure)
@@ -0,0 +1,23 @@
+/**
+* @file FrameBudgetProvider.h
+* This file declares a module that provides the decisions of the module manager
+* about skipping optional modules.
+*/
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/FrameBudget.h"
+
+MODULE(FrameBudgetProvider)
+  PROVIDES_WITH_MODIFY(FrameBudget)
+END_MODULE
+
+class FrameBudgetProvider : public FrameBudgetProviderBase
+{
+  /**
+  * The method copies the frame budget of the previous frame from the module manager.
+  * @param frameBudget The representation updated.
+  */
+  void update(FrameBudget& frameBudget);
+};
@@ -0,0 +1,33 @@
+/**
+* @file ProcessingResolutionProvider.cpp
+* This file implements a module that decides at which resolution the images of
+* each camera are processed.
+*/
+
+#include "ProcessingResolutionProvider.h"
+#include "Tools/Debugging/DebugDrawings.h"
+
+PROCESS_WIDE_STORAGE(const ProcessingResolution) ProcessingResolutionProvider::forcedResolution = 0;
+
+void ProcessingResolutionProvider::update(ProcessingResolution& processingResolution)
+{
+  // Without a budget (e.g. in the simulator), the images are always processed completely.
+  const float frameLoad = theFrameBudget.budget ? float(theFrameBudget.duration) / float(theFrameBudget.budget) : 0.f;
+  load += (frameLoad - load) * loadSmoothing;
+  DECLARE_PLOT("module:ProcessingResolutionProvider:load");
+  PLOT("module:ProcessingResolutionProvider:load", load);
+
+  const bool ballClose = theFrameInfo.getTimeSince(theBallModel.timeWhenLastSeen) < int(ballTimeout) &&
+                         theBallModel.estimate.position.squareAbs() < closeBallDistance * closeBallDistance;
+
+  if(forcedResolution)
+  {
+    processingResolution = *forcedResolution;
+    return;
+  }
+
+  processingResolution.lowerHalf = load >= (processingResolution.lowerHalf ? lowerLoad - hysteresis : lowerLoad);
+  processingResolution.upperHalf = ballClose && load >= (processingResolution.upperHalf ? upperLoad - hysteresis : upperLoad);
+}
+
+MAKE_MODULE(ProcessingResolutionProvider, Cognition Infrastructure)
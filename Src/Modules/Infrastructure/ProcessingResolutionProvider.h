@@ -0,0 +1,55 @@
+/**
+* @file ProcessingResolutionProvider.h
+* This file declares a module that decides at which resolution the images of
+* each camera are processed. The lower camera is switched to half resolution
+* when the processor is busy. The upper camera follows when the ball is close,
+* because it is large enough in the image to be detected anyway. The module runs
+* before the image is provided, so it only uses the frame info and the ball model
+* of the previous frame.
+*/
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/FrameBudget.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
+#include "Representations/Modeling/BallModel.h"
+
+MODULE(ProcessingResolutionProvider)
+  REQUIRES(FrameBudget)
+  USES(FrameInfo)
+  USES(BallModel)
+  PROVIDES_WITH_MODIFY(ProcessingResolution)
+  DEFINES_PARAMETER(float, lowerLoad, 0.6f) /**< The load above which the lower camera is processed at half resolution. */
+  DEFINES_PARAMETER(float, upperLoad, 0.8f) /**< The load above which the upper camera is processed at half resolution if the ball is close. */
+  DEFINES_PARAMETER(float, hysteresis, 0.1f) /**< The load must drop by this amount below a threshold to switch back to full resolution. */
+  DEFINES_PARAMETER(float, closeBallDistance, 1500.f) /**< The ball is close if it is nearer than this (in mm). */
+  DEFINES_PARAMETER(unsigned, ballTimeout, 1000) /**< The ball is only considered if it was seen within this time (in ms). */
+  DEFINES_PARAMETER(float, loadSmoothing, 0.1f) /**< The weight of the load of the latest frame in the average load. */
+END_MODULE
+
+class ProcessingResolutionProvider : public ProcessingResolutionProviderBase
+{
+private:
+  static PROCESS_WIDE_STORAGE(const ProcessingResolution) forcedResolution; /**< The resolution enforced independent from the load or 0 if there is none. */
+  float load; /**< The average ratio between the duration of a frame and its budget. */
+
+  /**
+  * The method decides about the resolution of the images of both cameras.
+  * @param processingResolution The representation updated.
+  */
+  void update(ProcessingResolution& processingResolution);
+
+public:
+  ProcessingResolutionProvider() : load(0.f) {}
+
+  /**
+  * The method forces the images to be processed at a certain resolution, independent
+  * from the load, e.g. to benchmark the perception at half resolution. It only
+  * affects the instances of this module that run in the calling process.
+  * @param resolution The resolution enforced or 0 to decide based on the load again.
+  *                   The object must exist as long as it is enforced.
+  */
+  static void forceResolution(const ProcessingResolution* resolution) {forcedResolution = resolution;}
+};
@@ -4,28 +4,24 @@
 
 #include "ThumbnailProvider.h"
 #include "Platform/BHAssert.h"
-#include "Tools/MMX.h"
 #include <cmath>
 #include <cstring>
 
-MAKE_MODULE(ThumbnailProvider, Cognition Infrastructure)
+MAKE_OPTIONAL_MODULE(ThumbnailProvider, Cognition Infrastructure, 0.5f)
 
 ThumbnailProvider::ThumbnailProvider() {}
 
 void ThumbnailProvider::update(Thumbnail& thumbnail)
 {
   thumbnail.scale = static_cast<int>(::pow(2.0, downScales));
-  switch(thumbnail.scale)
+  if(downScales >= 1 && downScales <= (unsigned) ImagePyramid::numOfLevels)
   {
-    case 8:
-      shrink8x8SSE(theImage, thumbnail.image);
-      break;
-    case 4:
-      shrink4x4SSE(theImage, thumbnail.image);
-      break;
-    default:
-      shrinkNxN(theImage, thumbnail.image);
+    const ImagePyramid::Level& level = theImagePyramid[downScales];
+    thumbnail.image.setResolution(level.width, level.height);
+    memcpy(thumbnail.image[0], level[0], level.width * level.height * sizeof(Image::Pixel));
   }
+  else
+    shrinkNxN(theImage, thumbnail.image);
 
   thumbnail.compressedImage.compress(thumbnail.image);
 }
@@ -88,131 +84,3 @@ void ThumbnailProvider::shrinkNxN(const Image& srcImage, Thumbnail::ThumbnailIma
 
   delete[] summs;
 }
-
-void ThumbnailProvider::shrink8x8SSE(const Image& srcImage, Thumbnail::ThumbnailImage& destImage)
-{
-  int scaleFactor = 8;
-  int averagedPixels = scaleFactor * scaleFactor;
-  ASSERT(srcImage.width % scaleFactor == 0);
-  ASSERT(srcImage.height % scaleFactor == 0);
-
-  destImage.setResolution(srcImage.width / scaleFactor, srcImage.height / scaleFactor);
-  int height = srcImage.height;
-  int width = srcImage.width;
-
-  static const __m128i zero = _mm_setzero_si128();
-  __m128i* summs = reinterpret_cast<__m128i*>(SystemCall::alignedMalloc(16 * destImage.width, 16));
-  memset(summs, 0, destImage.width * 16);
-
-  const Image::Pixel* pSrc;
-  Thumbnail::ThumbnailImage::PixelType* pDest;
-  __m128i* pSumms;
-
-  __m128i tmp;
-  __m128i lower;
-  __m128i upper;
-
-  for(int y = 0; y < height; ++y)
-  {
-    if(y % scaleFactor == 0)
-    {
-      pDest = destImage[y / scaleFactor];
-    }
-    pSrc = srcImage[y];
-    pSumms = summs;
-    for(int x = 0; x < width; x += scaleFactor, pSrc += scaleFactor, ++pSumms)
-    {
-      tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
-      lower = _mm_unpacklo_epi8(tmp, zero);
-      upper = _mm_unpackhi_epi8(tmp, zero);
-      *pSumms = _mm_add_epi16(*pSumms, lower);
-      *pSumms = _mm_add_epi16(*pSumms, upper);
-
-      tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + scaleFactor / 2));
-      lower = _mm_unpacklo_epi8(tmp, zero);
-      upper = _mm_unpackhi_epi8(tmp, zero);
-      *pSumms = _mm_add_epi16(*pSumms, lower);
-      *pSumms = _mm_add_epi16(*pSumms, upper);
-    }
-
-    if(y % scaleFactor == scaleFactor - 1)
-    {
-      pSumms = summs;
-      for(int i = 0; i < destImage.width; ++i, ++pSumms, ++pDest)
-      {
-        short* ptr = reinterpret_cast<short*>(pSumms);
-
-        short sumY = ptr[offsetof(Image::Pixel, y)] + ptr[offsetof(Image::Pixel, y) + sizeof(Image::Pixel)];
-        short sumCb = ptr[offsetof(Image::Pixel, cb)] + ptr[offsetof(Image::Pixel, cb) + sizeof(Image::Pixel)];
-        short sumCr = ptr[offsetof(Image::Pixel, cr)] + ptr[offsetof(Image::Pixel, cr) + sizeof(Image::Pixel)];
-
-        pDest->y = static_cast<char>(sumY / averagedPixels);
-        pDest->cb = static_cast<char>(sumCb / averagedPixels);
-        pDest->cr = static_cast<char>(sumCr / averagedPixels);
-      }
-      memset(summs, 0, destImage.width * 16);
-    }
-  }
-  SystemCall::alignedFree(summs);
-}
-
-void ThumbnailProvider::shrink4x4SSE(const Image& srcImage, Thumbnail::ThumbnailImage& destImage)
-{
-  int scaleFactor = 4;
-  int averagedPixels = scaleFactor * scaleFactor;
-  ASSERT(srcImage.width % scaleFactor == 0);
-  ASSERT(srcImage.height % scaleFactor == 0);
-
-  destImage.setResolution(srcImage.width / scaleFactor, srcImage.height / scaleFactor);
-  int height = srcImage.height;
-  int width = srcImage.width;
-
-  static const __m128i zero = _mm_setzero_si128();
-  __m128i* summs = reinterpret_cast<__m128i*>(SystemCall::alignedMalloc(16 * destImage.width, 16));
-  memset(summs, 0, destImage.width * 16);
-
-  const Image::Pixel* pSrc;
-  Thumbnail::ThumbnailImage::PixelType* pDest;
-  __m128i* pSumms;
-
-  __m128i tmp;
-  __m128i lower;
-  __m128i upper;
-
-  for(int y = 0; y < height; ++y)
-  {
-    if(y % scaleFactor == 0)
-    {
-      pDest = destImage[y / scaleFactor];
-    }
-    pSrc = srcImage[y];
-    pSumms = summs;
-    for(int x = 0; x < width; x += scaleFactor, pSrc += scaleFactor, ++pSumms)
-    {
-      tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
-      lower = _mm_unpacklo_epi8(tmp, zero);
-      upper = _mm_unpackhi_epi8(tmp, zero);
-      *pSumms = _mm_add_epi16(*pSumms, lower);
-      *pSumms = _mm_add_epi16(*pSumms, upper);
-    }
-
-    if(y % scaleFactor == scaleFactor - 1)
-    {
-      pSumms = summs;
-      for(int i = 0; i < destImage.width; ++i, ++pSumms, ++pDest)
-      {
-        short* ptr = reinterpret_cast<short*>(pSumms);
-
-        short sumY = ptr[offsetof(Image::Pixel, y)] + ptr[offsetof(Image::Pixel, y) + sizeof(Image::Pixel)];
-        short sumCb = ptr[offsetof(Image::Pixel, cb)] + ptr[offsetof(Image::Pixel, cb) + sizeof(Image::Pixel)];
-        short sumCr = ptr[offsetof(Image::Pixel, cr)] + ptr[offsetof(Image::Pixel, cr) + sizeof(Image::Pixel)];
-
-        pDest->y = static_cast<char>(sumY / averagedPixels);
-        pDest->cb = static_cast<char>(sumCb / averagedPixels);
-        pDest->cr = static_cast<char>(sumCr / averagedPixels);
-      }
-      memset(summs, 0, destImage.width * 16);
-    }
-  }
-  SystemCall::alignedFree(summs);
-}
\ No newline at end of file
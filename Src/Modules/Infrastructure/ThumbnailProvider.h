@@ -7,10 +7,12 @@
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/Thumbnail.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Perception/ImagePyramid.h"
 
 MODULE(ThumbnailProvider)
   REQUIRES(Image)
   REQUIRES(CameraInfo)
+  REQUIRES(ImagePyramid)
   PROVIDES_WITH_OUTPUT_AND_DRAW(Thumbnail)
   DEFINES_PARAMETER(unsigned int, downScales, 3)
 END_MODULE
@@ -24,7 +26,4 @@ public:
 
 private:
   void shrinkNxN(const Image& srcImage, Thumbnail::ThumbnailImage& destImage);
-
-  void shrink8x8SSE(const Image& srcImage, Thumbnail::ThumbnailImage& destImage);
-  void shrink4x4SSE(const Image& srcImage, Thumbnail::ThumbnailImage& destImage);
 };
\ No newline at end of file
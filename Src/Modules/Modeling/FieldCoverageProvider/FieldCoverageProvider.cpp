@@ -7,7 +7,7 @@
 #include <list>
 #include <sstream>
 
-MAKE_MODULE(FieldCoverageProvider, Modeling);
+MAKE_OPTIONAL_MODULE(FieldCoverageProvider, Modeling, 1.f);
 
 FieldCoverageProvider::FieldCoverageProvider() :
 range(99999),
@@ -6,7 +6,7 @@
 #include "Tools/Debugging/DebugDrawings3D.h"
 #include "Tools/Math/RotationMatrix.h"
 
-MAKE_MODULE(GlobalFieldCoverageProvider, Modeling)
+MAKE_OPTIONAL_MODULE(GlobalFieldCoverageProvider, Modeling, 1.f)
 
 #define DRAW_CELL_COVERAGE(id, cell, cov) \
   const Vector2<int> coord = FieldCoverage::GridInterval::index2CellCoordinates(i); \
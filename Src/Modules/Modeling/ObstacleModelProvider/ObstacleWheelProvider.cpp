@@ -6,7 +6,7 @@
 #include "Tools/Math/Matrix2x2.h"
 #include "Tools/Math/Vector.h"
 #include "Representations/Infrastructure/JointData.h"
-MAKE_MODULE(ObstacleWheelProvider, Modeling)
+MAKE_CONCURRENT_MODULE(ObstacleWheelProvider, Modeling)
 
 ObstacleWheelProvider::ObstacleWheelProvider() : oldConeWidth(0),
                                                  oldWheelRadius(0), lastDecreaseTimestamp(0), coneCount(0)
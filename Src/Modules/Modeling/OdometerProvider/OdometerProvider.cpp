@@ -9,7 +9,7 @@
 
 #include "OdometerProvider.h"
 
-MAKE_MODULE(OdometerProvider, Modeling)
+MAKE_CONCURRENT_MODULE(OdometerProvider, Modeling)
 
 
 void OdometerProvider::update(Odometer& odometer)
@@ -24,6 +24,8 @@ OwnSideModelProvider::OwnSideModelProvider()
 
 void OwnSideModelProvider::update(OwnSideModel& ownSideModel)
 {
+  const OwnSideModel lastOwnSideModel = ownSideModel;
+
   if(theGameInfo.state == STATE_SET && !theGroundContactState.contact)
     manuallyPlaced = true;
 
@@ -90,6 +92,13 @@ void OwnSideModelProvider::update(OwnSideModel& ownSideModel)
 
   if(theGameInfo.state != STATE_SET)
     manuallyPlaced = false;
+
+  // The model only changes while the robot walks or the game state changes.
+  if(ownSideModel.stillInOwnSide == lastOwnSideModel.stillInOwnSide &&
+     ownSideModel.largestXPossible == lastOwnSideModel.largestXPossible &&
+     ownSideModel.returnFromGameControllerPenalty == lastOwnSideModel.returnFromGameControllerPenalty &&
+     ownSideModel.returnFromManualPenalty == lastOwnSideModel.returnFromManualPenalty)
+    keepVersion();
 }
 
 MAKE_MODULE(OwnSideModelProvider, Modeling)
@@ -19,7 +19,7 @@
 
 #include <algorithm>
 
-MAKE_MODULE(BallPerceptor, Perception)
+MAKE_CONCURRENT_MODULE(BallPerceptor, Perception)
 
 bool ballSpotComparator (const BallSpot& b1, const BallSpot& b2)
 {
@@ -45,6 +45,7 @@ void BallPerceptor::update(BallPercept& ballPercept)
   DECLARE_DEBUG_DRAWING("module:BallPerceptor:field", "drawingOnField");
   DECLARE_DEBUG_DRAWING("module:BallPerceptor:ballSpot", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:BallPerceptor:ballSpotScanLines", "drawingOnImage");
+  DECLARE_DEBUG_DRAWING("module:BallPerceptor:roi", "drawingOnImage");
   DECLARE_PLOT("module:BallPerceptor:angle");
   // first of all we think, that no ball was found...
   ballPercept.ballWasSeen = false;
@@ -71,8 +72,45 @@ bool BallPerceptor::fromBallSpots(BallPercept& ballPercept)
   std::vector<BallSpot> ballSposts = theBallSpots.ballSpots;
   std::sort(ballSposts.begin(), ballSposts.end(), ballSpotComparator);
 
+  // If the ball was seen recently, first search it where it is expected. The ball spots
+  // inside the region of interest are analyzed first, followed by the predicted center,
+  // because the ball spot scan might have missed a ball that is partially occluded or
+  // blurred. All other ball spots are only analyzed if the ball was not found there.
+  const bool tracking = useTracking && predictBallInImage();
+  if(tracking)
+  {
+    for(const BallSpot& ballSpot : ballSposts)
+      if(isInROI(ballSpot.position))
+      {
+        CROSS("module:BallPerceptor:ballSpot",
+              ballSpot.position.x, ballSpot.position.y,
+              1, 1, Drawings::ps_solid, ColorClasses::blue);
+
+        if(analyzeBallSpot(ballSpot, ballPercept))
+        {
+          CROSS("module:BallPerceptor:ballSpot",
+                ballSpot.position.x, ballSpot.position.y,
+                1, 1, Drawings::ps_solid, ColorClasses::green);
+          return true;
+        }
+      }
+
+    const BallSpot predictedSpot(predictedCenter.x, predictedCenter.y);
+    if(theColorReference.isOrange(&theImage[predictedCenter.y][predictedCenter.x]) &&
+       analyzeBallSpot(predictedSpot, ballPercept))
+    {
+      CROSS("module:BallPerceptor:roi",
+            predictedCenter.x, predictedCenter.y,
+            2, 1, Drawings::ps_solid, ColorClasses::green);
+      return true;
+    }
+  }
+
   for(const BallSpot& ballSpot : ballSposts)
   {
+    if(tracking && isInROI(ballSpot.position))
+      continue; // already analyzed
+
     CROSS("module:BallPerceptor:ballSpot",
           ballSpot.position.x, ballSpot.position.y,
           1, 1, Drawings::ps_solid, ColorClasses::blue);
@@ -89,6 +127,36 @@ bool BallPerceptor::fromBallSpots(BallPercept& ballPercept)
   return false;
 }
 
+bool BallPerceptor::predictBallInImage()
+{
+  if(!theBallModel.timeWhenLastSeen || theImage.timeStamp - theBallModel.timeWhenLastSeen > trackingTimeout)
+    return false;
+
+  // The ball model is from the previous frame, so the robot's motion since then is removed.
+  const Vector2<> ballOnField = theOdometer.odometryOffset.invert() * theBallModel.estimate.position;
+  const Vector3<> ballInWorld(ballOnField.x, ballOnField.y, theFieldDimensions.ballRadius);
+  Vector2<int> ballInImage;
+  if(!Geometry::calculatePointInImage(ballInWorld, theCameraMatrix, theCameraInfo, ballInImage))
+    return false;
+
+  const Vector2<> center = theImageCoordinateSystem.fromCorrectedApprox(ballInImage);
+  predictedCenter = Vector2<int>(int(center.x + 0.5f), int(center.y + 0.5f));
+  if(predictedCenter.x < left || predictedCenter.x > right || predictedCenter.y < horizon || predictedCenter.y > height)
+    return false;
+
+  const float distance = (ballInWorld - theCameraMatrix.translation).abs();
+  const float radius = Geometry::getSizeByDistance(theCameraInfo, theFieldDimensions.ballRadius, distance);
+  const int size = int(radius * roiRadiusScale + scaled(roiPixelBonus));
+  roiTopLeft = Vector2<int>(std::max(left, predictedCenter.x - size), std::max(horizon, predictedCenter.y - size));
+  roiBottomRight = Vector2<int>(std::min(right, predictedCenter.x + size), std::min(height, predictedCenter.y + size));
+
+  RECTANGLE("module:BallPerceptor:roi", roiTopLeft.x, roiTopLeft.y, roiBottomRight.x, roiBottomRight.y,
+            1, Drawings::ps_solid, ColorClasses::yellow);
+  CROSS("module:BallPerceptor:roi", predictedCenter.x, predictedCenter.y,
+        2, 1, Drawings::ps_solid, ColorClasses::yellow);
+  return true;
+}
+
 bool BallPerceptor::analyzeBallSpot(const BallSpot& ballSpot, BallPercept& ballPercept)
 {
   return ballPercept.ballWasSeen =
@@ -106,13 +174,14 @@ bool BallPerceptor::analyzeBallSpot(const BallSpot& ballSpot, BallPercept& ballP
 bool BallPerceptor::checkNoNoise(const BallSpot& ballSpot)
 {
   unsigned int skipped;
+  const unsigned maxSkipped = scaled(orangeSkipping);
   int lower, upper;
   int left, right;
 
   // find upper/lower => middle vertical
   lower = upper = ballSpot.position.y;
   skipped = 0;
-  while(lower <= height && skipped < orangeSkipping)
+  while(lower <= height && skipped < maxSkipped)
   {
     if(theColorReference.isOrange(&theImage[lower][ballSpot.position.x]))
       skipped = 0;
@@ -123,7 +192,7 @@ bool BallPerceptor::checkNoNoise(const BallSpot& ballSpot)
   lower -= skipped;
 
   skipped = 0;
-  while(upper >= horizon && skipped < orangeSkipping)
+  while(upper >= horizon && skipped < maxSkipped)
   {
     if(theColorReference.isOrange(&theImage[upper][ballSpot.position.x]))
       skipped = 0;
@@ -137,7 +206,7 @@ bool BallPerceptor::checkNoNoise(const BallSpot& ballSpot)
   int redCounter = 0;
   left = right = ballSpot.position.x;
   skipped = 0;
-  while(left >= this->left && skipped < orangeSkipping)
+  while(left >= this->left && skipped < maxSkipped)
   {
     if(theColorReference.isOrange(&theImage[ballSpot.position.y][left]))
       skipped = 0;
@@ -152,7 +221,7 @@ bool BallPerceptor::checkNoNoise(const BallSpot& ballSpot)
   }
   left += skipped + 1;
   skipped = 0;
-  while(right <= this->right && skipped < orangeSkipping)
+  while(right <= this->right && skipped < maxSkipped)
   {
     if(theColorReference.isOrange(&theImage[ballSpot.position.y][right]))
       skipped = 0;
@@ -180,8 +249,8 @@ bool BallPerceptor::checkNoNoise(const BallSpot& ballSpot)
   const unsigned int width  = right - left;
   const unsigned int height = lower - upper;
 
-  return width >= minBallSpotSize &&
-         height >= minBallSpotSize;
+  return width >= scaled(minBallSpotSize) &&
+         height >= scaled(minBallSpotSize);
 }
 
 bool BallPerceptor::checkBallSpot(const BallSpot& ballSpot)
@@ -212,7 +281,7 @@ bool BallPerceptor::checkBallSpot(const BallSpot& ballSpot)
 bool BallPerceptor::searchBallPoints(const BallSpot& ballSpot)
 {
   Vector2<int> start = ballSpot.position;
-  const float approxDiameter = approxRadius1 * clippingApproxRadiusScale + clippingApproxRadiusPixelBonus;
+  const float approxDiameter = approxRadius1 * clippingApproxRadiusScale + scaled(clippingApproxRadiusPixelBonus);
   int halfApproxRadius = int(approxRadius1 * 0.5f);
   COMPLEX_DRAWING("module:BallPerceptor:image", drawBall(start, approxDiameter, 0x6a););
   // try to improve the start point
@@ -381,7 +450,7 @@ bool BallPerceptor::searchBallPoints(const BallSpot& ballSpot)
     const Vector2<int>& step = ballPoint.step;
     Vector2<int> pos = ballPoint.point;
     int i = 0;
-    for(; i < (int) refineMaxPixelCount; ++i)
+    for(; i < (int) scaled(refineMaxPixelCount); ++i)
     {
       pos += step;
       if(pos.x < 0 || pos.x >= resolutionWidth ||
@@ -424,7 +493,7 @@ bool BallPerceptor::searchBallPoint(const Vector2<int>& start, Image::Pixel star
   ballPoint.atBorder = false;
   ballPoint.start = start;
   int maxColorDistance = scanMaxColorDistance;
-  unsigned int maxOvertime = scanPixelTolerance;
+  unsigned int maxOvertime = scaled(scanPixelTolerance);
   int resolutionWidth = theImage.width;
   int resolutionHeight = theImage.height;
   int stepAbs1024 = (step.x == 0 || step.y == 0) ? 1024 : 1448; // 1448 = sqrt(2) * 1024
@@ -634,13 +703,13 @@ bool BallPerceptor::checkBallInImage(BallPercept& ballPercept)
   }
 
   // check ball radius
-  if(radius > approxRadius1 * checkMaxRadiusDifference || radius + checkMinRadiusPixelBonus < approxRadius1 * checkMinRadiusDifference)
+  if(radius > approxRadius1 * checkMaxRadiusDifference || radius + scaled(checkMinRadiusPixelBonus) < approxRadius1 * checkMinRadiusDifference)
   {
     return false;
   }
 
   //
-  float noBallRadius = radius * checkOutlineRadiusScale + checkOutlineRadiusPixelBonus;
+  float noBallRadius = radius * checkOutlineRadiusScale + scaled(checkOutlineRadiusPixelBonus);
   CIRCLE("module:BallPerceptor:image", center.x, center.y, noBallRadius, 1, Drawings::ps_solid, ColorRGBA(0xff, 0xff, 0xff), Drawings::bs_null, ColorRGBA());
   Vector2<int> center32(int(center.x * 32.f), int(center.y * 32.f));
   int noBallRadius32 = int(noBallRadius * 32.f);
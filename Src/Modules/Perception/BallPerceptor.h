@@ -16,6 +16,7 @@
 #include "Representations/Perception/FieldBoundary.h"
 #include "Representations/Modeling/Odometer.h"
 #include "Representations/Perception/BallSpots.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 
 class BallSpot;
 class RobotPose;
@@ -28,6 +29,7 @@ MODULE(BallPerceptor)
   REQUIRES(CameraMatrix)
   REQUIRES(ImageCoordinateSystem)
   REQUIRES(CameraInfo)
+  REQUIRES(ProcessingResolution)
   REQUIRES(ColorReference)
   REQUIRES(Odometer)
   REQUIRES(FieldBoundary)
@@ -50,6 +52,10 @@ MODULE(BallPerceptor)
   DEFINES_PARAMETER(unsigned int, minBallSpotSize, 4)
   DEFINES_PARAMETER(float, percentRedNoise, 0.1f) // percent [0, 1]
   DEFINES_PARAMETER(bool, useFieldBoundary, true)
+  DEFINES_PARAMETER(bool, useTracking, true) /**< Search the ball around its predicted position first? */
+  DEFINES_PARAMETER(unsigned, trackingTimeout, 300) /**< Only track a ball seen within this time (in ms). */
+  DEFINES_PARAMETER(float, roiRadiusScale, 2.f) /**< The size of the region of interest relative to the predicted radius. */
+  DEFINES_PARAMETER(float, roiPixelBonus, 8.f) /**< Pixels added to each side of the region of interest. */
 END_MODULE
 
 class BallPerceptor : public BallPerceptorBase
@@ -70,10 +76,42 @@ private:
 
   float sqrMaxBallDistance; /**< The square of the maximal allowed ball distance. */
 
+  /**
+  * The method converts a parameter given in pixels at full resolution into the
+  * resolution of the current image.
+  * @param pixels The parameter.
+  * @return The parameter at the processing resolution.
+  */
+  template<typename T> T scaled(T pixels) const {return theProcessingResolution.scale(pixels, theCameraInfo.camera);}
+
   void update(BallPercept& ballPercept);
 
   bool fromBallSpots(BallPercept&);
 
+  /** ########## begin: tracking the ball seen in previous frames. ########## */
+  Vector2<int> predictedCenter; /**< The position of the ball in the image predicted from the ball model. */
+  Vector2<int> roiTopLeft; /**< The upper left corner of the region of interest around the predicted ball. */
+  Vector2<int> roiBottomRight; /**< The lower right corner of the region of interest around the predicted ball. */
+
+  /**
+  * The method predicts where the ball seen recently will appear in the current image
+  * and determines a region of interest around that position.
+  * @return Is the predicted ball inside the image, i.e. are the region of interest
+  *         and the predicted center valid?
+  */
+  bool predictBallInImage();
+
+  /**
+  * The method checks whether a point lies within the region of interest.
+  * @param p The point in image coordinates.
+  * @return Is it inside?
+  */
+  bool isInROI(const Vector2<int>& p) const
+  {
+    return p.x >= roiTopLeft.x && p.x <= roiBottomRight.x && p.y >= roiTopLeft.y && p.y <= roiBottomRight.y;
+  }
+  /** ########## end: tracking the ball seen in previous frames. ########## */
+
   /** ########## begin: analyzing chain for possible balls. ########## */
   /*limits of the image where a ball should be found*/
   static const int left = 2;
@@ -14,6 +14,15 @@ void BodyContourProvider::update(BodyContour& bodyContour)
 {
   DECLARE_DEBUG_DRAWING3D("module:BodyContourProvider:contour", "origin");
 
+  // The contour only changes if the robot moves its head or its limbs, so the one
+  // computed for the same camera before is reused while the joints are (almost) still.
+  Cache& cache = caches[theCameraInfo.camera];
+  if(isCacheValid(cache))
+  {
+    bodyContour = cache.bodyContour;
+    return;
+  }
+
   bodyContour.cameraResolution.x = theCameraInfo.width;
   bodyContour.cameraResolution.y = theCameraInfo.height;
   bodyContour.lines.clear();
@@ -31,6 +40,32 @@ void BodyContourProvider::update(BodyContour& bodyContour)
   add(theRobotModel.limbs[MassCalibration::thighRight], upperLeg2, -1, bodyContour);
   add(theRobotModel.limbs[MassCalibration::footLeft], foot, 1, bodyContour);
   add(theRobotModel.limbs[MassCalibration::footRight], foot, -1, bodyContour);
+  bodyContour.updateBottom();
+
+  cache.bodyContour = bodyContour;
+  for(int i = 0; i < JointData::numOfJoints; ++i)
+    cache.angles[i] = theFilteredJointData.angles[i];
+  cache.robotCameraMatrix = theRobotCameraMatrix;
+  cache.opticalCenter = theCameraInfo.opticalCenter;
+  cache.focalLength = theCameraInfo.focalLength;
+  cache.valid = true;
+}
+
+bool BodyContourProvider::isCacheValid(const Cache& cache) const
+{
+  if(!cache.valid ||
+     cache.bodyContour.cameraResolution.x != theCameraInfo.width ||
+     cache.bodyContour.cameraResolution.y != theCameraInfo.height ||
+     cache.opticalCenter != theCameraInfo.opticalCenter ||
+     cache.focalLength != theCameraInfo.focalLength)
+    return false;
+  for(int i = 0; i < JointData::numOfJoints; ++i)
+    if(std::abs(theFilteredJointData.angles[i] - cache.angles[i]) > maxJointAngleChange)
+      return false;
+
+  // The head joints are already checked, but the camera calibration might have changed.
+  return (theRobotCameraMatrix.translation - cache.robotCameraMatrix.translation).squareAbs() <= maxCameraTranslationChange * maxCameraTranslationChange &&
+         (cache.robotCameraMatrix.rotation.invert() * theRobotCameraMatrix.rotation).getAngleAxis().squareAbs() <= maxCameraRotationChange * maxCameraRotationChange;
 }
 
 void BodyContourProvider::add(const Pose3D& origin, const std::vector<Vector3<> >& c, float sign,
@@ -9,6 +9,7 @@
 
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/JointData.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
 #include "Representations/Sensing/RobotModel.h"
@@ -19,6 +20,7 @@ MODULE(BodyContourProvider)
   REQUIRES(ImageCoordinateSystem)
   REQUIRES(RobotCameraMatrix)
   REQUIRES(RobotModel)
+  REQUIRES(FilteredJointData)
   PROVIDES_WITH_MODIFY_AND_DRAW(BodyContour)
   LOADS_PARAMETER(std::vector<Vector3<> >, torso) /**< The contour of the torso. */
   LOADS_PARAMETER(std::vector<Vector3<> >, upperArm) /**< The contour of the left upper arm. */
@@ -26,6 +28,9 @@ MODULE(BodyContourProvider)
   LOADS_PARAMETER(std::vector<Vector3<> >, upperLeg1) /**< The contour of the left upper leg (part 1). */
   LOADS_PARAMETER(std::vector<Vector3<> >, upperLeg2) /**< The contour of the left upper leg (part 2). */
   LOADS_PARAMETER(std::vector<Vector3<> >, foot) /**< The contour of the left foot. */
+  DEFINES_PARAMETER(float, maxJointAngleChange, 0.005f) /**< The contour is only recomputed if a joint moved more than this (in radians). */
+  DEFINES_PARAMETER(float, maxCameraTranslationChange, 1.f) /**< The contour is only recomputed if the camera moved more than this relative to the robot (in mm). */
+  DEFINES_PARAMETER(float, maxCameraRotationChange, 0.005f) /**< The contour is only recomputed if the camera rotated more than this relative to the robot (in radians). */
 END_MODULE
 
 /**
@@ -38,6 +43,31 @@ class BodyContourProvider: public BodyContourProviderBase
 private:
   Pose3D robotCameraMatrixInverted; /**< The inverse of the current robotCameraMatrix. */
 
+  /** The contour last computed for a camera and the data it was computed from. */
+  class Cache
+  {
+  public:
+    BodyContour bodyContour; /**< The contour including the lowest valid y coordinate of each column. */
+    float angles[JointData::numOfJoints]; /**< The joint angles it was computed for. */
+    Pose3D robotCameraMatrix; /**< The robot camera matrix it was computed for. It also depends on the camera calibration. */
+    Vector2<> opticalCenter; /**< The optical center of the camera it was computed for. */
+    float focalLength; /**< The focal length of the camera it was computed for. */
+    bool valid; /**< Was it computed at all? */
+
+    Cache() : focalLength(0.f), valid(false) {}
+  };
+
+  Cache caches[CameraInfo::numOfCameras]; /**< The contours last computed for each camera. */
+
+  /**
+  * The method checks whether the contour cached for the current camera can be used,
+  * i.e. none of the joints moved significantly since it was computed and neither the
+  * camera calibration nor the camera intrinsics changed.
+  * @param cache The cache of the current camera.
+  * @return Can the contour be reused?
+  */
+  bool isCacheValid(const Cache& cache) const;
+
   void update(BodyContour& bodyContour);
 
   /**
@@ -9,7 +9,7 @@
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Debugging/DebugDrawings3D.h"
 
-MAKE_MODULE(CameraMatrixProvider, Perception);
+MAKE_PURE_MODULE(CameraMatrixProvider, Perception);
 
 void CameraMatrixProvider::update(CameraMatrix& cameraMatrix)
 {
@@ -50,21 +50,57 @@ bool ColorProvider::compareAndSet(ColorReference::HSVColorDefinition& toSet,
 
 void ColorProvider::update(ColorReference& colorReference)
 {
-  // calculate the colors and update the color table if necessary
-  if(setupColorTable                  |
-     calculateGreen(colorReference)   |
-     calculateWhite(colorReference)   |
-     calculateYellow(colorReference)  |
-     calculateOrange(colorReference)  |
-     calculateRed(colorReference)     |
-     calculateBlue(colorReference)    |
-     calculateBlack(colorReference))
+  MODIFY("module:ColorProvider:rebuildInBackground", rebuildInBackground);
+
+  // swap the color tables between frames when the worker thread has finished
+  if(rebuilding && !Thread<ColorProvider>::isRunning())
   {
-    colorReference.update();
-    setupColorTable = false;
+    Thread<ColorProvider>::stop();
+    rebuilding = false;
+    colorReference.swapColorTables();
     colorReference.changed = true;
   }
 
+  // the thresholds must not change while the worker thread uses them,
+  // so changed parameters are only detected after the current update was finished
+  if(!rebuilding)
+  {
+    // a new layout invalidates both color tables
+    if(calculateLayout(colorReference))
+      setupColorTable = true;
+
+    // calculate the colors and determine which parts of the color table must be updated
+    const unsigned char colors = (unsigned char) ((calculateGreen(colorReference) ? ColorReference::green : 0) |
+                                                  (calculateWhite(colorReference) ? ColorReference::white : 0) |
+                                                  (calculateYellow(colorReference) ? ColorReference::yellow : 0) |
+                                                  (calculateOrange(colorReference) ? ColorReference::orange : 0) |
+                                                  (calculateRed(colorReference) ? ColorReference::red : 0) |
+                                                  (calculateBlue(colorReference) ? ColorReference::blue : 0) |
+                                                  (calculateBlack(colorReference) ? ColorReference::black : 0));
+    if(setupColorTable)
+    {
+      // there is no valid color table yet, so there is nothing to wait for
+      colorReference.update();
+      setupColorTable = false;
+      colorReference.changed = true;
+    }
+    else if(colors)
+    {
+      if(rebuildInBackground)
+      {
+        rebuilt = &colorReference;
+        colorsToUpdate = colors;
+        rebuilding = true;
+        Thread<ColorProvider>::start(this, &ColorProvider::rebuild);
+      }
+      else
+      {
+        colorReference.update(colors);
+        colorReference.changed = true;
+      }
+    }
+  }
+
   // stream the ColorReference if necessary
   streamColorReference(colorReference);
 
@@ -75,6 +111,11 @@ void ColorProvider::update(ColorReference& colorReference)
   });
 }
 
+void ColorProvider::rebuild()
+{
+  rebuilt->updateInBackground(colorsToUpdate);
+}
+
 bool ColorProvider::calculateGreen(ColorReference& colorReference)
 {
   return compareAndSet(colorReference.thresholdGreen,
@@ -129,6 +170,17 @@ bool ColorProvider::calculateBlack(ColorReference& colorReference)
          compareAndSet(colorReference.thresholdBlack.third, maxYBlack);
 }
 
+bool ColorProvider::calculateLayout(ColorReference& colorReference)
+{
+  if(colorReference.layout != layout || colorReference.yBits != yBits ||
+     colorReference.cbBits != cbBits || colorReference.crBits != crBits)
+  {
+    colorReference.setLayout(layout, yBits, cbBits, crBits);
+    return true;
+  }
+  return false;
+}
+
 void ColorProvider::streamColorReference(ColorReference& colorReference)
 {
   if(colorReference.changed)
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Tools/Module/Module.h"
+#include "Platform/Thread.h"
 #include "Tools/Debugging/DebugImages.h"
 #include "Representations/Perception/ColorReference.h"
 
@@ -64,19 +65,39 @@ MODULE(ColorProvider)
   LOADS_PARAMETER(int, cbBlack)
   LOADS_PARAMETER(int, crBlack)
   LOADS_PARAMETER(int, maxYBlack)
+
+  /** layout and resolution of the color table */
+  LOADS_PARAMETER(ColorReference, Layout, layout)
+  LOADS_PARAMETER(int, yBits)
+  LOADS_PARAMETER(int, cbBits)
+  LOADS_PARAMETER(int, crBits)
 END_MODULE
 
 /**
  * Classify colors by using hsv.
+ * After the initial setup, changes of thresholds are applied in the background:
+ * only the color classes affected are recomputed by a worker thread in the color
+ * table of the ColorReference that is not in use. The two color tables are swapped
+ * at the beginning of the first frame after the worker has finished.
  */
-class ColorProvider : public ColorProviderBase
+class ColorProvider : public ColorProviderBase, private Thread<ColorProvider>
 {
 public:
   bool setupColorTable;
 
-  ColorProvider() : setupColorTable(true) {}
+  ColorProvider() : setupColorTable(true), rebuildInBackground(true), rebuilding(false), colorsToUpdate(0), rebuilt(0) {}
+
+  ~ColorProvider() {Thread<ColorProvider>::stop();}
 
 private:
+  bool rebuildInBackground; /**< Update the color table in a worker thread instead of during the frame. */
+  bool rebuilding; /**< Is the worker thread updating the color table not in use? */
+  unsigned char colorsToUpdate; /**< The color classes the worker thread recomputes (as ColorReference::MultiColor::colors). */
+  ColorReference* rebuilt; /**< The ColorReference whose color table not in use is updated by the worker thread. */
+
+  /** The main function of the worker thread. Updates the color table not in use. */
+  void rebuild();
+
   bool compareAndSet(float& toSet, const float toCompare);
 
   bool compareAndSet(int& toSet, const int toCompare);
@@ -113,6 +134,9 @@ private:
 
   /** calculates the expected color black. */
   bool calculateBlack(ColorReference& colorReference);
+
+  /** sets the layout and the resolution of the color table. */
+  bool calculateLayout(ColorReference& colorReference);
   
   /* Streams the ColorReference if necessary. */
   void streamColorReference(ColorReference& colorReference);
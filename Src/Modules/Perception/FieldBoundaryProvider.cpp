@@ -20,7 +20,7 @@ void FieldBoundaryProvider::update(FieldBoundary& fieldBoundary)
   DECLARE_DEBUG_DRAWING("module:FieldBoundary:LowerCamSpots", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:FieldBoundary:LowerCamSpotsInterpol", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:FieldBoundary:GreaterPenaltyPoint", "drawingOnImage");
-  fieldBoundary.scanlineDistance = scanlienDistance;
+  fieldBoundary.scanlineDistance = theProcessingResolution.scale(scanlienDistance, theCameraInfo.camera);
 
   int horizon = static_cast<int>(theImageCoordinateSystem.origin.y);
 
@@ -43,14 +43,14 @@ void FieldBoundaryProvider::update(FieldBoundary& fieldBoundary)
     }
     else
     {
-      lowerCamConvexHullOnField.clear();
+      fieldBoundary.lowerCamConvexHullOnField.clear();
     }
 
     horizon = std::max(0, horizon);
 
     if(theCameraInfo.camera == CameraInfo::Camera::upper)
     {
-      handleLowerCamSpots();
+      handleLowerCamSpots(fieldBoundary.lowerCamConvexHullOnField);
     }
     findBundarySpots(fieldBoundary, horizon);
     bool valid = cleanupBoundarySpots(fieldBoundary.boundarySpots);;
@@ -65,7 +65,7 @@ void FieldBoundaryProvider::update(FieldBoundary& fieldBoundary)
   else
   {
     fieldBoundary.boundaryOnField.clear();
-    lowerCamConvexHullOnField.clear();
+    fieldBoundary.lowerCamConvexHullOnField.clear();
 
     fieldBoundary.convexBoundary.push_back(Vector2<int>(0, theImage.height));
     fieldBoundary.convexBoundary.push_back(Vector2<int>(theImage.width - 1, theImage.height));
@@ -100,7 +100,7 @@ void FieldBoundaryProvider::update(FieldBoundary& fieldBoundary)
     {
       Vector2<float> pField;
       Geometry::calculatePointOnField(p.x, p.y, theCameraMatrix, theCameraInfo, pField);
-      lowerCamConvexHullOnField.push_back(pField);
+      fieldBoundary.lowerCamConvexHullOnField.push_back(pField);
     }
 
     // Update fieldboundary from last upper image so it is shown correctly on the lower image.
@@ -137,7 +137,7 @@ void FieldBoundaryProvider::update(FieldBoundary& fieldBoundary)
   fieldBoundary.highestPoint = Vector2<int>(theImage.width / 2, heighest->y);
 }
 
-void FieldBoundaryProvider::handleLowerCamSpots()
+void FieldBoundaryProvider::handleLowerCamSpots(const InField& lowerCamConvexHullOnField)
 {
   InImage tmpLowerCamSpotsInImage;
 
@@ -185,10 +185,22 @@ void FieldBoundaryProvider::findBundarySpots(FieldBoundary& fieldBoundary, int h
   int width = theImage.width;
   int height = theImage.height;
 
+  // Use the vertical scanlines of the scan grid that are closest to the scanline distance.
+  const int scanlineDistance = theProcessingResolution.scale(scanlienDistance, theCameraInfo.camera);
+  int xStart = scanlineDistance / 2;
+  int xStep = scanlineDistance;
+  const int gridStep = std::max(1, (scanlineDistance + theScanGrid.lineDistance / 2) / theScanGrid.lineDistance);
+  if(static_cast<int>(theScanGrid.verticalLines.size()) > gridStep / 2)
+  {
+    xStart = theScanGrid.verticalLines[gridStep / 2].position;
+    xStep = gridStep * theScanGrid.lineDistance;
+  }
+  fieldBoundary.scanlineDistance = xStep;
+
   vector<BoundaryScanline> scanlines;
   if(theCameraInfo.camera == CameraInfo::Camera::upper && lowerCamSpotsInImage.size() > 1)
   {
-    for(int x = scanlienDistance / 2; x < width; x += scanlienDistance)
+    for(int x = xStart; x < width; x += xStep)
     {
       int y = clipToBoundary(lowerCamSpotsInImage, x);
       Vector2<int> p(x, y);
@@ -196,17 +208,17 @@ void FieldBoundaryProvider::findBundarySpots(FieldBoundary& fieldBoundary, int h
       DOT("module:FieldBoundary:LowerCamSpotsInterpol", p.x, p.y, ColorClasses::black, ColorClasses::black);
       int yStart = y;
       int score = (y > height) ? (height - y) / nearVertJump : 0;
-      BoundaryScanline line = {x, yStart, yStart, score, 0, &theImage[height - 1][x]};
+      BoundaryScanline line = {x, yStart, yStart, score, 0, &theImage[height - 1][x], theScanGrid.getVerticalLine(x), 0};
       scanlines.push_back(line);
     }
   }
   else
   {
-    for(int x = scanlienDistance / 2; x < width; x += scanlienDistance)
+    for(int x = xStart; x < width; x += xStep)
     {
       int yStart = height;
       theBodyContour.clipBottom(x, yStart, height);
-      BoundaryScanline line = {x, yStart, yStart, 0, 0, &theImage[height - 1][x]};
+      BoundaryScanline line = {x, yStart, yStart, 0, 0, &theImage[height - 1][x], theScanGrid.getVerticalLine(x), 0};
       scanlines.push_back(line);
     }
   }
@@ -228,39 +240,23 @@ void FieldBoundaryProvider::findBundarySpots(FieldBoundary& fieldBoundary, int h
   }
   CROSS("module:FieldBoundary:GreaterPenaltyPoint", width / 2 , yBound, 5, 5, Drawings::ps_solid, ColorClasses::black);
 
-  int vertJump = nearVertJump;
-  for(int y = height - 1; y >= horizon; y -= vertJump)
+  // The scanlines are independent of each other, so the worker thread can scan the
+  // right half of them in the upper image, which is the larger one to be scanned.
+  BoundaryScanline* begin = scanlines.data();
+  BoundaryScanline* end = begin + scanlines.size();
+  if(parallel && theCameraInfo.camera == CameraInfo::Camera::upper && scanlines.size() > 1)
   {
-    int penalty = 1;
-    int reward = 1;
-    if(y < yBound)
-    {
-      vertJump = farVertJump;
-      penalty = nonGreenPenalty;
-    }
-
-    for(BoundaryScanline& line : scanlines)
+    BoundaryScanline* split = begin + scanlines.size() / 2;
+    worker.start([this, split, end, horizon, yBound]
     {
-      if(y < line.yStart)
-      {
-        if(theColorReference.isGreen(line.pImg))
-        {
-          line.score += reward;
-        }
-        else
-        {
-          line.score -= penalty;
-        }
-
-        if(line.maxScore <= line.score)
-        {
-          line.maxScore = line.score;
-          line.yMax = y;
-        }
-      }
-      line.pImg -= theImage.widthStep * vertJump;
-    }
+      scanBoundary(split, end, horizon, yBound);
+    });
+    scanBoundary(begin, split, horizon, yBound);
+    worker.wait();
   }
+  else
+    scanBoundary(begin, end, horizon, yBound);
+
   if(theCameraInfo.camera == CameraInfo::Camera::lower)
   {
     for(BoundaryScanline& line : scanlines)
@@ -295,6 +291,58 @@ void FieldBoundaryProvider::findBundarySpots(FieldBoundary& fieldBoundary, int h
   }
 }
 
+void FieldBoundaryProvider::scanBoundary(BoundaryScanline* begin, BoundaryScanline* end, int horizon, int yBound) const
+{
+  int vertJump = nearVertJump;
+  for(int y = theImage.height - 1; y >= horizon; y -= vertJump)
+  {
+    int penalty = 1;
+    int reward = 1;
+    if(y < yBound)
+    {
+      vertJump = farVertJump;
+      penalty = nonGreenPenalty;
+    }
+
+    for(BoundaryScanline* line = begin; line < end; ++line)
+    {
+      if(y < line->yStart)
+      {
+        if(isGreen(*line, y))
+        {
+          line->score += reward;
+        }
+        else
+        {
+          line->score -= penalty;
+        }
+
+        if(line->maxScore <= line->score)
+        {
+          line->maxScore = line->score;
+          line->yMax = y;
+        }
+      }
+      line->pImg -= theImage.widthStep * vertJump;
+    }
+  }
+}
+
+bool FieldBoundaryProvider::isGreen(BoundaryScanline& line, int y) const
+{
+  if(line.gridLine && line.gridLine->isInside(y))
+  {
+    if(!line.run)
+      line.run = theScanGrid.getRun(*line.gridLine, y);
+    else
+      while(line.run->from > y)
+        --line.run;
+    return line.run->getColorClasses().isGreen();
+  }
+  else
+    return theColorReference.isGreen(line.pImg);
+}
+
 bool FieldBoundaryProvider::cleanupBoundarySpots(InImage& boundarySpots) const
 {
   ASSERT(nearVertJump >= farVertJump);
@@ -334,90 +382,123 @@ bool FieldBoundaryProvider::cleanupBoundarySpots(InImage& boundarySpots) const
   }
 }
 
+/** Orders points by their x coordinates. */
+static bool compareX(const Vector2<int>& a, const Vector2<int>& b)
+{
+  return a.x < b.x;
+}
+
 vector<FieldBoundaryProvider::InImage> FieldBoundaryProvider::calcBoundaryCandidates(InImage boundarySpots) const
 {
   const int maxIter = 20;
   vector<InImage> boundaryCandidates;
+  if(boundarySpots.size() < 2)
+    return boundaryCandidates;
+  boundaryCandidates.reserve(maxIter);
+  boundaryCandidates.push_back(getUpperConvexHull(boundarySpots));
 
-  for(int i = 0; i < maxIter && boundarySpots.size() >= 2; ++i)
+  for(;;)
   {
-    InImage boundaryCandidate = getUpperConvexHull(boundarySpots);
-    boundaryCandidates.push_back(boundaryCandidate);
-    if(boundaryCandidate.size() >= 2)
-    {
-      int maxDist = 0;
-      Vector2<int>* val;
+    const InImage& boundaryCandidate = boundaryCandidates.back();
+    ASSERT(boundaryCandidate.size() >= 2);
 
-      //Length of first Line segment
-      int firstDist = std::abs((boundaryCandidate.begin() + 1)->y - boundaryCandidate.front().y);
-      //(*(boundaryCandidate.begin() + 1) - boundaryCandidate.front()).abs();
-      //Length of last line segment
-      int lastDist = std::abs((boundaryCandidate.end() - 2)->y - boundaryCandidate.back().y);
-      //(*(boundaryCandidate.end() - 2) - boundaryCandidate.back()).abs();
+    //Length of first Line segment
+    int firstDist = std::abs((boundaryCandidate.begin() + 1)->y - boundaryCandidate.front().y);
+    //Length of last line segment
+    int lastDist = std::abs((boundaryCandidate.end() - 2)->y - boundaryCandidate.back().y);
 
-      if(firstDist >= lastDist)
-      {
-        maxDist = firstDist;
-        val = &boundaryCandidate.front();
-      }
-      else
-      {
-        maxDist = lastDist;
-        val = &boundaryCandidate.back();
-      }
+    int maxDist;
+    InImage::const_iterator val;
+    if(firstDist >= lastDist)
+    {
+      maxDist = firstDist;
+      val = boundaryCandidate.begin();
+    }
+    else
+    {
+      maxDist = lastDist;
+      val = boundaryCandidate.end() - 1;
+    }
 
-      // erase the point with the maximum x-distande to its neighbous
-      for(auto iter = boundaryCandidate.begin(); iter + 2 < boundaryCandidate.end(); ++iter)
-      {
-        int tmpDist = std::abs((iter + 1)->y - iter->y) + std::abs((iter + 2)->y - (iter + 1)->y);
-        //(*(iter + 2) - *iter).abs();
-        if(tmpDist > maxDist)
-        {
-          maxDist = tmpDist;
-          val = &*(iter + 1);
-        }
-      }
-      for(auto iter = boundarySpots.begin(); iter < boundarySpots.end(); iter++)
+    // erase the point with the maximum x-distande to its neighbous
+    for(auto iter = boundaryCandidate.begin(); iter + 2 < boundaryCandidate.end(); ++iter)
+    {
+      int tmpDist = std::abs((iter + 1)->y - iter->y) + std::abs((iter + 2)->y - (iter + 1)->y);
+      if(tmpDist > maxDist)
       {
-        if(*iter == *val)
-        {
-          boundarySpots.erase(iter);
-          break;
-        }
+        maxDist = tmpDist;
+        val = iter + 1;
       }
     }
+
+    // The boundary spots are sorted by their x coordinates, which are unique.
+    const InImage::iterator spot = std::lower_bound(boundarySpots.begin(), boundarySpots.end(), *val, compareX);
+    ASSERT(spot != boundarySpots.end() && *spot == *val);
+    const InImage::iterator next = boundarySpots.erase(spot);
+
+    if(static_cast<int>(boundaryCandidates.size()) == maxIter || boundarySpots.size() < 2)
+      break;
+
+    // Removing an end point changes the whole hull. Removing another point only
+    // changes the hull between its neighbors, which are boundary spots as well.
+    InImage hull;
+    if(val == boundaryCandidate.begin() || val == boundaryCandidate.end() - 1)
+      getUpperConvexHull(boundarySpots.begin(), boundarySpots.end(), hull);
     else
-      ASSERT(false);
+    {
+      const InImage::const_iterator left = std::lower_bound(boundarySpots.begin(), next, *(val - 1), compareX);
+      const InImage::const_iterator right = std::lower_bound(next, boundarySpots.end(), *(val + 1), compareX);
+      hull.reserve(boundaryCandidate.size() + (right - left));
+      hull.insert(hull.end(), boundaryCandidate.begin(), val - 1);
+      getUpperConvexHull(left, right + 1, hull);
+      hull.insert(hull.end(), val + 2, boundaryCandidate.end());
+    }
+    boundaryCandidates.push_back(hull);
   }
   return boundaryCandidates;
 }
 
 void FieldBoundaryProvider::findBestBoundary(const vector<InImage>& boundaryCandidates,
-    const InImage& boundarySpots, InImage& boundary) const
+    const InImage& boundarySpots, InImage& boundary)
 {
-  int spotsOnLine;
-  int spotsNearLine;
-  int score;
-  int y;
+  const int numOfSpots = static_cast<int>(boundarySpots.size());
+  spotY.resize(numOfSpots);
   int maxScore = 0;
   const InImage* tmpBoundary =  &boundaryCandidates.front();
 
   for(const InImage& boundarycandidate : boundaryCandidates)
   {
-    spotsOnLine = 0;
-    spotsNearLine = 0;
-    for(const Vector2<int>& point : boundarySpots)
+    // Determine the y coordinates of the candidate at all spots. Same results as
+    // clipToBoundary, but both lists are traversed only once.
+    const InImage::const_iterator last = boundarycandidate.end() - 1;
+    InImage::const_iterator right = boundarycandidate.begin();
+    for(int i = 0; i < numOfSpots; ++i)
     {
-      y = clipToBoundary(boundarycandidate, point.x);
-      if(point.y > y && point.y - y < lowerBound)
-        ++spotsNearLine;
-      else if(point.y < y && y - point.y < upperBound)
-        ++spotsNearLine;
-
-      if(point.y == y)
-        ++spotsOnLine;
+      const int x = boundarySpots[i].x;
+      while(right < last && right->x < x)
+        ++right;
+      if(right->x == x)
+        spotY[i] = right->y;
+      else if(right == boundarycandidate.begin())
+        spotY[i] = interpolate(*right, *(right + 1), x); // left of the candidate
+      else
+        spotY[i] = interpolate(*(right - 1), *right, x); // inside or right of the candidate
+    }
+
+    // Each spot scores at most one point, so stop as soon as the remaining spots
+    // cannot lead to a higher score than the best one. Blocks of spots are scored
+    // without branches.
+    const int blockSize = 16;
+    int score = 0;
+    for(int i = 0; i < numOfSpots && score + numOfSpots - i > maxScore; i += blockSize)
+    {
+      const int end = std::min(i + blockSize, numOfSpots);
+      for(int j = i; j < end; ++j)
+      {
+        const int d = boundarySpots[j].y - spotY[j];
+        score += (d == 0) | ((d > 0) & (d < lowerBound)) | ((d < 0) & (-d < upperBound));
+      }
     }
-    score = spotsOnLine + spotsNearLine;
     if(maxScore < score)
     {
       maxScore = score;
@@ -428,26 +509,26 @@ void FieldBoundaryProvider::findBestBoundary(const vector<InImage>& boundaryCand
   boundary = *tmpBoundary;
 }
 
-inline bool FieldBoundaryProvider::isLeftOf(Vector2<int>& a, Vector2<int>& b, Vector2<int>& c) const
+inline bool FieldBoundaryProvider::isLeftOf(const Vector2<int>& a, const Vector2<int>& b, const Vector2<int>& c)
 {
   return ((b.x - a.x) * (-c.y + a.y) - (c.x - a.x) * (-b.y + a.y) > 0);
 }
 
-FieldBoundaryProvider::InImage FieldBoundaryProvider::getUpperConvexHull(InImage& boundary) const
+void FieldBoundaryProvider::getUpperConvexHull(InImage::const_iterator begin, InImage::const_iterator end, InImage& hull)
 {
-  ASSERT(boundary.size() > 1);
+  ASSERT(end - begin > 1);
 
   //Andrew's Monotone Chain Algorithm to compute the upper hull
-  InImage hull;
-  const auto pmin = boundary.begin();
-  const auto pmax = boundary.end() - 1;
+  const size_t first = hull.size();
+  const auto pmin = begin;
+  const auto pmax = end - 1;
   hull.push_back(*pmin);
   for(auto pi = pmin + 1; pi != pmax + 1; pi++)
   {
     if(!isLeftOf((*pmin), (*pmax), (*pi)) && pi != pmax)
       continue;
 
-    while(hull.size() > 1)
+    while(hull.size() > first + 1)
     {
       const auto p1 = hull.end() - 1, p2 = hull.end() - 2;
       if(isLeftOf((*p1), (*p2), (*pi)))
@@ -456,6 +537,12 @@ FieldBoundaryProvider::InImage FieldBoundaryProvider::getUpperConvexHull(InImage
     }
     hull.push_back(*pi);
   }
+}
+
+FieldBoundaryProvider::InImage FieldBoundaryProvider::getUpperConvexHull(const InImage& boundary)
+{
+  InImage hull;
+  getUpperConvexHull(boundary.begin(), boundary.end(), hull);
   return hull;
 }
 
@@ -483,7 +570,5 @@ int FieldBoundaryProvider::clipToBoundary(const InImage& boundary, int x) const
     }
   }
 
-  double m = 1.0 * (right->y - left->y) / (right->x - left->x);
-
-  return static_cast<int>((x * m) + right->y - (right->x * m));
+  return interpolate(*left, *right, x);
 }
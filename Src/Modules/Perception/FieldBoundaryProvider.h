@@ -6,12 +6,15 @@
 
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Perception/BodyContour.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/ColorReference.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
 #include "Representations/Perception/FieldBoundary.h"
+#include "Representations/Perception/ScanGrid.h"
 #include "Representations/Modeling/Odometer.h"
+#include "Tools/Worker.h"
 
 MODULE(FieldBoundaryProvider)
   REQUIRES(BodyContour)
@@ -21,8 +24,11 @@ MODULE(FieldBoundaryProvider)
   REQUIRES(Image)
   REQUIRES(ImageCoordinateSystem)
   REQUIRES(Odometer)
+  REQUIRES(ProcessingResolution)
+  REQUIRES(ScanGrid)
+  USES(FieldBoundary) // the boundary of one camera is continued in the image of the other one
   PROVIDES_WITH_DRAW(FieldBoundary)
-  DEFINES_PARAMETER(int, scanlienDistance, 8)
+  DEFINES_PARAMETER(int, scanlienDistance, 8) /**< The distance between the scanlines in pixels at full resolution. */
   DEFINES_PARAMETER(int, upperBound, 2)
   DEFINES_PARAMETER(int, lowerBound, 5)
   DEFINES_PARAMETER(int, nearVertJump, 4)
@@ -30,6 +36,7 @@ MODULE(FieldBoundaryProvider)
   DEFINES_PARAMETER(int, nonGreenPenalty, 2)
   DEFINES_PARAMETER(int, nonGreenPenaltyDistance, 3500)
   DEFINES_PARAMETER(int, minGreenCount, 5)
+  DEFINES_PARAMETER(bool, parallel, true) /**< Scan the right half of the upper image in a second thread. */
 END_MODULE
 
 /**
@@ -46,27 +53,85 @@ private:
     int score;
     int maxScore;
     const Image::Pixel* pImg;
+    const ScanGrid::Line* gridLine; ///< The scan grid line at x or 0 if there is none.
+    const ScanGrid::Run* run; ///< The run of gridLine that contained the last pixel checked.
   };
 
   typedef FieldBoundary::InImage InImage;
   typedef FieldBoundary::InField InField;
 
-  InField lowerCamConvexHullOnField;
   InImage lowerCamSpotsInImage;
   InImage lowerCamSpostInterpol;
 
+  Worker worker; /**< The thread that scans the right half of the scanlines in the upper image. */
+  std::vector<int> spotY; /**< The y coordinates of a boundary candidate at the x coordinates of all boundary spots. */
+
   void update(FieldBoundary& fieldBoundary);
 
-  void handleLowerCamSpots();
+  void handleLowerCamSpots(const InField& lowerCamConvexHullOnField);
   void findBundarySpots(FieldBoundary& fieldBoundary, int horizon);
 
+  /**
+   * Scans a range of scanlines upwards and determines the y coordinate of the maximum
+   * green score of each one. Does not access anything through class Global, so that it
+   * can be run by the worker thread.
+   * @param begin The first scanline.
+   * @param end The end of the range of scanlines.
+   * @param horizon The scan ends at the horizon.
+   * @param yBound Above this y coordinate, the far jump and penalty are used.
+   */
+  void scanBoundary(BoundaryScanline* begin, BoundaryScanline* end, int horizon, int yBound) const;
+
+  /**
+   * Checks whether the pixel at y on a scanline is green. The scan grid is used if it
+   * contains the pixel, otherwise line.pImg is classified. Since the scanlines are
+   * scanned upwards, the run cursor only moves up.
+   */
+  inline bool isGreen(BoundaryScanline& line, int y) const;
+
   bool cleanupBoundarySpots(InImage& boundarySpots) const;
+
+  /**
+   * Determines up to 20 boundary candidates. The first one is the upper convex hull of the
+   * boundary spots. Each following one is the hull after removing the point of the previous
+   * one that deviates most from its neighbors. Since removing a point only changes the hull
+   * between its neighbors, only that part is recomputed.
+   */
   std::vector<InImage> calcBoundaryCandidates(InImage boundarySpots) const;
+
+  /**
+   * Selects the candidate that most boundary spots are on or close to. The y coordinates
+   * of a candidate at all spots are determined in a single pass, because both are sorted
+   * by their x coordinates. Candidates are abandoned as soon as they cannot beat the best
+   * score anymore.
+   */
   void findBestBoundary(const std::vector<InImage>& boundaryCandidates,
-                        const InImage& boundarySpots, InImage& boundary) const;
+                        const InImage& boundarySpots, InImage& boundary);
+
+  static inline bool isLeftOf(const Vector2<int>& a, const Vector2<int>& b, const Vector2<int>& c);
 
-  inline bool isLeftOf(Vector2<int>& a, Vector2<int>& b, Vector2<int>& c) const;
-  InImage getUpperConvexHull(InImage& boundary) const;
+  /**
+   * Computes the upper convex hull of a range of points sorted by their x coordinates
+   * using Andrew's Monotone Chain Algorithm.
+   * @param begin The first point. It is always part of the hull.
+   * @param end The end of the range. The last point in the range is always part of the hull.
+   * @param hull The hull is appended to this list.
+   */
+  static void getUpperConvexHull(InImage::const_iterator begin, InImage::const_iterator end, InImage& hull);
+  static InImage getUpperConvexHull(const InImage& boundary);
 
   int clipToBoundary(const InImage& boundary, int x) const;
+
+  /**
+   * Determines the y coordinate of the line through two points at a certain x coordinate.
+   * @param left The left point.
+   * @param right The right point.
+   * @param x The x coordinate.
+   * @return The y coordinate.
+   */
+  static int interpolate(const Vector2<int>& left, const Vector2<int>& right, int x)
+  {
+    double m = 1.0 * (right.y - left.y) / (right.x - left.x);
+    return static_cast<int>((x * m) + right.y - (right.x * m));
+  }
 };
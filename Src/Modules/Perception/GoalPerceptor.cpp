@@ -39,6 +39,13 @@ void GoalPerceptor::update(GoalPercept& percept)
 
 void GoalPerceptor::findSpots(const int& height)
 {
+  if(!theScanGrid.horizontalLines.empty() && theScanGrid.horizontalLines.front().position == height)
+  {
+    findSpots(theScanGrid.horizontalLines.front());
+    return;
+  }
+
+  const int maxSkipped = theProcessingResolution.scale(yellowSkipping, theCameraInfo.camera);
   int start;
   int sum;
   int skipped;
@@ -50,7 +57,7 @@ void GoalPerceptor::findSpots(const int& height)
       start = i;
       sum = 0;
       skipped = 0;
-      while (i < theImage.width && skipped < yellowSkipping)
+      while (i < theImage.width && skipped < maxSkipped)
       {
         if (isYellow(i, height))
         {
@@ -65,13 +72,38 @@ void GoalPerceptor::findSpots(const int& height)
       }
 
       if(sum > 0) // do not allow posts with width = 0
+        addSpot(start, i-skipped, height);
+    }
+  }
+}
+
+void GoalPerceptor::findSpots(const ScanGrid::Line& line)
+{
+  // yellow runs that are less than yellowSkipping pixels apart form a single spot
+  const int maxSkipped = theProcessingResolution.scale(yellowSkipping, theCameraInfo.camera);
+  int start = -1;
+  int end = 0;
+  for(const ScanGrid::Run* run = theScanGrid.begin(line); run != theScanGrid.end(line); ++run)
+    if(run->getColorClasses().isYellow())
+    {
+      if(start >= 0 && run->from - end >= maxSkipped)
       {
-        spots.push_back(Spot(start, i-skipped, height));
-        CROSS("module:GoalPerceptor:Spots", start, height, 2, 2, Drawings::ps_solid, ColorClasses::green);
-        CROSS("module:GoalPerceptor:Spots", i-skipped, height, 2, 2, Drawings::ps_solid, ColorClasses::blue);
+        addSpot(start, end, line.position);
+        start = -1;
       }
+      if(start < 0)
+        start = run->from;
+      end = run->to;
     }
-  }
+  if(start >= 0)
+    addSpot(start, end, line.position);
+}
+
+void GoalPerceptor::addSpot(int start, int end, int height)
+{
+  spots.push_back(Spot(start, end, height));
+  CROSS("module:GoalPerceptor:Spots", start, height, 2, 2, Drawings::ps_solid, ColorClasses::green);
+  CROSS("module:GoalPerceptor:Spots", end, height, 2, 2, Drawings::ps_solid, ColorClasses::blue);
 }
 
 void GoalPerceptor::verticalColorScanDown()
@@ -300,8 +332,7 @@ void GoalPerceptor::calculatePosition(const int& height)
     }
     else
     {
-      Vector2<> pCorrected = theImageCoordinateSystem.toCorrected(i->base);
-      Geometry::calculatePointOnField((int)pCorrected.x, (int)pCorrected.y, theCameraMatrix, theCameraInfo, i->position);
+      theProjectionGrid.getPointOnField(i->base, i->position);
     }
   }
 }
@@ -474,4 +505,4 @@ inline bool GoalPerceptor::isYellow(const int& x, const int& y)
   return theColorReference.isYellow(&theImage[y][x]);
 }
 
-MAKE_MODULE(GoalPerceptor, Perception)
\ No newline at end of file
+MAKE_CONCURRENT_MODULE(GoalPerceptor, Perception)
\ No newline at end of file
@@ -10,29 +10,35 @@
 #include "Tools/Module/Module.h"
 #include "Representations/Perception/GoalPercept.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
+#include "Representations/Perception/ProjectionGrid.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/FieldBoundary.h"
 #include "Representations/Configuration/FieldDimensions.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Modeling/Odometer.h"
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Representations/Perception/ColorReference.h"
+#include "Representations/Perception/ScanGrid.h"
 
 MODULE(GoalPerceptor)
   REQUIRES(CameraMatrix)
   REQUIRES(ImageCoordinateSystem)
+  REQUIRES(ProjectionGrid)
   REQUIRES(CameraInfo)
+  REQUIRES(ProcessingResolution)
   REQUIRES(Image)
   REQUIRES(FieldDimensions)
   REQUIRES(FrameInfo)
   REQUIRES(ColorReference)
   REQUIRES(FieldBoundary)
   REQUIRES(Odometer)
+  REQUIRES(ScanGrid)
   PROVIDES_WITH_MODIFY_AND_DRAW(GoalPercept)
   LOADS_PARAMETER(int, quality)
-  LOADS_PARAMETER(int, yellowSkipping)
+  LOADS_PARAMETER(int, yellowSkipping) /**< The number of non-yellow pixels a goal spot may contain (at full resolution) */
 END_MODULE
 
 /**
@@ -71,6 +77,11 @@ private:
 
   void findSpots(const int& height);
 
+  /** Finds the spots on the uppermost horizontal line of the scan grid, which is at the given height. */
+  void findSpots(const ScanGrid::Line& line);
+
+  void addSpot(int start, int end, int height);
+
   void verticalColorScanDown();
 
   void verticalColorScanUp();
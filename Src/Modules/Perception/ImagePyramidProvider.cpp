@@ -0,0 +1,53 @@
+/**
+* @file ImagePyramidProvider.cpp
+* This file implements a module that builds lower resolution versions of the camera image
+* once per frame.
+*/
+
+#include "ImagePyramidProvider.h"
+#include <emmintrin.h>
+
+void ImagePyramidProvider::update(ImagePyramid& imagePyramid)
+{
+  shrink(theImage[0], theImage.widthStep, theImage.width, theImage.height, imagePyramid.levels[0]);
+  for(int i = 1; i < ImagePyramid::numOfLevels; ++i)
+  {
+    const ImagePyramid::Level& src = imagePyramid.levels[i - 1];
+    shrink(src[0], src.width, src.width, src.height, imagePyramid.levels[i]);
+  }
+  imagePyramid.timeStamp = theImage.timeStamp;
+}
+
+void ImagePyramidProvider::shrink(const Image::Pixel* src, int srcStep, int width, int height, ImagePyramid::Level& dest)
+{
+  dest.setResolution(width / 2, height / 2);
+  const int width4 = dest.width & ~3;
+  for(int y = 0; y < dest.height; ++y)
+  {
+    const Image::Pixel* row0 = src + 2 * y * srcStep;
+    const Image::Pixel* row1 = row0 + srcStep;
+    Image::Pixel* d = dest[y];
+    int x = 0;
+
+    // Four pixels at a time: average vertically, then separate even and odd columns
+    // and average them, too.
+    for(; x < width4; x += 4, row0 += 8, row1 += 8)
+    {
+      const __m128i left = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0)),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1)));
+      const __m128i right = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 4)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 4)));
+      const __m128i even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(left), _mm_castsi128_ps(right), _MM_SHUFFLE(2, 0, 2, 0)));
+      const __m128i odd = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(left), _mm_castsi128_ps(right), _MM_SHUFFLE(3, 1, 3, 1)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x), _mm_avg_epu8(even, odd));
+    }
+
+    // The remaining pixels are rounded the same way as _mm_avg_epu8 does.
+    for(; x < dest.width; ++x, row0 += 2, row1 += 2)
+      for(int c = 0; c < 4; ++c)
+        d[x].channels[c] = static_cast<unsigned char>(((row0[0].channels[c] + row1[0].channels[c] + 1) / 2 +
+                                                       (row0[1].channels[c] + row1[1].channels[c] + 1) / 2 + 1) / 2);
+  }
+}
+
+MAKE_MODULE(ImagePyramidProvider, Perception)
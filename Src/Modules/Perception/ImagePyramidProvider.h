@@ -0,0 +1,38 @@
+/**
+* @file ImagePyramidProvider.h
+* This file declares a module that builds lower resolution versions of the camera image
+* once per frame.
+*/
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/Image.h"
+#include "Representations/Perception/ImagePyramid.h"
+
+MODULE(ImagePyramidProvider)
+  REQUIRES(Image)
+  PROVIDES(ImagePyramid)
+END_MODULE
+
+/**
+* @class ImagePyramidProvider
+* The module halves the resolution of the image several times. Each level is computed from
+* the previous one, averaging four pixels at a time using SSE2.
+*/
+class ImagePyramidProvider : public ImagePyramidProviderBase
+{
+private:
+  void update(ImagePyramid& imagePyramid);
+
+  /**
+  * The method halves the width and the height of an image by averaging blocks of 2x2 pixels.
+  * Odd last rows and columns are ignored.
+  * @param src The first pixel of the source image.
+  * @param srcStep The distance between two successive rows of the source image in pixels.
+  * @param width The width of the source image.
+  * @param height The height of the source image.
+  * @param dest The level the result is written to. Its resolution is set.
+  */
+  static void shrink(const Image::Pixel* src, int srcStep, int width, int height, ImagePyramid::Level& dest);
+};
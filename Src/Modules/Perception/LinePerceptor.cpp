@@ -21,7 +21,8 @@ LinePerceptor::ParameterWrapper::ParameterWrapper(Parameters& parameters,
   nonLineParams(nonLineParams),
   banSectorParams(banSectorParams) {}
 
-LinePerceptor::LinePerceptor()
+LinePerceptor::LinePerceptor() :
+  lineSegs(200), singleSegs(200), lines(50), banSectors(20)
 {
   ParameterWrapper wrapper(parameters, circleParams, nonLineParams, banSectorParams);
   InMapFile inConfig("linePerceptor.cfg");
@@ -77,17 +78,14 @@ void LinePerceptor::update(LinePercept& linePercept)
 
   STOP_TIME_ON_REQUEST("createLineSegments" , createLineSegments(singleSegs););
 
-  linePercept.rawSegs.resize(lineSegs.size());
-  copy(lineSegs.begin(), lineSegs.end(), linePercept.rawSegs.begin());
+  copyToVector(lineSegs, linePercept.rawSegs);
 
   STOP_TIME_ON_REQUEST("createLines", createLines(lines, singleSegs););
   STOP_TIME_ON_REQUEST("analyzeSingleSegments", analyzeSingleSegments(singleSegs, linePercept.circle, lines););
   STOP_TIME_ON_REQUEST("analyzeLines", analyzeLines(lines, linePercept.intersections, linePercept.circle, singleSegs););
 
-  linePercept.singleSegs.resize(singleSegs.size());
-  copy(singleSegs.begin(), singleSegs.end(), linePercept.singleSegs.begin());
-  linePercept.lines.resize(lines.size());
-  copy(lines.begin(), lines.end(), linePercept.lines.begin());
+  copyToVector(singleSegs, linePercept.singleSegs);
+  copyToVector(lines, linePercept.lines);
 
   STOP_TIME_ON_REQUEST("drawLinePercept",
   {
@@ -129,22 +127,23 @@ void LinePerceptor::createBanSectors()
     const int dist = (int)pf1.abs();
     const int dist2 = (int)pf2.abs();
 
-    for(list<BanSector>::iterator s = banSectors.begin(); s != banSectors.end(); s++)
+    for(int i = banSectors.first(); i >= 0; i = banSectors.next(i))
     {
-      if(s->alphaLeft < alpha && s->alphaRight > alpha)
+      BanSector& s = banSectors[i];
+      if(s.alphaLeft < alpha && s.alphaRight > alpha)
       {
-        if((dist > s->start && dist < s->end) ||
-           (dist2 > s->start && dist2 < s->end))
+        if((dist > s.start && dist < s.end) ||
+           (dist2 > s.start && dist2 < s.end))
         {
-          if(s->start > dist)
-            s->start = dist;
-          if(s->end < dist2)
-            s->end = dist2;
-          if(alpha - banSectorParams.angleStepSize < s->alphaLeft)
-            s->alphaLeft = alpha - banSectorParams.angleStepSize;
-          if(alpha + banSectorParams.angleStepSize > s->alphaRight)
-            s->alphaRight = alpha + banSectorParams.angleStepSize;
-          s->counter++;
+          if(s.start > dist)
+            s.start = dist;
+          if(s.end < dist2)
+            s.end = dist2;
+          if(alpha - banSectorParams.angleStepSize < s.alphaLeft)
+            s.alphaLeft = alpha - banSectorParams.angleStepSize;
+          if(alpha + banSectorParams.angleStepSize > s.alphaRight)
+            s.alphaRight = alpha + banSectorParams.angleStepSize;
+          s.counter++;
           goto continueOuter;
         }
       }
@@ -160,14 +159,15 @@ continueOuter:
     ;
   }
 
-  for(list<BanSector>::iterator s = banSectors.begin(); s != banSectors.end(); s++)
+  for(int i = banSectors.first(); i >= 0; i = banSectors.next(i))
   {
+    const BanSector& s = banSectors[i];
     COMPLEX_DRAWING("module:LinePerceptor:banSectors",
     {
-      Vector2<int> p1((int)(cos(s->alphaLeft) * s->start), (int)(sin(s->alphaLeft) * s->start));
-      Vector2<int> p2((int)(cos(s->alphaRight) * s->start), (int)(sin(s->alphaRight) * s->start));
-      Vector2<int> p3((int)(cos(s->alphaLeft) * s->end), (int)(sin(s->alphaLeft) * s->end));
-      Vector2<int> p4((int)(cos(s->alphaRight) * s->end), (int)(sin(s->alphaRight) * s->end));
+      Vector2<int> p1((int)(cos(s.alphaLeft) * s.start), (int)(sin(s.alphaLeft) * s.start));
+      Vector2<int> p2((int)(cos(s.alphaRight) * s.start), (int)(sin(s.alphaRight) * s.start));
+      Vector2<int> p3((int)(cos(s.alphaLeft) * s.end), (int)(sin(s.alphaLeft) * s.end));
+      Vector2<int> p4((int)(cos(s.alphaRight) * s.end), (int)(sin(s.alphaRight) * s.end));
       LINE("module:LinePerceptor:banSectors", p1.x, p1.y, p2.x, p2.y, 20, Drawings::ps_solid, ColorClasses::blue);
       LINE("module:LinePerceptor:banSectors", p1.x, p1.y, p3.x, p3.y, 20, Drawings::ps_solid, ColorClasses::blue);
       LINE("module:LinePerceptor:banSectors", p2.x, p2.y, p4.x, p4.y, 20, Drawings::ps_solid, ColorClasses::blue);
@@ -175,72 +175,70 @@ continueOuter:
     });
   }
 
-  list<BanSector>::iterator nexts2;
-  for(list<BanSector>::iterator s1 = banSectors.begin(); s1 != banSectors.end(); s1++)
+  for(int i1 = banSectors.first(); i1 >= 0; i1 = banSectors.next(i1))
   {
-    nexts2 = s1;
-    nexts2++;
-    for(list<BanSector>::iterator s2 = banSectors.begin(); s2 != banSectors.end(); s2 = nexts2)
+    BanSector& s1 = banSectors[i1];
+    for(int i2 = banSectors.first(), nexts2; i2 >= 0; i2 = nexts2)
     {
-      nexts2 = s2;
-      nexts2++;
+      nexts2 = banSectors.next(i2);
 
-      if(s2 == s1)
+      if(i2 == i1)
         continue;
 
-      if((s1->alphaLeft > s2->alphaLeft && s1->alphaLeft < s2->alphaRight) ||
-         (s1->alphaRight > s2->alphaLeft && s1->alphaRight < s2->alphaRight) ||
-         (s2->alphaLeft > s1->alphaLeft && s2->alphaLeft < s1->alphaRight) ||
-         (s2->alphaRight > s1->alphaLeft && s2->alphaRight < s1->alphaRight))
+      const BanSector& s2 = banSectors[i2];
+
+      if((s1.alphaLeft > s2.alphaLeft && s1.alphaLeft < s2.alphaRight) ||
+         (s1.alphaRight > s2.alphaLeft && s1.alphaRight < s2.alphaRight) ||
+         (s2.alphaLeft > s1.alphaLeft && s2.alphaLeft < s1.alphaRight) ||
+         (s2.alphaRight > s1.alphaLeft && s2.alphaRight < s1.alphaRight))
       {
-        if((s1->start > s2->start && s1->start < s2->end) ||
-           (s2->start > s1->start && s2->start < s1->end))
+        if((s1.start > s2.start && s1.start < s2.end) ||
+           (s2.start > s1.start && s2.start < s1.end))
         {
-          if(s2->alphaLeft < s1->alphaLeft)
-            s1->alphaLeft = s2->alphaLeft;
-          if(s2->alphaRight > s1->alphaRight)
-            s1->alphaRight = s2->alphaRight;
-          if(s2->start < s1->start)
-            s1->start = s2->start;
-          if(s2->end > s1->end)
-            s1->end = s2->end;
-          s1->counter += s2->counter;
-          nexts2 = banSectors.erase(s2);
+          if(s2.alphaLeft < s1.alphaLeft)
+            s1.alphaLeft = s2.alphaLeft;
+          if(s2.alphaRight > s1.alphaRight)
+            s1.alphaRight = s2.alphaRight;
+          if(s2.start < s1.start)
+            s1.start = s2.start;
+          if(s2.end > s1.end)
+            s1.end = s2.end;
+          s1.counter += s2.counter;
+          nexts2 = banSectors.erase(i2);
         }
       }
     }
   }
 
-  list<BanSector>::iterator nexts;
-  for(list<BanSector>::iterator s = banSectors.begin(); s != banSectors.end(); s = nexts)
+  for(int i = banSectors.first(), nexts; i >= 0; i = nexts)
   {
-    nexts = s;
-    nexts++;
-    if(s->counter < banSectorParams.minSectorCounter)
+    nexts = banSectors.next(i);
+    const BanSector& s = banSectors[i];
+    if(s.counter < banSectorParams.minSectorCounter)
     {
       COMPLEX_DRAWING("module:LinePerceptor:banSectors",
       {
-        Vector2<int> p1((int)(cos(s->alphaLeft) * s->start), (int)(sin(s->alphaLeft) * s->start));
-        Vector2<int> p2((int)(cos(s->alphaRight) * s->start), (int)(sin(s->alphaRight) * s->start));
+        Vector2<int> p1((int)(cos(s.alphaLeft) * s.start), (int)(sin(s.alphaLeft) * s.start));
+        Vector2<int> p2((int)(cos(s.alphaRight) * s.start), (int)(sin(s.alphaRight) * s.start));
         Vector2<int> mid = (p1 + p2) / 2;
         CROSS("module:LinePerceptor:banSectors", mid.x, mid.y, 80, 40, Drawings::ps_solid, ColorClasses::red);
       });
-      nexts = banSectors.erase(s);
+      nexts = banSectors.erase(i);
       continue;
     }
 
     COMPLEX_DRAWING("module:LinePerceptor:banSectors",
     {
-      Vector2<int> p1((int)(cos(s->alphaLeft) * s->start), (int)(sin(s->alphaLeft) * s->start));
-      Vector2<int> p2((int)(cos(s->alphaRight) * s->start), (int)(sin(s->alphaRight) * s->start));
-      Vector2<int> p3((int)(cos(s->alphaLeft) * s->end), (int)(sin(s->alphaLeft) * s->end));
-      Vector2<int> p4((int)(cos(s->alphaRight) * s->end), (int)(sin(s->alphaRight) * s->end));
+      Vector2<int> p1((int)(cos(s.alphaLeft) * s.start), (int)(sin(s.alphaLeft) * s.start));
+      Vector2<int> p2((int)(cos(s.alphaRight) * s.start), (int)(sin(s.alphaRight) * s.start));
+      Vector2<int> p3((int)(cos(s.alphaLeft) * s.end), (int)(sin(s.alphaLeft) * s.end));
+      Vector2<int> p4((int)(cos(s.alphaRight) * s.end), (int)(sin(s.alphaRight) * s.end));
       LINE("module:LinePerceptor:banSectors", p1.x, p1.y, p2.x, p2.y, 20, Drawings::ps_dash, ColorClasses::red);
       LINE("module:LinePerceptor:banSectors", p1.x, p1.y, p3.x, p3.y, 20, Drawings::ps_dash, ColorClasses::red);
       LINE("module:LinePerceptor:banSectors", p2.x, p2.y, p4.x, p4.y, 20, Drawings::ps_dash, ColorClasses::red);
       LINE("module:LinePerceptor:banSectors", p3.x, p3.y, p4.x, p4.y, 20, Drawings::ps_dash, ColorClasses::red);
       Vector2<int> pmid = (p1 + p2) / 2 + p3 / 2;
-      DRAWTEXT("module:LinePerceptor:banSectors", pmid.x, pmid.y, 150, ColorClasses::black, s->counter);
+      DRAWTEXT("module:LinePerceptor:banSectors", pmid.x, pmid.y, 150, ColorClasses::black, s.counter);
 
       Vector2<> p1cor(p1);
       Vector2<> p2cor(p2);
@@ -266,7 +264,7 @@ continueOuter:
 
 }
 
-void LinePerceptor::createLineSegments(list<LinePercept::LineSegment>& singleSegs)
+void LinePerceptor::createLineSegments(PooledList<LinePercept::LineSegment>& singleSegs)
 {
   createBanSectors();
 
@@ -276,15 +274,13 @@ void LinePerceptor::createLineSegments(list<LinePercept::LineSegment>& singleSeg
       continue;
 
     //transform to field coordinates
-    const Vector2<> p1_cor = theImageCoordinateSystem.toCorrected(spot->p1),
-                    p2_cor = theImageCoordinateSystem.toCorrected(spot->p2);
     Vector2<> pf1, pf2;
-    if(!Geometry::calculatePointOnField(p1_cor, theCameraMatrix, theCameraInfo, pf1))
+    if(!theProjectionGrid.getPointOnField(spot->p1, pf1))
     {
       CROSS("module:LinePerceptor:LineSegmentsImg", ((spot->p1 + spot->p2) / 2).x, ((spot->p1 + spot->p2) / 2).y, 4, 2, Drawings::ps_solid, ColorClasses::orange);
       continue;
     }
-    if(!Geometry::calculatePointOnField(p2_cor, theCameraMatrix, theCameraInfo, pf2))
+    if(!theProjectionGrid.getPointOnField(spot->p2, pf2))
     {
       CROSS("module:LinePerceptor:LineSegmentsImg", ((spot->p1 + spot->p2) / 2).x, ((spot->p1 + spot->p2) / 2).y, 4, 2, Drawings::ps_solid, ColorClasses::orange);
       continue;
@@ -321,13 +317,14 @@ void LinePerceptor::createLineSegments(list<LinePercept::LineSegment>& singleSeg
 
       bool con = false;
       const float dist = ((pf1 + pf2) / 2.f).squareAbs();
-      for(list<BanSector>::iterator s = banSectors.begin(); s != banSectors.end(); s++)
+      for(int i = banSectors.first(); i >= 0; i = banSectors.next(i))
       {
-        if((alpha > s->alphaLeft && alpha < s->alphaRight) ||
-           abs(alpha - s->alphaLeft) < banSectorParams.maxLineAngleDiff ||
-           abs(alpha - s->alphaRight) < banSectorParams.maxLineAngleDiff)
+        const BanSector& s = banSectors[i];
+        if((alpha > s.alphaLeft && alpha < s.alphaRight) ||
+           abs(alpha - s.alphaLeft) < banSectorParams.maxLineAngleDiff ||
+           abs(alpha - s.alphaRight) < banSectorParams.maxLineAngleDiff)
         {
-          if(dist > sqr(s->start))
+          if(dist > sqr(s.start))
           {
             ARROW("module:LinePerceptor:LineSegmentsImg", spot->p1.x, spot->p1.y, spot->p2.x, spot->p2.y, 3, Drawings::ps_dash, ColorClasses::yellow);
             con = true;
@@ -370,43 +367,44 @@ void LinePerceptor::createLineSegments(list<LinePercept::LineSegment>& singleSeg
   }
 }
 
-void LinePerceptor::createLines(list<LinePercept::Line>& lines, list<LinePercept::LineSegment>& singleSegs)
+void LinePerceptor::createLines(PooledList<LinePercept::Line>& lines, PooledList<LinePercept::LineSegment>& singleSegs)
 {
   //Hough Transformation fuer (ganz) arme....
-  while(lineSegs.size() > 0)
+  while(!lineSegs.empty())
   {
     //pick a segment...
-    LinePercept::LineSegment seg = *lineSegs.begin();
-    lineSegs.erase(lineSegs.begin());
+    const LinePercept::LineSegment seg = lineSegs[lineSegs.first()];
+    lineSegs.erase(lineSegs.first());
 
     ARROW("module:LinePerceptor:Lines1", seg.p1.x, seg.p1.y, seg.p2.x, seg.p2.y, 15, Drawings::ps_solid, ColorClasses::white);
 
     //collect supporters...
-    vector<list<LinePercept::LineSegment>::iterator> supporters;
+    supporters.clear();
     float maxSegmentLength = 0;
-    for(list<LinePercept::LineSegment>::iterator other = lineSegs.begin(); other != lineSegs.end(); other++)
+    for(int i = lineSegs.first(); i >= 0; i = lineSegs.next(i))
     {
-      if((abs(other->alpha - seg.alpha) < parameters.maxAlphaDiff &&
-          abs(other->d - seg.d) < parameters.maxDDiff))
+      LinePercept::LineSegment& other = lineSegs[i];
+      if((abs(other.alpha - seg.alpha) < parameters.maxAlphaDiff &&
+          abs(other.d - seg.d) < parameters.maxDDiff))
       {
-        const float sqr_length = (other->p1 - other->p2).squareAbs();
+        const float sqr_length = (other.p1 - other.p2).squareAbs();
         if(sqr_length > maxSegmentLength)
           maxSegmentLength = sqr_length;
-        supporters.push_back(other);
+        supporters.push_back(i);
       }
-      else if((abs(abs(other->alpha - seg.alpha) - pi) < parameters.maxAlphaDiff &&
-               abs(other->d + seg.d) < parameters.maxDDiff))
+      else if((abs(abs(other.alpha - seg.alpha) - pi) < parameters.maxAlphaDiff &&
+               abs(other.d + seg.d) < parameters.maxDDiff))
       {
-        const float sqr_length = (other->p1 - other->p2).squareAbs();
+        const float sqr_length = (other.p1 - other.p2).squareAbs();
         if(sqr_length > maxSegmentLength)
           maxSegmentLength = sqr_length;
         //make supporters all look into the same direction (alpha in [0...pi])
-        if(other->alpha > seg.alpha)
-          other->alpha -= pi;
+        if(other.alpha > seg.alpha)
+          other.alpha -= pi;
         else
-          other->alpha += pi;
-        other->d *= -1;
-        supporters.push_back(other);
+          other.alpha += pi;
+        other.d *= -1;
+        supporters.push_back(i);
       }
     }
     maxSegmentLength = std::sqrt(maxSegmentLength);
@@ -419,24 +417,20 @@ void LinePerceptor::createLines(list<LinePercept::Line>& lines, list<LinePercept
         CROSS("module:LinePerceptor:Lines1", (seg.p1.x + seg.p2.x) / 2, (seg.p1.y + seg.p2.y) / 2, 20, 20, Drawings::ps_solid, ColorClasses::red);
         DRAWTEXT("module:LinePerceptor:Lines1", seg.p1.x + 50, seg.p1.y + 100, 10, ColorClasses::black, (int)supporters.size());
       });
-      LinePercept::Line l;
+      LinePercept::Line& l = lines[addLine(lines, seg)];
       float d = seg.d, alpha = seg.alpha;
-      l.dead = false;
-      l.midLine = false;
-      l.segments.push_back(seg);
-      for(vector<list<LinePercept::LineSegment>::iterator>::const_iterator sup = supporters.begin(); sup != supporters.end(); sup++)
+      for(int i : supporters)
       {
-        ARROW("module:LinePerceptor:Lines1", (*sup)->p1.x, (*sup)->p1.y, (*sup)->p2.x, (*sup)->p2.y, 15, Drawings::ps_solid, ColorClasses::red);
-        ARROW("module:LinePerceptor:Lines1", seg.p1.x, seg.p1.y, (*sup)->p1.x, (*sup)->p1.y, 5, Drawings::ps_solid, ColorClasses::blue);
-        d += (*sup)->d;
-        alpha += (*sup)->alpha;
-        l.segments.push_back(*(*sup));
+        const LinePercept::LineSegment& sup = lineSegs[i];
+        ARROW("module:LinePerceptor:Lines1", sup.p1.x, sup.p1.y, sup.p2.x, sup.p2.y, 15, Drawings::ps_solid, ColorClasses::red);
+        ARROW("module:LinePerceptor:Lines1", seg.p1.x, seg.p1.y, sup.p1.x, sup.p1.y, 5, Drawings::ps_solid, ColorClasses::blue);
+        d += sup.d;
+        alpha += sup.alpha;
+        l.segments.push_back(sup);
+        lineSegs.erase(i);
       }
-      for(vector<list<LinePercept::LineSegment>::iterator>::const_reverse_iterator sup = supporters.rbegin(); sup != supporters.rend(); sup++)
-        lineSegs.erase(*sup);
       l.d = d / ((int)supporters.size() + 1);
       l.alpha = alpha / ((int)supporters.size() + 1);
-      lines.push_back(l);
     }
     else
       singleSegs.push_back(seg);
@@ -573,50 +567,54 @@ void LinePerceptor::getFirstAndLastOfLine(LinePercept::Line& line, Vector2<>& fi
   last = line.calculateClosestPointOnLine(last);
 }
 
-void LinePerceptor::analyzeLines(list<LinePercept::Line>& lines, vector<LinePercept::Intersection>& intersections, LinePercept::CircleSpot& circle, list<LinePercept::LineSegment>& singleSegs)
+void LinePerceptor::analyzeLines(PooledList<LinePercept::Line>& lines, vector<LinePercept::Intersection>& intersections, LinePercept::CircleSpot& circle, PooledList<LinePercept::LineSegment>& singleSegs)
 {
   //the points first and last are the two points on the line which
   //have the greatest distance to each other ("endpoints")
-  for(list<LinePercept::Line>::iterator line = lines.begin(); line != lines.end(); line++)
-    getFirstAndLastOfLine(*line, line->first, line->last);
+  for(int i = lines.first(); i >= 0; i = lines.next(i))
+  {
+    LinePercept::Line& line = lines[i];
+    getFirstAndLastOfLine(line, line.first, line.last);
+  }
 
 
   //delete lines if their circleSpot is near the found circle
   if(circle.found)
   {
-    vector<list<LinePercept::Line>::iterator> toDelete;
-    for(list<LinePercept::Line>::iterator l1 = lines.begin(); l1 != lines.end(); l1++)
+    toDelete.clear();
+    for(int i = lines.first(); i >= 0; i = lines.next(i))
     {
-      Vector2<> line_mid = (l1->first + l1->last) / 2;
+      const LinePercept::Line& l1 = lines[i];
+      Vector2<> line_mid = (l1.first + l1.last) / 2;
       CROSS("module:LinePerceptor:CircleSpots", line_mid.x, line_mid.y, 30, 30, Drawings::ps_solid, ColorClasses::green);
-      Vector2<> bla(line_mid + (l1->first - l1->last).rotate(pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified));
+      Vector2<> bla(line_mid + (l1.first - l1.last).rotate(pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified));
       CROSS("module:LinePerceptor:CircleSpots", bla.x, bla.y, 30, 30, Drawings::ps_solid, ColorClasses::green);
       if((bla - circle.pos).squareAbs() < sqr(parameters.maxLineCircleDist))
-        toDelete.push_back(l1);
+        toDelete.push_back(i);
       else
       {
-        Vector2<> bla(line_mid + (l1->first - l1->last).rotate(-pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified));
+        Vector2<> bla(line_mid + (l1.first - l1.last).rotate(-pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified));
         CROSS("module:LinePerceptor:CircleSpots", bla.x, bla.y, 30, 30, Drawings::ps_solid, ColorClasses::green);
         if((bla - circle.pos).squareAbs() < sqr(parameters.maxLineCircleDist))
-          toDelete.push_back(l1);
+          toDelete.push_back(i);
       }
 
     }
-    for(vector<list<LinePercept::Line>::iterator>::iterator t = toDelete.begin(); t != toDelete.end(); t++)
-      lines.erase(*t);
+    eraseCollected(lines);
   }
 
   //delete lines if they have at least two segments which overlap (these might be robot legs)
-  vector<list<LinePercept::Line>::iterator> toDelete;
-  for(list<LinePercept::Line>::iterator line = lines.begin(); line != lines.end(); line++)
+  toDelete.clear();
+  for(int i = lines.first(); i >= 0; i = lines.next(i))
   {
-    if(line->dead)
+    const LinePercept::Line& line = lines[i];
+    if(line.dead)
       continue;
 
-    float alpha2 = line->alpha + pi_2;
+    float alpha2 = line.alpha + pi_2;
 
-    vector<LinePercept::LineSegment>::iterator other;
-    for(vector<LinePercept::LineSegment>::iterator seg = line->segments.begin(); seg != line->segments.end(); seg++)
+    vector<LinePercept::LineSegment>::const_iterator other;
+    for(vector<LinePercept::LineSegment>::const_iterator seg = line.segments.begin(); seg != line.segments.end(); seg++)
     {
       float d1 = seg->p1.x * cos(alpha2) + seg->p1.y * sin(alpha2),
             d2 = seg->p2.x * cos(alpha2) + seg->p2.y * sin(alpha2);
@@ -624,7 +622,7 @@ void LinePerceptor::analyzeLines(list<LinePercept::Line>& lines, vector<LinePerc
 
       other = seg;
       other++;
-      for(; other != line->segments.end(); other++)
+      for(; other != line.segments.end(); other++)
       {
         float otherd1 = clipper.limit(other->p1.x * cos(alpha2) + other->p1.y * sin(alpha2)),
               otherd2 = clipper.limit(other->p2.x * cos(alpha2) + other->p2.y * sin(alpha2));
@@ -633,7 +631,7 @@ void LinePerceptor::analyzeLines(list<LinePercept::Line>& lines, vector<LinePerc
         {
           LINE("module:LinePerceptor:Lines3", seg->p1.x, seg->p1.y, seg->p2.x, seg->p2.y, 5, Drawings::ps_solid, ColorClasses::red);
           LINE("module:LinePerceptor:Lines3", other->p1.x, other->p1.y, other->p2.x, other->p2.y, 5, Drawings::ps_solid, ColorClasses::red);
-          toDelete.push_back(line);
+          toDelete.push_back(i);
           goto breakOuter;
         }
       }
@@ -641,74 +639,74 @@ void LinePerceptor::analyzeLines(list<LinePercept::Line>& lines, vector<LinePerc
 breakOuter:
     ;
   }
-  for(vector<list<LinePercept::Line>::iterator>::iterator t = toDelete.begin(); t != toDelete.end(); t++)
-    lines.erase(*t);
+  eraseCollected(lines);
 
   //find lines which are allmost parallel
   toDelete.clear();
-  for(list<LinePercept::Line>::iterator line = lines.begin(); line != lines.end(); line++)
+  for(int i = lines.first(); i >= 0; i = lines.next(i))
   {
-    if(line->dead)
+    LinePercept::Line& line = lines[i];
+    if(line.dead)
       continue;
-    list<LinePercept::Line>::iterator other = line;
-    other++;
-    for(; other != lines.end(); other++)
+    for(int j = lines.next(i); j >= 0; j = lines.next(j))
     {
-      if(other->dead)
+      LinePercept::Line& other = lines[j];
+      if(other.dead)
         continue;
 
-      float alphaDiff = line->alpha - other->alpha;
+      float alphaDiff = line.alpha - other.alpha;
       while(alphaDiff < - pi_2)
         alphaDiff += pi;
       while(alphaDiff >= pi_2)
         alphaDiff -= pi;
       //if endpoints of the other line are close to the line
-      if(((abs(line->calculateDistToLine(other->first)) < parameters.maxLineUniteDist &&
-           abs(line->calculateDistToLine(other->last)) < parameters.maxLineUniteDist)
+      if(((abs(line.calculateDistToLine(other.first)) < parameters.maxLineUniteDist &&
+           abs(line.calculateDistToLine(other.last)) < parameters.maxLineUniteDist)
           ||
-          (abs(other->calculateDistToLine(line->first)) < parameters.maxLineUniteDist &&
-           abs(other->calculateDistToLine(line->last)) < parameters.maxLineUniteDist)
+          (abs(other.calculateDistToLine(line.first)) < parameters.maxLineUniteDist &&
+           abs(other.calculateDistToLine(line.last)) < parameters.maxLineUniteDist)
          )
          &&
          abs(alphaDiff) < parameters.maxLineUniteAlphaDiff
         )
       {
-        line->segments.insert(line->segments.end(), other->segments.begin(), other->segments.end());
-        line->d = (line->d + other->d) / 2;
-        if(line->alpha - other->alpha > pi_2)
-          other->alpha += pi;
-        else if(other->alpha - line->alpha > pi_2)
-          other->alpha -= pi;
-        line->alpha = (line->alpha + other->alpha) / 2;
-        if(line->alpha < 0)
-          line->alpha += pi;
-        getFirstAndLastOfLine(*line, (*line).first, (*line).last);
-        toDelete.push_back(other);
-        other->dead = true;
+        line.segments.insert(line.segments.end(), other.segments.begin(), other.segments.end());
+        line.d = (line.d + other.d) / 2;
+        if(line.alpha - other.alpha > pi_2)
+          other.alpha += pi;
+        else if(other.alpha - line.alpha > pi_2)
+          other.alpha -= pi;
+        line.alpha = (line.alpha + other.alpha) / 2;
+        if(line.alpha < 0)
+          line.alpha += pi;
+        getFirstAndLastOfLine(line, line.first, line.last);
+        toDelete.push_back(j);
+        other.dead = true;
 
       }
     }
   }
-  for(vector<list<LinePercept::Line>::iterator>::iterator t = toDelete.begin(); t != toDelete.end(); t++)
-    lines.erase(*t);
+  eraseCollected(lines);
 
   //add singleSegments where the start and end pos is close to a line to the line
-  vector<list<LinePercept::LineSegment>::iterator> ttoDelete;
-  for(list<LinePercept::LineSegment>::iterator seg = singleSegs.begin(); seg != singleSegs.end(); seg++)
+  toDelete.clear();
+  for(int i = singleSegs.first(); i >= 0; i = singleSegs.next(i))
   {
-    for(list<LinePercept::Line>::iterator line = lines.begin(); line != lines.end(); line++)
+    const LinePercept::LineSegment& seg = singleSegs[i];
+    for(int j = lines.first(); j >= 0; j = lines.next(j))
     {
+      LinePercept::Line& line = lines[j];
 
-      if(abs(seg->p1.x * cos(line->alpha) + seg->p1.y * sin(line->alpha) - line->d) < parameters.maxLineSingleSegDist &&
-         abs(seg->p2.x * cos(line->alpha) + seg->p2.y * sin(line->alpha) - line->d) < parameters.maxLineSingleSegDist)
+      if(abs(seg.p1.x * cos(line.alpha) + seg.p1.y * sin(line.alpha) - line.d) < parameters.maxLineSingleSegDist &&
+         abs(seg.p2.x * cos(line.alpha) + seg.p2.y * sin(line.alpha) - line.d) < parameters.maxLineSingleSegDist)
       {
-        float firstToLast = (float)(line->last - line->first).abs();
-        const Vector2<> segMid = (seg->p1 + seg->p2) / 2.f;
+        float firstToLast = (float)(line.last - line.first).abs();
+        const Vector2<> segMid = (seg.p1 + seg.p2) / 2.f;
         CROSS("module:LinePerceptor:Lines2", segMid.x, segMid.y, 30, 20, Drawings::ps_solid, ColorClasses::yellow);
-        if((firstToLast < (line->last - segMid).abs() || firstToLast < (line->first - segMid).abs()))
+        if((firstToLast < (line.last - segMid).abs() || firstToLast < (line.first - segMid).abs()))
         {
           //seg is not between first and last
-          const float minToLine = (line->last - segMid).abs() > (line->first - segMid).abs() ? (line->first - segMid).abs() : (line->last - segMid).abs();
+          const float minToLine = (line.last - segMid).abs() > (line.first - segMid).abs() ? (line.first - segMid).abs() : (line.last - segMid).abs();
 
           COMPLEX_DRAWING("module:LinePerceptor:Lines2",
           {
@@ -722,42 +720,43 @@ breakOuter:
         else
           CROSS("module:LinePerceptor:Lines2", segMid.x, segMid.y, 30, 20, Drawings::ps_solid, ColorClasses::blue);
 
-        line->segments.push_back(*seg);
-        ttoDelete.push_back(seg);
-        getFirstAndLastOfLine(*line, line->first, line->last, false);
+        line.segments.push_back(seg);
+        toDelete.push_back(i);
+        getFirstAndLastOfLine(line, line.first, line.last, false);
         break;
       }
     }
   }
-  for(vector<list<LinePercept::LineSegment>::iterator>::iterator d = ttoDelete.begin(); d != ttoDelete.end(); d++)
-    singleSegs.erase(*d);
+  eraseCollected(singleSegs);
 
 
   //delete lines which do not "hard cover" (length / sum(segemnts.length)) enough
   toDelete.clear();
-  for(list<LinePercept::Line>::iterator l1 = lines.begin(); l1 != lines.end(); l1++)
+  for(int i = lines.first(); i >= 0; i = lines.next(i))
   {
+    const LinePercept::Line& l1 = lines[i];
     float hardcover = 0;
-    for(vector<LinePercept::LineSegment>::iterator seg = l1->segments.begin(); seg != l1->segments.end(); seg++)
+    for(vector<LinePercept::LineSegment>::const_iterator seg = l1.segments.begin(); seg != l1.segments.end(); seg++)
       hardcover += (seg->p1 - seg->p2).abs();
-    const float hardcoverRatio = hardcover / (l1->first - l1->last).abs();
+    const float hardcoverRatio = hardcover / (l1.first - l1.last).abs();
     if(hardcoverRatio < parameters.minHardcover)
-      toDelete.push_back(l1);
+      toDelete.push_back(i);
   }
-  for(vector<list<LinePercept::Line>::iterator>::iterator t = toDelete.begin(); t != toDelete.end(); t++)
+  for(int i : toDelete)
   {
-    for(vector<LinePercept::LineSegment>::iterator seg = (*(*t)).segments.begin(); seg != (*(*t)).segments.end(); seg++)
-      singleSegs.push_back(*seg);
-    lines.erase(*t);
+    for(const LinePercept::LineSegment& seg : lines[i].segments)
+      singleSegs.push_back(seg);
+    lines.erase(i);
   }
 
   //find intersections
-  for(list<LinePercept::Line>::iterator l1 = lines.begin(); l1 != lines.end(); l1++)
+  for(int i = lines.first(); i >= 0; i = lines.next(i))
   {
-    list<LinePercept::Line>::iterator l2 = l1;
-    for(l2++; l2 != lines.end(); l2++)
+    const LinePercept::Line& l1 = lines[i];
+    for(int j = lines.next(i); j >= 0; j = lines.next(j))
     {
-      float alphaDiff = l1->alpha - l2->alpha;
+      const LinePercept::Line& l2 = lines[j];
+      float alphaDiff = l1.alpha - l2.alpha;
       while(alphaDiff < -pi_2)
         alphaDiff += pi;
       while(alphaDiff >= pi_2)
@@ -765,27 +764,27 @@ breakOuter:
       if(abs(alphaDiff) < parameters.minIntersectionAlphaDiff)
         continue;
 
-      if((l1->first - l1->last).squareAbs() < sqr(parameters.minIntersectionLength) &&
-         (l2->first - l2->last).squareAbs() < sqr(parameters.minIntersectionLength))
+      if((l1.first - l1.last).squareAbs() < sqr(parameters.minIntersectionLength) &&
+         (l2.first - l2.last).squareAbs() < sqr(parameters.minIntersectionLength))
         continue;
 
       //zwei hessesche normaleformen gleichsetzen und aufloesen, dann kommt das bei raus
-      const float zaehler = l1->d - (l2->d * cos(l1->alpha) / cos(l2->alpha)),
-                  nenner = sin(l1->alpha) - (sin(l2->alpha) * cos(l1->alpha) / cos(l2->alpha));
+      const float zaehler = l1.d - (l2.d * cos(l1.alpha) / cos(l2.alpha)),
+                  nenner = sin(l1.alpha) - (sin(l2.alpha) * cos(l1.alpha) / cos(l2.alpha));
       const float y_s = zaehler / nenner,
-                  x_s = (l1->d - y_s * sin(l1->alpha)) / cos(l1->alpha);
+                  x_s = (l1.d - y_s * sin(l1.alpha)) / cos(l1.alpha);
 
       if(y_s == y_s && x_s == x_s)//intersection exists -> not paralel || ident
       {
         const Vector2<> s_p(x_s, y_s);
         //this is some freay stuff which determines in which relation the
-        //point s_p is to l1->first/last and l2->first/last given s_p is the
+        //point s_p is to l1.first/last and l2.first/last given s_p is the
         //intersectionpoint of l1 and l2
         //distToLx = ( -min(dist(sp,last/first)) if in between,  )
         //           (  min(dist(s_p,last/first) else)           )
-        float spToFirst = (float)(s_p - l1->first).abs(),
-              spToLast = (float)(s_p - l1->last).abs(),
-              firstToLast = (float)(l1->first - l1->last).abs();
+        float spToFirst = (float)(s_p - l1.first).abs(),
+              spToLast = (float)(s_p - l1.last).abs(),
+              firstToLast = (float)(l1.first - l1.last).abs();
         float distToL1 = 0, distToL2 = 0;
         if(spToFirst < firstToLast && spToLast < firstToLast)
           //sp is between first and last
@@ -798,9 +797,9 @@ breakOuter:
           distToL1 = spToFirst;
         else
           ASSERT(false);
-        spToFirst = (float)(s_p - l2->first).abs(),
-        spToLast = (float)(s_p - l2->last).abs(),
-        firstToLast = (float)(l2->first - l2->last).abs();
+        spToFirst = (float)(s_p - l2.first).abs(),
+        spToLast = (float)(s_p - l2.last).abs(),
+        firstToLast = (float)(l2.first - l2.last).abs();
         if(spToFirst < firstToLast && spToLast < firstToLast)
           //sp is between first and last
           distToL2 = - (spToFirst > spToLast ? spToLast : spToFirst);
@@ -816,15 +815,15 @@ breakOuter:
 
         LinePercept::Intersection inter;
         inter.pos = Vector2<>(x_s, y_s);
-        Vector2<> t1 = l1->first - l1->last,
-                  t2 = l2->first - l2->last;
+        Vector2<> t1 = l1.first - l1.last,
+                  t2 = l2.first - l2.last;
         //this checks whether the intersection point is closer to first
         //or to last and if it is closer to first we need to flip the
         //direction
-        if((l1->first - inter.pos).squareAbs() < (l1->last - inter.pos).squareAbs())
-          t1 = l1->last - l1->first;
-        if((l2->first - inter.pos).squareAbs() < (l2->last - inter.pos).squareAbs())
-          t2 = l2->last - l2->first;
+        if((l1.first - inter.pos).squareAbs() < (l1.last - inter.pos).squareAbs())
+          t1 = l1.last - l1.first;
+        if((l2.first - inter.pos).squareAbs() < (l2.last - inter.pos).squareAbs())
+          t2 = l2.last - l2.first;
         //this is the heading of the intersection (to l1 and l2)
         Vector2<> dirL1 = Vector2<>(t1).normalize(),
                   dirL2 = Vector2<>(t2).normalize();
@@ -832,8 +831,8 @@ breakOuter:
 
         if(distToL1 < -parameters.minTToEnd && distToL2 < -parameters.minTToEnd)
         {
-          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l1->last.x, l1->last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
-          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l2->last.x, l2->last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
+          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l1.last.x, l1.last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
+          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l2.last.x, l2.last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
           //this is a X
           inter.type = LinePercept::Intersection::X;
           inter.dir1 = dirL1;
@@ -843,8 +842,8 @@ breakOuter:
         else if((distToL1 < -parameters.minTToEnd && distToL2 < parameters.maxTFromEnd) ||
                 (distToL2 < -parameters.minTToEnd && distToL1 < parameters.maxTFromEnd))
         {
-          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l1->last.x, l1->last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
-          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l2->last.x, l2->last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
+          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l1.last.x, l1.last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
+          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l2.last.x, l2.last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
           //this is a T
           inter.type = LinePercept::Intersection::T;
           if(distToL2 < -parameters.minTToEnd && distToL1 < parameters.maxTFromEnd)
@@ -863,8 +862,8 @@ breakOuter:
         }
         else if(distToL1 < parameters.maxTFromEnd && distToL2 < parameters.maxTFromEnd)
         {
-          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l1->last.x, l1->last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
-          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l2->last.x, l2->last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
+          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l1.last.x, l1.last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
+          ARROW("module:LinePerceptor:Intersections", x_s, y_s, l2.last.x, l2.last.y, 5, Drawings::ps_solid, ColorClasses::yellow);
           //this is a L
           inter.type = LinePercept::Intersection::L;
           inter.dir1 = dirL1;
@@ -878,27 +877,29 @@ breakOuter:
   //find "mittellinie"
   if(circle.found)
   {
-    list<LinePercept::Line>::iterator closestLine;
+    int closestLine = -1;
     int minDist = -1;
-    for(list<LinePercept::Line>::iterator l1 = lines.begin(); l1 != lines.end(); l1++)
+    for(int i = lines.first(); i >= 0; i = lines.next(i))
     {
-      const int dist = (int)abs(l1->calculateDistToLine(circle.pos));
+      const LinePercept::Line& l1 = lines[i];
+      const int dist = (int)abs(l1.calculateDistToLine(circle.pos));
       if(dist < parameters.maxMidLineToCircleDist &&
          (dist < minDist || minDist == -1) &&
-         (l1->first - l1->last).squareAbs() > sqr(parameters.minMidLineLength))
+         (l1.first - l1.last).squareAbs() > sqr(parameters.minMidLineLength))
       {
-        closestLine = l1;
+        closestLine = i;
         minDist = dist;
       }
     }
 
     if(minDist != -1)
     {
-      closestLine->midLine = true;
-      circle.pos = closestLine->calculateClosestPointOnLine(circle.pos);
+      LinePercept::Line& midLine = lines[closestLine];
+      midLine.midLine = true;
+      circle.pos = midLine.calculateClosestPointOnLine(circle.pos);
 
       //intersections
-      const Vector2<> midLineDir = (closestLine->first - closestLine->last).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified);
+      const Vector2<> midLineDir = (midLine.first - midLine.last).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified);
       LinePercept::Intersection inter;
 
       inter.pos = circle.pos + midLineDir;
@@ -918,55 +919,54 @@ breakOuter:
   }
 }
 
-void LinePerceptor::analyzeSingleSegments(list<LinePercept::LineSegment>& singleSegs, LinePercept::CircleSpot& circle, list<LinePercept::Line>& lines)
+void LinePerceptor::analyzeSingleSegments(PooledList<LinePercept::LineSegment>& singleSegs, LinePercept::CircleSpot& circle, PooledList<LinePercept::Line>& lines)
 {
-
-  list<LinePercept::CircleSpot> circleSpots;
-  list<LinePercept::CircleSpot> circleSpots2;
+  circleSpots.clear();
+  circleSpots2.clear();
   LinePercept::CircleSpot spot;
+  const int minSegmentImgLength = theProcessingResolution.scale(circleParams.minSegmentImgLength, theCameraInfo.camera);
 
-  list<LinePercept::LineSegment>::iterator seg2;
-  for(list<LinePercept::LineSegment>::iterator seg = singleSegs.begin(); seg != singleSegs.end(); seg++)
+  for(int i = singleSegs.first(); i >= 0; i = singleSegs.next(i))
   {
-    ARROW("module:LinePerceptor:CircleSpots", seg->p1.x, seg->p1.y, seg->p2.x, seg->p2.y, 20, Drawings::ps_solid, ColorClasses::blue);
+    const LinePercept::LineSegment& seg = singleSegs[i];
+    ARROW("module:LinePerceptor:CircleSpots", seg.p1.x, seg.p1.y, seg.p2.x, seg.p2.y, 20, Drawings::ps_solid, ColorClasses::blue);
 
-    const Vector2<> seg_dir = seg->p1 - seg->p2;
-    const Vector2<> seg_mid = (seg->p1 + seg->p2) / 2;
+    const Vector2<> seg_dir = seg.p1 - seg.p2;
+    const Vector2<> seg_mid = (seg.p1 + seg.p2) / 2;
     const Vector2<> seg_norm = Vector2<>(seg_dir.x, seg_dir.y).rotateLeft();
 
-    ASSERT(seg->p1 != seg->p2);
-    const Vector2<> spot1 = seg_mid + (seg->p1 - seg->p2).rotate(pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified);
+    ASSERT(seg.p1 != seg.p2);
+    const Vector2<> spot1 = seg_mid + (seg.p1 - seg.p2).rotate(pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified);
     spot.pos = spot1;
-    spot.iterator = seg;
+    spot.segment = i;
     LINE("module:LinePerceptor:CircleSpots2", spot.pos.x, spot.pos.y, seg_mid.x, seg_mid.y, 5, Drawings::ps_solid, ColorClasses::yellow);
     CROSS("module:LinePerceptor:CircleSpots2", spot.pos.x, spot.pos.y, 20, 20, Drawings::ps_solid, ColorClasses::yellow);
     circleSpots2.push_back(spot);
-    const Vector2<> spot2 = seg_mid + (seg->p1 - seg->p2).rotate(-pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified);
+    const Vector2<> spot2 = seg_mid + (seg.p1 - seg.p2).rotate(-pi_2).normalize(theFieldDimensions.centerCircleRadius + parameters.circleBiggerThanSpecified);
     spot.pos = spot2;
-    spot.iterator = seg;
+    spot.segment = i;
     LINE("module:LinePerceptor:CircleSpots2", spot.pos.x, spot.pos.y, seg_mid.x, seg_mid.y, 5, Drawings::ps_solid, ColorClasses::yellow);
     CROSS("module:LinePerceptor:CircleSpots2", spot.pos.x, spot.pos.y, 20, 20, Drawings::ps_solid, ColorClasses::yellow);
     circleSpots2.push_back(spot);
 
-    if(seg_dir.squareAbs() < sqr(circleParams.minSegmentLength) || (seg->p1Img - seg->p2Img).squareAbs() < sqr(circleParams.minSegmentImgLength))
+    if(seg_dir.squareAbs() < sqr(circleParams.minSegmentLength) || (seg.p1Img - seg.p2Img).squareAbs() < sqr(minSegmentImgLength))
       continue;
 
     LINE("module:LinePerceptor:CircleSpots", seg_mid.x, seg_mid.y, seg_mid.x + seg_norm.x, seg_mid.y + seg_norm.y, 20, Drawings::ps_solid, ColorClasses::orange);
 
-    seg2 = seg;
-    seg2++;
-    for(; seg2 != singleSegs.end(); seg2++)
+    for(int j = singleSegs.next(i); j >= 0; j = singleSegs.next(j))
     {
-      const Vector2<> seg2_dir = seg2->p1 - seg2->p2;
-      if(seg2_dir.squareAbs() < sqr(circleParams.minSegmentLength) || (seg2->p1Img - seg2->p2Img).squareAbs() < sqr(circleParams.minSegmentImgLength))
+      const LinePercept::LineSegment& seg2 = singleSegs[j];
+      const Vector2<> seg2_dir = seg2.p1 - seg2.p2;
+      if(seg2_dir.squareAbs() < sqr(circleParams.minSegmentLength) || (seg2.p1Img - seg2.p2Img).squareAbs() < sqr(minSegmentImgLength))
         continue;
 
-      if((seg->p1 - seg2->p1).squareAbs() < sqr(circleParams.maxNgbhDist) ||
-         (seg->p1 - seg2->p2).squareAbs() < sqr(circleParams.maxNgbhDist) ||
-         (seg->p2 - seg2->p1).squareAbs() < sqr(circleParams.maxNgbhDist) ||
-         (seg->p2 - seg2->p2).squareAbs() < sqr(circleParams.maxNgbhDist))
+      if((seg.p1 - seg2.p1).squareAbs() < sqr(circleParams.maxNgbhDist) ||
+         (seg.p1 - seg2.p2).squareAbs() < sqr(circleParams.maxNgbhDist) ||
+         (seg.p2 - seg2.p1).squareAbs() < sqr(circleParams.maxNgbhDist) ||
+         (seg.p2 - seg2.p2).squareAbs() < sqr(circleParams.maxNgbhDist))
       {
-        const Vector2<> seg2_mid = (seg2->p1 + seg2->p2) / 2;
+        const Vector2<> seg2_mid = (seg2.p1 + seg2.p2) / 2;
         LINE("module:LinePerceptor:CircleSpots", seg_mid.x, seg_mid.y, seg2_mid.x, seg2_mid.y, 20, Drawings::ps_solid, ColorClasses::red);
         const Vector2<> seg2_norm = Vector2<>(seg2_dir.x, seg2_dir.y).rotateLeft();
 
@@ -1009,31 +1009,29 @@ void LinePerceptor::analyzeSingleSegments(list<LinePercept::LineSegment>& single
 
   //Hough Transformation fuer (ganz) arme ;-)
   const int sqrMaxSupporterDist = sqr(circleParams.maxSupporterDist);
-  list<list<LinePercept::LineSegment>::iterator> toDelete;
-  for(list<LinePercept::CircleSpot>::iterator spot_iter = circleSpots.begin(); spot_iter != circleSpots.end(); spot_iter++)
+  toDelete.clear();
+  for(const LinePercept::CircleSpot& circleSpot : circleSpots)
   {
-    spot = *spot_iter;
     Vector2<> center(0, 0);
+    int numOfSupporters = 0;
 
-    vector<list<LinePercept::CircleSpot>::iterator> supporters;
-
-    for(list<LinePercept::CircleSpot>::iterator other = circleSpots.begin(); other != circleSpots.end(); other++)
+    for(const LinePercept::CircleSpot& other : circleSpots)
     {
-      if((other->pos - spot.pos).squareAbs() < sqrMaxSupporterDist)
+      if((other.pos - circleSpot.pos).squareAbs() < sqrMaxSupporterDist)
       {
-        supporters.push_back(other);
-        center += other->pos;
+        ++numOfSupporters;
+        center += other.pos;
       }
     }
 
-    if((int)supporters.size() >= circleParams.minSupporters)
+    if(numOfSupporters >= circleParams.minSupporters)
     {
-      center /= (float) supporters.size();
+      center /= (float) numOfSupporters;
 
       //collect second round of supporters
-      for(list<LinePercept::CircleSpot>::iterator other = circleSpots2.begin(); other != circleSpots2.end(); other++)
-        if((other->pos - center).squareAbs() < sqr(circleParams.maxSupporterDist2))
-          toDelete.push_back(other->iterator);
+      for(const LinePercept::CircleSpot& other : circleSpots2)
+        if((other.pos - center).squareAbs() < sqr(circleParams.maxSupporterDist2))
+          toDelete.push_back(other.segment);
 
       circle.pos = center;
       circle.found = true;
@@ -1043,44 +1041,73 @@ void LinePerceptor::analyzeSingleSegments(list<LinePercept::LineSegment>& single
       break;
     }
   }
-  for(list<list<LinePercept::LineSegment>::iterator>::iterator d = toDelete.begin(); d != toDelete.end(); ++d)
-  {
-    list<list<LinePercept::LineSegment>::iterator>::iterator i = d;
-    for(++i; i != toDelete.end();)
-      if(*i == *d)
-        i = toDelete.erase(i);
-      else
-        ++i;
-    singleSegs.erase(*d);
-  }
+  eraseCollected(singleSegs);
 
   //a single segment is assumed to be a line if it's size is sufficent (and it's not part of the circle)
   toDelete.clear();
-  for(list<LinePercept::LineSegment>::iterator seg = singleSegs.begin(); seg != singleSegs.end(); seg++)
+  for(int i = singleSegs.first(); i >= 0; i = singleSegs.next(i))
   {
-    if((seg->p1 - seg->p2).squareAbs() > sqr(parameters.minLineSingleRegionLength))
+    const LinePercept::LineSegment& seg = singleSegs[i];
+    if((seg.p1 - seg.p2).squareAbs() > sqr(parameters.minLineSingleRegionLength))
     {
-      LinePercept::Line l;
-      l.d = seg->d;
-      l.alpha = seg->alpha;
-      l.segments.push_back(*seg);
-      l.dead = false;
-      l.midLine = false;
-      lines.push_back(l);
-      toDelete.push_back(seg);
+      addLine(lines, seg);
+      toDelete.push_back(i);
     }
   }
-  for(list<list<LinePercept::LineSegment>::iterator>::iterator d = toDelete.begin(); d != toDelete.end(); ++d)
+  eraseCollected(singleSegs);
+}
+
+int LinePerceptor::addLine(PooledList<LinePercept::Line>& lines, const LinePercept::LineSegment& seg)
+{
+  const int index = lines.push_back();
+  LinePercept::Line& l = lines[index];
+  l.d = seg.d;
+  l.alpha = seg.alpha;
+  l.dead = false;
+  l.midLine = false;
+  l.segments.clear(); // keeps the memory of the line that used this slot before
+  l.segments.push_back(seg);
+  l.first = l.last = l.startInImage = l.endInImage = Vector2<>();
+  return index;
+}
+
+template<class T> void LinePerceptor::eraseCollected(PooledList<T>& list)
+{
+  std::sort(toDelete.begin(), toDelete.end());
+  toDelete.erase(std::unique(toDelete.begin(), toDelete.end()), toDelete.end());
+  for(int i : toDelete)
+    list.erase(i);
+}
+
+template<class T> void LinePerceptor::copyToVector(const PooledList<T>& list, std::vector<T>& vector)
+{
+  vector.resize(list.size());
+  typename std::vector<T>::iterator dest = vector.begin();
+  for(int i = list.first(); i >= 0; i = list.next(i))
+    *dest++ = list[i];
+}
+
+void LinePerceptor::copyToVector(const PooledList<LinePercept::Line>& list, std::vector<LinePercept::Line>& vector)
+{
+  // Destructing the surplus lines would free their segments, so take them first.
+  const size_t size = (size_t) list.size();
+  for(size_t i = size; i < vector.size(); ++i)
+  {
+    spareSegments.push_back(std::vector<LinePercept::LineSegment>());
+    spareSegments.back().swap(vector[i].segments);
+  }
+  const size_t oldSize = vector.size();
+  vector.resize(size);
+  for(size_t i = oldSize; i < size && !spareSegments.empty(); ++i)
   {
-    list<list<LinePercept::LineSegment>::iterator>::iterator i = d;
-    for(++i; i != toDelete.end();)
-      if(*i == *d)
-        i = toDelete.erase(i);
-      else
-        ++i;
-    singleSegs.erase(*d);
+    vector[i].segments.swap(spareSegments.back());
+    spareSegments.pop_back();
   }
+
+  std::vector<LinePercept::Line>::iterator dest = vector.begin();
+  for(int i = list.first(); i >= 0; i = list.next(i))
+    *dest++ = list[i];
 }
 
-MAKE_MODULE(LinePerceptor, Perception)
+MAKE_CONCURRENT_MODULE(LinePerceptor, Perception)
 
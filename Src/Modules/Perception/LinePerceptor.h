@@ -9,15 +9,20 @@
 #include "Representations/Perception/LineSpots.h"
 #include "Representations/Perception/LinePercept.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
+#include "Representations/Perception/ProjectionGrid.h"
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Configuration/FieldDimensions.h"
+#include "Tools/PooledList.h"
 
 MODULE(LinePerceptor)
   REQUIRES(CameraMatrix)
   REQUIRES(CameraInfo)
+  REQUIRES(ProcessingResolution)
   REQUIRES(ImageCoordinateSystem)
+  REQUIRES(ProjectionGrid)
   REQUIRES(LineSpots)
   REQUIRES(FieldDimensions)
   REQUIRES(FrameInfo)
@@ -80,7 +85,7 @@ class LinePerceptor : public LinePerceptorBase
     (int) maxNgbhDist, /**< The maximum distance of two linesegments to create a circleSpot */
     (int) maxRadiusError, /**< The maximum error in radius a intersection from two linesegments may have to create a circleSpot */
     (int) minSegmentLength, /**< The minimum length of a lineSegment to be taken into account for the center circle */
-    (int) minSegmentImgLength, /**< The minimum length in image coordinates of a linesegment to be taken into acount for the center circle */
+    (int) minSegmentImgLength, /**< The minimum length in image coordinates (at full resolution) of a linesegment to be taken into acount for the center circle */
     (int) minSupporters, /**< The minimum number of supporters for the center circle */
     (int) maxSupporterDist, /**< The maximum distance of two circleSpots to support each other */
     (int) maxSupporterDist2, /**< The maximum distance of two circleSpots to support each other in the second round */
@@ -135,10 +140,16 @@ class LinePerceptor : public LinePerceptorBase
   NonLineParameters nonLineParams; /**< Parameters for filtering out lines near robots */
   BanSectorParameters banSectorParams; /**< Parameters for the creation of ban sectors */
 
-  std::list<LinePercept::LineSegment> lineSegs; /**< All the lineSegments */
-  std::list<LinePercept::LineSegment> singleSegs;
-  std::list<LinePercept::Line> lines;
-  std::list<BanSector> banSectors; /**< The ban sectors, where no vertical, long spots are accepted */
+  /* The containers are members so that their memory is reused in every frame. */
+  PooledList<LinePercept::LineSegment> lineSegs; /**< All the lineSegments */
+  PooledList<LinePercept::LineSegment> singleSegs;
+  PooledList<LinePercept::Line> lines;
+  PooledList<BanSector> banSectors; /**< The ban sectors, where no vertical, long spots are accepted */
+  std::vector<LinePercept::CircleSpot> circleSpots; /**< Possible centers of the center circle from pairs of segments */
+  std::vector<LinePercept::CircleSpot> circleSpots2; /**< Possible centers of the center circle from single segments */
+  std::vector<int> supporters; /**< The indices of elements supporting a line or circle */
+  std::vector<int> toDelete; /**< The indices of elements erased after a loop over their list */
+  std::vector<std::vector<LinePercept::LineSegment> > spareSegments; /**< The segment vectors of lines removed from the LinePercept, reused for lines added later */
 
   /** update the LinePercept */
   void update(LinePercept& linePercept);
@@ -151,14 +162,14 @@ class LinePerceptor : public LinePerceptorBase
    * the banSector filter criterions
    * @param singleSegs a reference to the singleSegs list in the LinePercept
    * */
-  void createLineSegments(std::list<LinePercept::LineSegment>& singleSegs);
+  void createLineSegments(PooledList<LinePercept::LineSegment>& singleSegs);
 
   /**
    * creates the lines from the singleSegments
    * @param lines a reference to the lines list in the LinePercept
    * @param singleSegs a reference to the singleSegs list in the LinePercept
    * */
-  void createLines(std::list<LinePercept::Line>& lines, std::list<LinePercept::LineSegment>& singleSegs);
+  void createLines(PooledList<LinePercept::Line>& lines, PooledList<LinePercept::LineSegment>& singleSegs);
 
   /**
    * analyzes the lines, merges and deletes some if neccessary and creates intersections
@@ -167,7 +178,7 @@ class LinePerceptor : public LinePerceptorBase
    * @param circle a reference to the circle in the LinePercept
    * @param singleSegs a reference to the singleSegs list in the LinePercept
    * */
-  void analyzeLines(std::list<LinePercept::Line>& lines, std::vector<LinePercept::Intersection>& intersections, LinePercept::CircleSpot& circle, std::list<LinePercept::LineSegment>& singleSegs);
+  void analyzeLines(PooledList<LinePercept::Line>& lines, std::vector<LinePercept::Intersection>& intersections, LinePercept::CircleSpot& circle, PooledList<LinePercept::LineSegment>& singleSegs);
 
   /**
    * analyze the singleSegments and try to find the center circle
@@ -175,7 +186,7 @@ class LinePerceptor : public LinePerceptorBase
    * @param circle a reference to the circle in the LinePercept
    * @param lines a reference to the lines list in the LinePercept
    * */
-  void analyzeSingleSegments(std::list<LinePercept::LineSegment>& singleSegs, LinePercept::CircleSpot& circle, std::list<LinePercept::Line>& lines);
+  void analyzeSingleSegments(PooledList<LinePercept::LineSegment>& singleSegs, LinePercept::CircleSpot& circle, PooledList<LinePercept::Line>& lines);
 
   /**
    * Determines the start and end point of a line. If updateLine == true the d and alpha values of the line
@@ -187,6 +198,40 @@ class LinePerceptor : public LinePerceptorBase
    * */
   void getFirstAndLastOfLine(LinePercept::Line& line, Vector2<>& first, Vector2<>& last, bool updateLine = true);
 
+  /**
+   * Appends a line that consists of a single segment.
+   * @param lines The list the line is added to.
+   * @param seg The segment that defines the line.
+   * @return The index of the new line.
+   */
+  int addLine(PooledList<LinePercept::Line>& lines, const LinePercept::LineSegment& seg);
+
+  /**
+   * Erases the elements whose indices were collected in toDelete from a list.
+   * Indices that were collected more than once are only erased once.
+   * @param list The list the indices refer to.
+   */
+  template<class T> void eraseCollected(PooledList<T>& list);
+
+  /**
+   * Copies the elements of a list into a vector of the LinePercept. Elements
+   * that already exist in the vector are assigned, so they keep their memory.
+   * Only appending more elements than the vector ever had allocates memory.
+   * @param list The list that is copied.
+   * @param vector The vector that receives the elements.
+   */
+  template<class T> static void copyToVector(const PooledList<T>& list, std::vector<T>& vector);
+
+  /**
+   * Copies the lines into the LinePercept like the method above. The segment
+   * vectors of lines that are removed from the percept are kept in spareSegments
+   * and handed to lines appended later, so that copying only allocates memory if
+   * a frame has more or longer lines than any frame before.
+   * @param list The lines that are copied.
+   * @param vector The lines of the LinePercept.
+   */
+  void copyToVector(const PooledList<LinePercept::Line>& list, std::vector<LinePercept::Line>& vector);
+
 public:
   /*
    * Default constructor
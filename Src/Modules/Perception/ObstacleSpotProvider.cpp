@@ -8,12 +8,18 @@
 #include "ObstacleSpotProvider.h"
 #include "Representations/Perception/BodyContour.h"
 #include <cfloat>
+#include <cstring>
 #include <algorithm>
+#include <emmintrin.h>
 
 using namespace std;
 
+/** The color classes (as ColorReference::MultiColor::colors) that are treated as ground. */
+static const unsigned char groundColors = 1 << (ColorClasses::green - 1) | 1 << (ColorClasses::black - 1) | 1 << (ColorClasses::orange - 1);
+
 //initialize lastFrameImageHeight with 1 to avoid division by zero if the first image received is from the upper cam
-ObstacleSpotProvider::ObstacleSpotProvider() : lastFrameImageHeight(1), sawSpotsInLowerCamLastFrame(false)
+ObstacleSpotProvider::ObstacleSpotProvider() : lastFrameImageHeight(1), scaledNonGreenCount(0), sawSpotsInLowerCamLastFrame(false),
+  classifiedStart(0), classifiedEnd(0)
 {}
 
 void ObstacleSpotProvider::update(ObstacleSpots& spots)
@@ -30,6 +36,7 @@ void ObstacleSpotProvider::update(ObstacleSpots& spots)
 
   spots.obstacles.clear();
   possibleSpots.clear();
+  scaledNonGreenCount = theProcessingResolution.scale(nonGreenCount, theCameraInfo.camera);
 
   if(!theGroundContactState.contact)
   {//Dont create any points if we are flying
@@ -85,32 +92,24 @@ void ObstacleSpotProvider::update(ObstacleSpots& spots)
 
 bool ObstacleSpotProvider::searchDownward(const int x, int y, int yEnd, Vector2<int>& outBottomCoordinate)
 {
-  if(y < nonGreenCount)
+  if(y < scaledNonGreenCount)
   {
     return false;
   }
 
   bool breakCausedByGreenCount = false;
-  yEnd = yEnd - (nonGreenCount + 1); //in worst case the loop runs nonGreenCount pixels further than yEnd
+  yEnd = yEnd - (scaledNonGreenCount + 1); //in worst case the loop runs nonGreenCount pixels further than yEnd
   int up = 0;
-  const Image::Pixel* pPixel = &theImage[y][x];
-  const Image::Pixel* pEnd   = &theImage[yEnd][x];
-  const int widthstep = theImage.widthStep * nonGreenCount;
   //this loop jumps in nonGreenCount steps and searches backwards if green is
   //found to ensure that there is enough green to skip
-  for(; pPixel <= pEnd; pPixel += widthstep, y += nonGreenCount)
+  for(; y <= yEnd; y += scaledNonGreenCount)
   {
-    ASSERT(pPixel >= &theImage[0][0]);
-    ASSERT(pPixel <= &theImage[theImage.height-1][theImage.width-1]);
-    if(isGroundColor(pPixel))
+    if(isGroundRow(y))
     {
       //search upward to determine how much green we have jumped
-      up = countGreen(pPixel, pPixel - widthstep,
-                                      theImage.widthStep);
-
-      const int bottomCount = countGreen(pPixel + theImage.widthStep,
-                                         pPixel + widthstep, theImage.widthStep);
-      if(up + bottomCount > nonGreenCount)
+      up = countRun(y, true, true, scaledNonGreenCount + 1);
+      const int bottomCount = countRun(y + 1, true, false, scaledNonGreenCount);
+      if(up + bottomCount > scaledNonGreenCount)
       {
         breakCausedByGreenCount = true;
         break;
@@ -127,25 +126,24 @@ bool ObstacleSpotProvider::searchDownward(const int x, int y, int yEnd, Vector2<
 
 Vector2<int> ObstacleSpotProvider::searchUpward(const int x, int y, const int yEnd)
 {
-  const Image::Pixel* pPixel = &theImage[y][x];
+  //alternately skip a run of non-green and a run of green rows until a
+  //run of green is longer than nonGreenCount
   int greenCount = 0;
-  for(; y > yEnd; --y, pPixel -= theImage.widthStep)
+  while(y > yEnd)
   {
-    ASSERT(pPixel >= &theImage[0][0]);
-    ASSERT(pPixel <= &theImage[theImage.height-1][theImage.width-1]);
-    if(isGroundColor(pPixel))
-    {
-      ++greenCount;
-    }
-    else
+    y -= countRun(y, false, true, y - yEnd);
+    if(y == yEnd)
     {
       greenCount = 0;
+      break;
     }
-
-    if(greenCount > nonGreenCount)
+    greenCount = countRun(y, true, true, std::min(y - yEnd, scaledNonGreenCount + 1));
+    if(greenCount > scaledNonGreenCount)
     {
+      y -= scaledNonGreenCount; //the row at which the green run became long enough
       break;
     }
+    y -= greenCount;
   }
   return Vector2<int>(x,y + greenCount);
 }
@@ -222,6 +220,7 @@ void ObstacleSpotProvider::handleBufferedSpots(std::list<Vector2<int> >& possibl
       }
 
       //search upward to see if the obstacle continues in the upper image
+      classifyColumn(spotInImg.x, 0, spotInImg.y + 1);
       Vector2<int> obstacleEnd = searchUpward(spotInImg.x, spotInImg.y, 0); //FIXME use horizon
       LINE("module:ObstacleSpotProvider:upHeight", spotInImg.x, spotInImg.y,
            obstacleEnd.x, obstacleEnd.y, 2, Drawings::ps_solid, ColorClasses::red);
@@ -301,52 +300,61 @@ inline int ObstacleSpotProvider::squareDistance(const Vector2<int>& a,const Vect
   return x * x + y * y;
 }
 
-int ObstacleSpotProvider::countGreen(const Image::Pixel* pStart,const Image::Pixel* pEnd,
-                                     const int widthstep)
+void ObstacleSpotProvider::classifyColumn(const int x, int yStart, const int yEnd)
+{
+  ASSERT(x >= 0 && x < theImage.width);
+  ASSERT(yStart >= 0 && yEnd <= theImage.height);
+  yStart &= ~15;
+  classifiedStart = yStart;
+  classifiedEnd = yEnd;
+  if(yStart >= yEnd)
+    return;
+
+  theColorReference.classifyRow(&theImage[yStart][x], yEnd - yStart, theImage.widthStep, columnColors + yStart);
+  memset(columnColors + yEnd, 0, 16); //the rows after yEnd do not belong to the ground
+
+  //convert blocks of 16 color classes to 16 bits
+  const __m128i ground = _mm_set1_epi8(static_cast<char>(groundColors));
+  const __m128i zero = _mm_setzero_si128();
+  for(int y = yStart; y < yEnd; y += 16)
+  {
+    const __m128i colors = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columnColors + y));
+    const unsigned long long bits = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(colors, ground), zero)) & 0xffff;
+    unsigned long long& word = groundRows[y >> 6];
+    word = (word & ~(0xffffull << (y & 63))) | bits << (y & 63);
+  }
+}
+
+int ObstacleSpotProvider::countRun(int y, const bool ground, const bool upward, const int max) const
 {
+  ASSERT(max <= 0 || (upward ? y - max + 1 >= classifiedStart && y < classifiedEnd
+                             : y >= classifiedStart && y + max <= classifiedEnd));
   int count = 0;
-  if(pStart <= pEnd) //scan forward
+  while(count < max)
   {
-    for(; pStart <= pEnd; pStart += widthstep)
+    const int bit = y & 63;
+    const unsigned long long word = ground ? groundRows[y >> 6] : ~groundRows[y >> 6];
+    int run, available;
+    if(upward)
     {
-      ASSERT(pStart >= &theImage[0][0]);
-      ASSERT(pStart <= &theImage[theImage.height-1][theImage.width-1]);
-      if(isGroundColor(pStart))
-      {
-        ++count;
-      }
-      else
-      {
-        break;
-      }
+      //row y becomes the highest bit. The first zero ends the run.
+      const unsigned long long ends = ~(word << (63 - bit));
+      run = ends ? __builtin_clzll(ends) : 64;
+      available = bit + 1;
     }
-  }
-  else //scan backwards
-  {//FIXME duplicate code
-    for(; pStart >= pEnd; pStart -= widthstep)
+    else
     {
-      ASSERT(pStart >= &theImage[0][0]);
-      ASSERT(pStart <= &theImage[theImage.height-1][theImage.width-1]);
-      if(isGroundColor(pStart))
-      {
-        ++count;
-      }
-      else
-      {
-        break;
-      }
+      //row y becomes the lowest bit. The first zero ends the run.
+      const unsigned long long ends = ~(word >> bit);
+      run = ends ? __builtin_ctzll(ends) : 64;
+      available = 64 - bit;
     }
+    count += run;
+    if(run < available)
+      break;
+    y += upward ? -run : run;
   }
-  return count;
-}
-
-bool ObstacleSpotProvider::isGroundColor(const Image::Pixel* pPixel) const
-{
-  ASSERT(pPixel >= &theImage[0][0]);
-  ASSERT(pPixel <= &theImage[theImage.height-1][theImage.width-1]);
-
-  ColorReference::MultiColor colors = theColorReference.getColorClasses(pPixel);
-  return colors.isGreen() || colors.isBlack() || colors.isOrange();
+  return std::min(count, max);
 }
 
 void ObstacleSpotProvider::handleNewSpots(std::list<Vector2<int> >& possibleSpots)
@@ -359,11 +367,27 @@ void ObstacleSpotProvider::handleNewSpots(std::list<Vector2<int> >& possibleSpot
     const PossibleObstacleSpots::Scanline& line = thePossibleObstacleSpots.scanlines[i];
     const int lineX = line.xImg;
     const int spotCount = std::min(line.spotCount, MaxTriesPerScanline);
+    if(spotCount <= 0)
+    {
+      continue;
+    }
+    int yEnd = theImage.height;
+    theBodyContour.clipBottom(lineX, yEnd);
+
+    //classify all rows the searches of all spots of this scanline might look at
+    int yMin = line.spots[0];
+    int yMax = line.spots[0];
+    for(int j = 1; j < spotCount; ++j)
+    {
+      yMin = std::min(yMin, line.spots[j]);
+      yMax = std::max(yMax, line.spots[j]);
+    }
+    classifyColumn(lineX, std::max(0, std::min(horizon, yMin - scaledNonGreenCount)),
+                   std::min(theImage.height, std::max(yEnd, yMax + 1)));
+
     for(int j = 0; j < spotCount; ++j)
     {
       int y = line.spots[j];
-      int yEnd = theImage.height;
-      theBodyContour.clipBottom(lineX, yEnd);
       Vector2<int> downSpot;
 
       //searchDownward may hit the image border. That is ok. Those spots are removed later
@@ -599,7 +623,7 @@ void ObstacleSpotProvider::removeOverlappingBanZones(ObstacleSpots& spots) const
 
 void ObstacleSpotProvider::checkIfTooCloseToBottom(ObstacleSpots& spots) const
 {
-  const int limit = theImage.height - nonGreenCount - 1;
+  const int limit = theImage.height - scaledNonGreenCount - 1;
   for(const ObstacleSpots::Obstacle& o : spots.obstacles)
   {
     for(const ObstacleSpots::Spot& s : o.spots)
@@ -615,4 +639,4 @@ void ObstacleSpotProvider::checkIfTooCloseToBottom(ObstacleSpots& spots) const
   end:;
 }
 
-MAKE_MODULE(ObstacleSpotProvider, Perception)
+MAKE_CONCURRENT_MODULE(ObstacleSpotProvider, Perception)
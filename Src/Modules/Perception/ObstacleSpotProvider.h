@@ -14,6 +14,7 @@
 #include "Representations/Perception/BodyContour.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Modeling/Odometer.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
@@ -28,11 +29,12 @@ MODULE(ObstacleSpotProvider)
   REQUIRES(BodyContour)
   REQUIRES(CameraMatrix)
   REQUIRES(CameraInfo)
+  REQUIRES(ProcessingResolution)
   REQUIRES(Odometer)
   REQUIRES(GroundContactState)
   REQUIRES(ImageCoordinateSystem)
   PROVIDES_WITH_DRAW(ObstacleSpots)
-  DEFINES_PARAMETER(int, nonGreenCount, 11)
+  DEFINES_PARAMETER(int, nonGreenCount, 11) /**< The number of green rows that end an obstacle (at full resolution). */
   DEFINES_PARAMETER(float, minObstacleHeight, 200.0f) /**< in mm */
   DEFINES_PARAMETER(float, allowedHeightDifference, 0.3f) /**< in percent of the expected height */
   DEFINES_PARAMETER(int, allowedDifferenceFromTop, 1) /**< Num of pixels that an obstacle is allowed to be away from the image border if the obstacle should be bigger than the image */
@@ -106,12 +108,25 @@ private:
 
   Vector2<int> searchUpward(const int x, int y, const int yEnd);
 
-  /**counts the consecutive green pixels between [pStart .. pEnd].
-   * If pStart is bigger than pEnd it is scanned backwards.
-   * Otherwise forward
+  /**Classifies the rows [yStart .. yEnd[ of column x at once and stores which of
+   * them have the color of the ground as bits in groundRows. The search methods
+   * only work on rows of the column that was classified last.
+   * @param x The column.
+   * @param yStart The first row classified. It is rounded down to a multiple of 16.
+   * @param yEnd The row after the last row classified.
    */
-  int countGreen(const Image::Pixel* pStart,const Image::Pixel* pEnd,
-                 const int widthstep);
+  void classifyColumn(const int x, int yStart, const int yEnd);
+
+  /**Counts the consecutive rows of the classified column starting at y that
+   * have (or have not) the color of the ground. Whole runs are counted by
+   * searching for the first bit that differs.
+   * @param y The first row counted.
+   * @param ground Count rows that have the color of the ground or rows that have not?
+   * @param upward Count towards the top of the image or towards the bottom?
+   * @param max The maximum number of rows counted. All of them must have been classified.
+   * @return The number of rows in the run.
+   */
+  int countRun(int y, const bool ground, const bool upward, const int max) const;
 
   /**
    * Compare measured height to expected height of a nao.
@@ -128,8 +143,8 @@ private:
   inline bool checkHeight(const int height, const int expectedHeight);
 
 
-  /**Check if the specified pixel belongs to the ground*/
-  inline bool isGroundColor(const Image::Pixel* pPixel) const;
+  /**Check if the specified row of the classified column belongs to the ground*/
+  bool isGroundRow(const int y) const {return (groundRows[y >> 6] >> (y & 63) & 1) != 0;}
 
   /**In most cases it is not possible to do a robot height sanity check if obstacles
    * are detected in the lower image. Those spots are buffered and handled by this
@@ -206,11 +221,17 @@ private:
      camera.*/
   std::vector<BufferedSpot> spotBuffer;
   int lastFrameImageHeight; /**< stores the camera image height from one frame before */
+  int scaledNonGreenCount; /**< The nonGreenCount converted to the resolution of the current image. */
 
   /**Contains spots that might be obstacles. In image coordinates*/
   std::list<Vector2<int> > possibleSpots;
   /** counter used to remember that we saw a spot in the lower image a few frames ago :)*/
   int sawSpotsInLowerCamLastFrame;
 
+  unsigned char columnColors[maxResolutionHeight + 16]; /**< The color classes of the rows of the column classified last, padded for blocks of 16 rows. */
+  unsigned long long groundRows[(maxResolutionHeight + 63) / 64]; /**< One bit per row of the column classified last. Set if the row has the color of the ground. */
+  int classifiedStart; /**< The first row of the column classified last. */
+  int classifiedEnd; /**< The row after the last row of the column classified last. */
+
 
 };
@@ -2,21 +2,52 @@
 #include "PointExplorer.h"
 #include "Tools/Debugging/Modify.h"
 #include "Tools/Debugging/Asserts.h"
+#include <algorithm>
 
-void PointExplorer::initFrame(const Image* image, const ColorReference* colRef, int exploreStepSize, int gridStepSize, int skipOffset, int* minSegLength)
+void PointExplorer::initFrame(const Image* image, const ColorReference* colRef, const ScanGrid* scanGrid, int exploreStepSize, int gridStepSize, int skipOffset, int* minSegLength)
 {
   theImage = image;
   theColRef = colRef;
+  theScanGrid = scanGrid;
   parameters.exploreStepSize = exploreStepSize;
   parameters.gridStepSize = gridStepSize;
   parameters.skipOffset = skipOffset;
   parameters.minSegSize = minSegLength;
+  cursors.assign(scanGrid ? scanGrid->verticalLines.size() : 0, 0);
   DECLARE_DEBUG_DRAWING("module:PointExplorer:runs", "drawingOnImage");
 }
 
 ColorClasses::Color PointExplorer::getColor(const Image::Pixel* pixel)
 {
-  ColorReference::MultiColor colors = theColRef->getColorClasses(pixel);
+  return getColor(theColRef->getColorClasses(pixel));
+}
+
+ColorClasses::Color PointExplorer::getColor(int x, int y)
+{
+  const ScanGrid::Line* line = getScanline(x, y, y + 1);
+  return line ? getColor(getRun(*line, y)->getColorClasses()) : getColor((*theImage)[y] + x);
+}
+
+const ScanGrid::Line* PointExplorer::getScanline(int x, int yMin, int yMax) const
+{
+  const ScanGrid::Line* line = theScanGrid ? theScanGrid->getVerticalLine(x) : 0;
+  return line && line->from <= yMin && yMax <= line->to && yMin < yMax ? line : 0;
+}
+
+const ScanGrid::Run* PointExplorer::getRun(const ScanGrid::Line& line, int y)
+{
+  ASSERT(line.isInside(y));
+  const ScanGrid::Run*& cursor = cursors[&line - theScanGrid->verticalLines.data()];
+  if(!cursor || cursor->from > y)
+    cursor = theScanGrid->getRun(line, y);
+  else
+    while(cursor->to <= y)
+      ++cursor;
+  return cursor;
+}
+
+ColorClasses::Color PointExplorer::getColor(ColorReference::MultiColor colors)
+{
   if(colors.isOrange())//this order is highly recommended
     return ColorClasses::orange;
   else if(colors.isWhite())
@@ -47,7 +78,7 @@ int PointExplorer::explorePoint(int x, int y, const ColorClasses::Color col, int
       x > xMin;
       x -= parameters.exploreStepSize, pixel1 -= parameters.exploreStepSize, pixel2 -= parameters.exploreStepSize)
     {
-      if(getColor(pixel1) == col)
+      if(getColor(x, explored_min_y) == col)
       {
         const int expl_run_end = runUp(pixel1, x, explored_min_y, col, yMin, Drawings::ps_dot);
         if(expl_run_end < explored_min_y)
@@ -56,7 +87,7 @@ int PointExplorer::explorePoint(int x, int y, const ColorClasses::Color col, int
           pixel1 = (*theImage)[explored_min_y] + x;
         }
       }
-      if(getColor(pixel2) == col)
+      if(getColor(x, explored_max_y) == col)
       {
         const int expl_run_end = runDown(pixel2, x, explored_max_y, col, yEnd, Drawings::ps_dot);
         if(expl_run_end > explored_max_y)
@@ -75,6 +106,26 @@ int PointExplorer::explorePoint(int x, int y, const ColorClasses::Color col, int
 }
 
 int PointExplorer::runDown(const Image::Pixel* pixel, int x, int yStart, ColorClasses::Color col, int yEnd, Drawings::PenStyle draw)
+{
+  const ScanGrid::Line* line = getScanline(x, yStart, yEnd);
+  int y;
+  if(line)
+  {
+    y = runDown(*line, yStart, col, yEnd);
+    DEBUG_RESPONSE("module:PointExplorer:verifyRuns",
+    {
+      const int yImage = runDown(pixel, yStart, col, yEnd);
+      if(y != yImage)
+        OUTPUT_WARNING("PointExplorer: runDown at x = " << x << " from " << yStart << " to " << yEnd << " returned " << y << " instead of " << yImage);
+    });
+  }
+  else
+    y = runDown(pixel, yStart, col, yEnd);
+  LINE("module:PointExplorer:runs", x, yStart, x, y, 0, draw, getOnFieldDrawColor(col));
+  return y;
+}
+
+int PointExplorer::runDown(const Image::Pixel* pixel, int yStart, ColorClasses::Color col, int yEnd)
 {
   int y = yStart;
   int tmp;
@@ -103,7 +154,6 @@ int PointExplorer::runDown(const Image::Pixel* pixel, int x, int yStart, ColorCl
   {
     y = yEnd;
   }
-  LINE("module:PointExplorer:runs", x, yStart, x, y, 0, draw, getOnFieldDrawColor(col));
   return y;
 }
 
@@ -141,6 +191,26 @@ int PointExplorer::findDown(const Image::Pixel* pixel, int x, int yStart, ColorC
 }
 
 int PointExplorer::runUp(const Image::Pixel* pixel,int x, int yStart, ColorClasses::Color col, int yEnd, Drawings::PenStyle draw)
+{
+  const ScanGrid::Line* line = getScanline(x, std::max(yEnd, 0), yStart + 1);
+  int y;
+  if(line)
+  {
+    y = runUp(*line, yStart, col, yEnd);
+    DEBUG_RESPONSE("module:PointExplorer:verifyRuns",
+    {
+      const int yImage = runUp(pixel, yStart, col, yEnd);
+      if(y != yImage)
+        OUTPUT_WARNING("PointExplorer: runUp at x = " << x << " from " << yStart << " to " << yEnd << " returned " << y << " instead of " << yImage);
+    });
+  }
+  else
+    y = runUp(pixel, yStart, col, yEnd);
+  LINE("module:PointExplorer:runs", x, yStart, x, y, 0, draw, getOnFieldDrawColor(col));
+  return y;
+}
+
+int PointExplorer::runUp(const Image::Pixel* pixel, int yStart, ColorClasses::Color col, int yEnd)
 {
   int y = yStart;
   int tmp;
@@ -169,6 +239,49 @@ int PointExplorer::runUp(const Image::Pixel* pixel,int x, int yStart, ColorClass
   {
     y = yEnd;
   }
-  LINE("module:PointExplorer:runs", x, yStart, x, y, 0, draw, getOnFieldDrawColor(col));
+  return y;
+}
+
+int PointExplorer::runDown(const ScanGrid::Line& line, int yStart, ColorClasses::Color col, int yEnd)
+{
+  // The run ends at the first gap of at least skipOffset pixels with another color.
+  // The image version only samples every skipOffset-th pixel before yEnd, so it
+  // cannot find a gap that starts less than skipOffset pixels before yEnd and
+  // returns yEnd instead. The last condition reproduces this.
+  const ScanGrid::Run* run = getRun(line, yStart);
+  const ScanGrid::Run* end = theScanGrid->end(line);
+  int y = getColor(run->getColorClasses()) == col ? run->to : yStart + 1;
+  for(++run; run != end && run->from < yEnd; ++run)
+    if(getColor(run->getColorClasses()) == col)
+    {
+      if(run->from - y >= parameters.skipOffset)
+        break;
+      y = run->to;
+    }
+  if(y > yEnd || yEnd - y < parameters.skipOffset)
+  {
+    y = yEnd;
+  }
+  return y;
+}
+
+int PointExplorer::runUp(const ScanGrid::Line& line, int yStart, ColorClasses::Color col, int yEnd)
+{
+  // As in runDown, a gap that starts less than skipOffset pixels after yEnd is not found.
+  const ScanGrid::Run* begin = theScanGrid->begin(line);
+  const ScanGrid::Run* run = getRun(line, yStart);
+  int y = getColor(run->getColorClasses()) == col ? run->from : yStart;
+  while(run != begin && (--run)->to > yEnd)
+    if(getColor(run->getColorClasses()) == col)
+    {
+      if(y - run->to >= parameters.skipOffset)
+        break;
+      y = run->from;
+    }
+  --y; // the first pixel before the run
+  if(y < yEnd || y - yEnd < parameters.skipOffset)
+  {
+    y = yEnd;
+  }
   return y;
 }
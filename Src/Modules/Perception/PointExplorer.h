@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Representations/Perception/ColorReference.h"
+#include "Representations/Perception/ScanGrid.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Tools/Debugging/DebugDrawings.h"
 
@@ -14,6 +15,8 @@
  * a scanline but "explores" a scanline(segment). It runs throught the image
  * and additionally to the normal run functions it also takes the space between
  * the actual scanline and the last into account.
+ * If a scan grid is given, runs on its vertical scanlines are followed using the
+ * precomputed runs instead of looking up the color of each pixel again.
  */
 class PointExplorer
 {
@@ -22,12 +25,13 @@ public:
    * Initialize the PointExplorer for a frame. Pass the ColorTable, the Image and some parameters.
    * @param image theImage Representation of the frame
    * @param colRef theColorReference Representation
+   * @param scanGrid theScanGrid Representation or 0 if all pixels should be classified here
    * @param exploreStepSize the distance in pixels between the explore scanlines
    * @param gridStepSize the distance in pixels between (normal) scanlines
    * @param skipOffset the amount of pixels allowed to skip in a run
    * @param minSegLength a array giving holding the minimum segment size for each color
    */
-  void initFrame(const Image* image, const ColorReference* colRef, int exploreStepSize, int gridStepSize, int skipOffset, int* minSegLength);
+  void initFrame(const Image* image, const ColorReference* colRef, const ScanGrid* scanGrid, int exploreStepSize, int gridStepSize, int skipOffset, int* minSegLength);
 
   /**
    * Run down from (x,y) unless there is a run of skipOffset pixels with color != col.
@@ -95,10 +99,61 @@ public:
    */
   ColorClasses::Color getColor(const Image::Pixel* pixel);
 
+  /**
+   * Returns the ColorClass of the pixel at (x,y). The scan grid is used if it contains the pixel.
+   * @param x x-coordinate of the pixel
+   * @param y y-coordinate of the pixel
+   * @return the color of the pixel
+   */
+  ColorClasses::Color getColor(int x, int y);
+
+  /**
+   * Maps the color classes of a pixel to the single color class used by the PointExplorer.
+   * @param colors the color classes
+   * @return the color
+   */
+  static ColorClasses::Color getColor(ColorReference::MultiColor colors);
+
   const Image* theImage; /**< a pointer to the image Representation */
   const ColorReference* theColRef;
+  const ScanGrid* theScanGrid; /**< a pointer to the scan grid Representation, may be 0 */
 
 private:
+  /**
+   * Returns the vertical scanline of the scan grid at x if it contains all pixels from yMin to yMax.
+   * @param x x-coordinate of the scanline
+   * @param yMin the minimal y-coordinate that must be covered
+   * @param yMax the maximal y-coordinate that must be covered (exclusive)
+   * @return the scanline or 0 if the pixels must be classified using the image
+   */
+  const ScanGrid::Line* getScanline(int x, int yMin, int yMax) const;
+
+  /**
+   * Returns the run of a vertical scan grid scanline that contains a certain pixel.
+   * The scanlines are mostly processed from top to bottom, so the search continues
+   * from the run found last on the same scanline if possible.
+   * @param line the vertical scanline
+   * @param y y-coordinate of the pixel, must be inside the scanline
+   * @return the run
+   */
+  const ScanGrid::Run* getRun(const ScanGrid::Line& line, int y);
+
+  /** runDown on the pixels of the image. Parameters as for runDown. */
+  int runDown(const Image::Pixel* pixel, int yStart, ColorClasses::Color col, int yEnd);
+
+  /** runUp on the pixels of the image. Parameters as for runUp. */
+  int runUp(const Image::Pixel* pixel, int yStart, ColorClasses::Color col, int yEnd);
+
+  /**
+   * runDown on the runs of a scan grid scanline. Parameters as for runDown.
+   * The result is the same as the one of the image version, which can be
+   * checked with the debug response "module:PointExplorer:verifyRuns".
+   */
+  int runDown(const ScanGrid::Line& line, int yStart, ColorClasses::Color col, int yEnd);
+
+  /** runUp on the runs of a scan grid scanline. Parameters as for runUp. */
+  int runUp(const ScanGrid::Line& line, int yStart, ColorClasses::Color col, int yEnd);
+
   /**
    * @class Parameters
    * Internal parameters for the PointExplorer.
@@ -113,4 +168,6 @@ private:
   };
   Parameters parameters;
 
+  std::vector<const ScanGrid::Run*> cursors; /**< The run found last on each vertical scanline of the scan grid (or 0). */
+
 };
@@ -251,4 +251,4 @@ void PossibleObstacleSpotProvider::calculateNonGreenRowCount()
   }
 }
 
-MAKE_MODULE(PossibleObstacleSpotProvider, Perception)
+MAKE_PURE_CONCURRENT_MODULE(PossibleObstacleSpotProvider, Perception)
@@ -0,0 +1,32 @@
+/**
+* @file ProjectionGridProvider.cpp
+* This file implements a module that computes the rays through a sparse grid of
+* image points once per frame, so that image points can be projected to the
+* field by interpolation.
+*/
+
+#include "ProjectionGridProvider.h"
+
+void ProjectionGridProvider::update(ProjectionGrid& projectionGrid)
+{
+  // The grid covers the whole image, i.e. the last nodes may lie outside.
+  projectionGrid.spacing = spacing;
+  projectionGrid.columns = (theCameraInfo.width + spacing - 1) / spacing + 1;
+  projectionGrid.rows = (theCameraInfo.height + spacing - 1) / spacing + 1;
+  projectionGrid.rays.resize(projectionGrid.columns * projectionGrid.rows);
+  projectionGrid.cameraPosition = theCameraMatrix.translation;
+  projectionGrid.maxRayZ = -5.f * theCameraInfo.focalLengthInv;
+  projectionGrid.maxDistance = maxDistance;
+
+  Vector3<>* ray = projectionGrid.rays.data();
+  for(int y = 0; y < projectionGrid.rows; ++y)
+    for(int x = 0; x < projectionGrid.columns; ++x)
+    {
+      const Vector2<> corrected = theImageCoordinateSystem.toCorrected(Vector2<>(float(x * spacing), float(y * spacing)));
+      *ray++ = theCameraMatrix.rotation * Vector3<>(1.f,
+                                                    (theCameraInfo.opticalCenter.x - corrected.x) * theCameraInfo.focalLengthInv,
+                                                    (theCameraInfo.opticalCenter.y - corrected.y) * theCameraInfo.focalLengthInv);
+    }
+}
+
+MAKE_MODULE(ProjectionGridProvider, Perception)
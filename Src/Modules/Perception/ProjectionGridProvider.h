@@ -0,0 +1,28 @@
+/**
+* @file ProjectionGridProvider.h
+* This file declares a module that computes the rays through a sparse grid of
+* image points once per frame, so that image points can be projected to the
+* field by interpolation.
+*/
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Perception/CameraMatrix.h"
+#include "Representations/Perception/ImageCoordinateSystem.h"
+#include "Representations/Perception/ProjectionGrid.h"
+
+MODULE(ProjectionGridProvider)
+  REQUIRES(CameraInfo)
+  REQUIRES(CameraMatrix)
+  REQUIRES(ImageCoordinateSystem)
+  PROVIDES_WITH_MODIFY(ProjectionGrid)
+  DEFINES_PARAMETER(int, spacing, 32) /**< The distance between two neighboring nodes in pixels. */
+  DEFINES_PARAMETER(float, maxDistance, 12764.f) /**< The maximum x and y coordinate of points on the field (as in Geometry). */
+END_MODULE
+
+class ProjectionGridProvider : public ProjectionGridProviderBase
+{
+  void update(ProjectionGrid& projectionGrid);
+};
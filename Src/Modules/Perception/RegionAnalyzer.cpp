@@ -35,6 +35,7 @@ void RegionAnalyzer::update(LineSpots& otherLineSpots)
 
 int RegionAnalyzer::getGreenBelow(const RegionPercept::Region* region)
 {
+  const int maxGreySkip = scaled(maxLineNghbGreySkip);
   int greenBelow = 0;
   for(vector<RegionPercept::Segment*>::const_iterator child = region->children.begin(); child != region->children.end(); child++)
   {
@@ -54,7 +55,7 @@ int RegionAnalyzer::getGreenBelow(const RegionPercept::Region* region)
     {
       //implicit due to the if condition and the while condition
       //if(next->color == ColorClasses::green)
-      if(next->y - childEndY <= maxLineNghbGreySkip)
+      if(next->y - childEndY <= maxGreySkip)
       {
         greenBelow += next->length;
         LINE("module:RegionAnalyzer:greenBelow", next->x, next->y, next->x, next->y + next->length, 0, Drawings::ps_solid, ColorClasses::green);
@@ -67,6 +68,7 @@ int RegionAnalyzer::getGreenBelow(const RegionPercept::Region* region)
 
 int RegionAnalyzer::getGreenAbove(const RegionPercept::Region* region)
 {
+  const int maxGreySkip = scaled(maxLineNghbGreySkip);
   int greenAbove = 0;
   for(vector<RegionPercept::Segment*>::const_iterator child = region->children.begin(); child != region->children.end(); child++)
   {
@@ -86,7 +88,7 @@ int RegionAnalyzer::getGreenAbove(const RegionPercept::Region* region)
     if(next->color == ColorClasses::green && next->x == (*child)->x)
     {
       //if(next->color == ColorClasses::green)
-      if((*child)->y - (next->y + next->length) <= maxLineNghbGreySkip)
+      if((*child)->y - (next->y + next->length) <= maxGreySkip)
       {
         greenAbove += next->length;
         LINE("module:RegionAnalyzer:greenAbove", next->x, next->y, next->x, (*child)->y, 0, Drawings::ps_solid, ColorClasses::blue);
@@ -202,15 +204,21 @@ int RegionAnalyzer::getGreenLeft(const RegionPercept::Region* region)
 
 bool RegionAnalyzer::isLine(const RegionPercept::Region* region, float& direction, LineSpots::LineSpot& spot)
 {
+  const int minSize = scaledArea(minLineSize),
+            minSingleSegmentSize = scaledArea(minLineSingleSegmentSize),
+            maxNghbNoneSize = scaledArea(maxLineNghbNoneSize),
+            minNghbGreenAboveSize = scaled(minLineNghbGreenAboveSize),
+            minNghbGreenBelowSize = scaled(minLineNghbGreenBelowSize),
+            minNghbGreenSideSize = scaled(minLineNghbGreenSideSize);
   bool ret = true;
-  if(region->size < minLineSize ||
+  if(region->size < minSize ||
      (region->children.size() < (size_t) minLineSegmentCount &&
-      region->size < minLineSingleSegmentSize))
+      region->size < minSingleSegmentSize))
   {
     COMPLEX_DRAWING("module:RegionAnalyzer:Line",
     {
       Vector2<int> c = region->getCenter();
-      if(region->size < minLineSize)
+      if(region->size < minSize)
       {
         DRAWTEXT("module:RegionAnalyzer:Line", c.x, c.y, 150, ColorClasses::black, region->size << "<s");
       }
@@ -234,13 +242,13 @@ bool RegionAnalyzer::isLine(const RegionPercept::Region* region, float& directio
     }
   }
 
-  if(neighborNoneSize > maxLineNghbNoneSize ||
+  if(neighborNoneSize > maxNghbNoneSize ||
      ((float) neighborNoneSize / region->size) > maxLineNghbNoneRatio)
   {
     COMPLEX_DRAWING("module:RegionAnalyzer:Line",
     {
       Vector2<int> c = region->getCenter();
-      if(neighborNoneSize > maxLineNghbNoneSize)
+      if(neighborNoneSize > maxNghbNoneSize)
       {
         DRAWTEXT("module:RegionAnalyzer:Line", c.x + 3, c.y - 5, 150, ColorRGBA(255, 0, 0), neighborNoneSize);
         ARROW("module:RegionAnalyzer:Line", c.x, c.y, c.x, c.y - 5, 0, Drawings::ps_solid, ColorRGBA(255, 0, 0));
@@ -294,17 +302,17 @@ bool RegionAnalyzer::isLine(const RegionPercept::Region* region, float& directio
     int greenLeftSize = getGreenLeft(region);
     int greenRightSize = getGreenRight(region);
 
-    if(greenLeftSize < minLineNghbGreenSideSize || greenRightSize < minLineNghbGreenSideSize)
+    if(greenLeftSize < minNghbGreenSideSize || greenRightSize < minNghbGreenSideSize)
     {
       COMPLEX_DRAWING("module:RegionAnalyzer:Line",
       {
         Vector2<int> c = region->getCenter();
-        if(greenLeftSize < minLineNghbGreenSideSize)
+        if(greenLeftSize < minNghbGreenSideSize)
         {
           ARROW("module:RegionAnalyzer:Line", c.x, c.y, c.x - 5, c.y, 0, Drawings::ps_solid, ColorClasses::green);
           DRAWTEXT("module:RegionAnalyzer:Line", c.x - 3, c.y + 5, 150, ColorClasses::black, greenLeftSize);
         }
-        if(greenRightSize < minLineNghbGreenSideSize)
+        if(greenRightSize < minNghbGreenSideSize)
         {
           ARROW("module:RegionAnalyzer:Line", c.x, c.y, c.x + 5, c.y, 0, Drawings::ps_solid, ColorClasses::green);
           DRAWTEXT("module:RegionAnalyzer:Line", c.x + 3, c.y - 5, 150, ColorClasses::black, greenRightSize);
@@ -318,18 +326,18 @@ bool RegionAnalyzer::isLine(const RegionPercept::Region* region, float& directio
     int greenAboveSize = getGreenAbove(region);
     int greenBelowSize = getGreenBelow(region);
 
-    if(greenAboveSize < minLineNghbGreenAboveSize ||
-       greenBelowSize < minLineNghbGreenBelowSize)
+    if(greenAboveSize < minNghbGreenAboveSize ||
+       greenBelowSize < minNghbGreenBelowSize)
     {
       COMPLEX_DRAWING("module:RegionAnalyzer:Line",
       {
         Vector2<int> c = region->getCenter();
-        if(greenAboveSize < minLineNghbGreenAboveSize)
+        if(greenAboveSize < minNghbGreenAboveSize)
         {
           ARROW("module:RegionAnalyzer:Line", c.x, c.y, c.x, c.y - 5, 0, Drawings::ps_solid, ColorClasses::green);
           DRAWTEXT("module:RegionAnalyzer:Line", c.x + 3, c.y - 5, 150, ColorClasses::green, greenAboveSize);
         }
-        if(greenBelowSize < minLineNghbGreenBelowSize)
+        if(greenBelowSize < minNghbGreenBelowSize)
         {
           ARROW("module:RegionAnalyzer:Line", c.x, c.y - 5, c.x, c.y, 0, Drawings::ps_solid, ColorClasses::green);
           DRAWTEXT("module:RegionAnalyzer:Line", c.x + 3, c.y - 5, 150, ColorClasses::green, greenBelowSize);
@@ -395,6 +403,7 @@ bool RegionAnalyzer::isLine(const RegionPercept::Region* region, float& directio
 
 void RegionAnalyzer::analyzeRegions()
 {
+  const int minRobotSize = scaledArea(minRobotRegionSize);
   LineSpots::LineSpot lineSpot;
 
   for(const RegionPercept::Region* region = theRegionPercept.regions; region - theRegionPercept.regions < theRegionPercept.regionsCounter; region++)
@@ -426,7 +435,7 @@ void RegionAnalyzer::analyzeRegions()
           while(lineSpot.alpha < -pi)
             lineSpot.alpha += 2 * pi;
 
-          if(region->size > minRobotRegionSize && abs(abs(lineSpot.alpha) - pi_2) < maxRobotRegionAlphaDiff && lineSpot.alphaLen / lineSpot.alphaLen2 > minRobotWidthRatio)
+          if(region->size > minRobotSize && abs(abs(lineSpot.alpha) - pi_2) < maxRobotRegionAlphaDiff && lineSpot.alphaLen / lineSpot.alphaLen2 > minRobotWidthRatio)
           {
             Vector2<int> c = lineSpot.p1.y > lineSpot.p2.y ? lineSpot.p1 : lineSpot.p2;//region->getCenter();
             Vector2<int> c2 = lineSpot.p1.y > lineSpot.p2.y ? lineSpot.p2 : lineSpot.p1;//region->getCenter();
@@ -444,4 +453,4 @@ void RegionAnalyzer::analyzeRegions()
     }
   }
 }
-MAKE_MODULE(RegionAnalyzer, Perception)
+MAKE_CONCURRENT_MODULE(RegionAnalyzer, Perception)
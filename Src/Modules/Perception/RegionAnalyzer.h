@@ -7,6 +7,8 @@
 #pragma once
 
 #include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/RegionPercept.h"
 #include "Representations/Perception/LineSpots.h"
@@ -14,20 +16,22 @@
 
 MODULE(RegionAnalyzer)
   REQUIRES(CameraMatrix)
+  REQUIRES(CameraInfo)
+  REQUIRES(ProcessingResolution)
   REQUIRES(RegionPercept)
   PROVIDES_WITH_MODIFY_AND_DRAW(BallSpots)
   REQUIRES(BallSpots)
   PROVIDES_WITH_MODIFY_AND_DRAW(LineSpots)
-  LOADS_PARAMETER(int, minLineSize) /**< The minimum size of a line region */
+  LOADS_PARAMETER(int, minLineSize) /**< The minimum size of a line region (in pixels at full resolution) */
   LOADS_PARAMETER(int, minLineSegmentCount) /**< The minimum number of segments for a line regions */
-  LOADS_PARAMETER(int, maxLineNghbNoneSize) /**< The maximum size of neighboring none colored regions for a line region */
-  LOADS_PARAMETER(int, minLineNghbGreenAboveSize) /**< The minimum summed size of green segments above a line region */
-  LOADS_PARAMETER(int, minLineNghbGreenBelowSize) /**< The minimum summed size of green segments below a line region */
-  LOADS_PARAMETER(int, minLineNghbGreenSideSize) /**< The minimum summed size of green segments on each side of a line region */
-  LOADS_PARAMETER(int, minLineSingleSegmentSize) /**< The minimum size a region needs to be a line if the minLineSegmentCount criterion is not met */
+  LOADS_PARAMETER(int, maxLineNghbNoneSize) /**< The maximum size of neighboring none colored regions for a line region (in pixels at full resolution) */
+  LOADS_PARAMETER(int, minLineNghbGreenAboveSize) /**< The minimum summed length of green segments above a line region (in pixels at full resolution) */
+  LOADS_PARAMETER(int, minLineNghbGreenBelowSize) /**< The minimum summed length of green segments below a line region (in pixels at full resolution) */
+  LOADS_PARAMETER(int, minLineNghbGreenSideSize) /**< The minimum summed length of green segments on each side of a line region (in pixels at full resolution) */
+  LOADS_PARAMETER(int, minLineSingleSegmentSize) /**< The minimum size a region needs to be a line if the minLineSegmentCount criterion is not met (in pixels at full resolution) */
   LOADS_PARAMETER(float, maxLineNghbNoneRatio) /**< The maximum ratio of none neighbor regions for a line region */
-  LOADS_PARAMETER(int, maxLineNghbGreySkip) /**< The maximal amount of pixels skip to find some green above/below/aside a white region */
-  LOADS_PARAMETER(int, minRobotRegionSize) /**< The minimum region size for a white region to become nonLineSpot */
+  LOADS_PARAMETER(int, maxLineNghbGreySkip) /**< The maximal amount of pixels skip to find some green above/below/aside a white region (at full resolution) */
+  LOADS_PARAMETER(int, minRobotRegionSize) /**< The minimum region size for a white region to become nonLineSpot (in pixels at full resolution) */
   LOADS_PARAMETER(float, maxRobotRegionAlphaDiff) /**< The maximum angle offset a white region can have from upright to become a nonLineSpot */
   LOADS_PARAMETER(float, minRobotWidthRatio) /**< The minimum height/width ratio a white regions needs to become nonLineSpot */
 END_MODULE
@@ -43,6 +47,22 @@ private:
   LineSpots* lineSpots; /**< The linespots found. */
   BallSpots* ballSpots;
 
+  /**
+  * The method converts a length given in pixels at full resolution into the
+  * resolution of the current image.
+  * @param pixels The length.
+  * @return The length at the processing resolution.
+  */
+  int scaled(int pixels) const {return theProcessingResolution.scale(pixels, theCameraInfo.camera);}
+
+  /**
+  * The method converts a region size given in pixels at full resolution into
+  * the resolution of the current image.
+  * @param pixels The size.
+  * @return The size at the processing resolution.
+  */
+  int scaledArea(int pixels) const {return theProcessingResolution.scaleArea(pixels, theCameraInfo.camera);}
+
   /** update the LineSpots Representation */
   void update(LineSpots& otherLineSpots);
 
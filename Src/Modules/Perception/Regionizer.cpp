@@ -18,8 +18,14 @@ Regionizer::Regionizer()
 
 void Regionizer::update(RegionPercept& rPercept)
 {
+  ASSERT(theScanGrid.lineDistance > 0);
+  gridStepSize = 2 * theScanGrid.lineDistance;
+  scaledSkipOffset = theProcessingResolution.scale(skipOffset, theCameraInfo.camera);
+  for(int i = 0; i < ColorClasses::numOfColors; ++i)
+    scaledMinSegSize[i] = theProcessingResolution.scale(minSegSize[i], theCameraInfo.camera);
   regionPercept = &rPercept;
-  pointExplorer.initFrame(&theImage, &theColorReference, exploreStepSize, gridStepSize, skipOffset, minSegSize);
+  pointExplorer.initFrame(&theImage, &theColorReference, &theScanGrid, theProcessingResolution.scale(exploreStepSize, theCameraInfo.camera),
+                          gridStepSize, scaledSkipOffset, scaledMinSegSize);
   regionPercept->segmentsCounter = 0;
   regionPercept->regionsCounter = 0;
   regionPercept->gridStepSize = gridStepSize;
@@ -31,12 +37,14 @@ void Regionizer::update(RegionPercept& rPercept)
 bool Regionizer::uniteRegions(RegionPercept::Segment* seg1, RegionPercept::Segment* seg2)
 {
   ASSERT(seg1->region);
+  RegionPercept::Region* region1 = getRegion(seg1);
+  const int index1 = (int) (region1 - regionPercept->regions);
   //we want straight white regions (lines) so don't unite white regions which would not be straight
   const ColorClasses::Color segCol = seg1->color;
   if(segCol == ColorClasses::white)
   {
-    ASSERT(seg1->region->children.size() >= 1);
-    if(seg1->region->children.at(seg1->region->children.size() - 1)->x == seg2->x)
+    ASSERT(childrenCount[index1] >= 1);
+    if(lastChild[index1]->x == seg2->x)
     {
       return false;
     }
@@ -58,25 +66,24 @@ bool Regionizer::uniteRegions(RegionPercept::Segment* seg1, RegionPercept::Segme
   //seg1 always has a region
   if(!seg2->region)
   {
-    RegionPercept::Segment* sWithRegion = seg1,
-                          * sWithoutRegion = seg2;
-    if((int)sWithRegion->region->children.size() < regionMaxSize)
+    if(childrenCount[index1] < regionMaxSize)
     {
-      sWithRegion->region->children.push_back(sWithoutRegion);
-      sWithoutRegion->region = sWithRegion->region;
-      sWithRegion->region->size += sWithoutRegion->explored_size;
-      if(sWithoutRegion->y < sWithRegion->region->min_y)
+      // seg2 is the latest segment, so it is the last one in the region
+      ++childrenCount[index1];
+      lastChild[index1] = seg2;
+      seg2->region = region1;
+      region1->size += seg2->explored_size;
+      if(seg2->y < region1->min_y)
       {
-        sWithRegion->region->min_y = sWithoutRegion->y;
+        region1->min_y = seg2->y;
       }
-      if(sWithoutRegion->y + sWithoutRegion->length > sWithRegion->region->max_y)
+      if(seg2->y + seg2->length > region1->max_y)
       {
-        sWithRegion->region->max_y = sWithoutRegion->y + sWithoutRegion->length;
+        region1->max_y = seg2->y + seg2->length;
       }
       seg2->link = seg1;
       return true;
     }
-    ASSERT(seg1->region == seg2->region || !seg2->region);
   }
   //both segments already have a region
   else
@@ -84,12 +91,10 @@ bool Regionizer::uniteRegions(RegionPercept::Segment* seg1, RegionPercept::Segme
     //don't unite two white regions (since we want straight white regions -> lines)
     if(segCol != ColorClasses::white)
     {
-      if(seg1->region != seg2->region && ((int)(seg1->region->children.size() + seg2->region->children.size()) < regionMaxSize))
+      RegionPercept::Region* region2 = getRegion(seg2);
+      if(region1 != region2 && childrenCount[index1] + childrenCount[region2 - regionPercept->regions] < regionMaxSize)
       {
-        RegionPercept::Region* oldRegion = seg2->region;
-        seg1->region->mergeWithRegion(seg2->region);
-        oldRegion->children.clear();
-        oldRegion->root = seg1->region;
+        mergeRegions(region1, region2);
         seg2->link = seg1;
         return true;
       }
@@ -98,6 +103,64 @@ bool Regionizer::uniteRegions(RegionPercept::Segment* seg1, RegionPercept::Segme
   return false;
 }
 
+int Regionizer::find(int index)
+{
+  int root = index;
+  while(parent[root] != root)
+  {
+    root = parent[root];
+  }
+  while(parent[index] != root)
+  {
+    const int next = parent[index];
+    parent[index] = root;
+    index = next;
+  }
+  return root;
+}
+
+RegionPercept::Region* Regionizer::getRegion(RegionPercept::Segment* seg)
+{
+  ASSERT(seg->region);
+  seg->region = regionPercept->regions + owner[find((int) (seg->region - regionPercept->regions))];
+  return seg->region;
+}
+
+void Regionizer::mergeRegions(RegionPercept::Region* region, RegionPercept::Region* other)
+{
+  const int index = (int) (region - regionPercept->regions),
+            otherIndex = (int) (other - regionPercept->regions);
+  int root = find(index),
+      otherRoot = find(otherIndex);
+  ASSERT(owner[root] == index && owner[otherRoot] == otherIndex);
+
+  // union by rank, but the data always stays in "region"
+  if(rank[root] < rank[otherRoot])
+  {
+    std::swap(root, otherRoot);
+  }
+  else if(rank[root] == rank[otherRoot])
+  {
+    ++rank[root];
+  }
+  parent[otherRoot] = root;
+  owner[root] = index;
+
+  childrenCount[index] += childrenCount[otherIndex];
+  lastChild[index] = std::max(lastChild[index], lastChild[otherIndex]);
+  region->size += other->size;
+  region->neighborRegions.insert(region->neighborRegions.end(), other->neighborRegions.begin(), other->neighborRegions.end());
+  if(other->min_y < region->min_y)
+  {
+    region->min_y = other->min_y;
+  }
+  if(other->max_y > region->max_y)
+  {
+    region->max_y = other->max_y;
+  }
+  other->root = region;
+}
+
 inline RegionPercept::Segment* Regionizer::addSegment(int x, int y, int length, ColorClasses::Color color)
 {
   if(!(regionPercept->segmentsCounter < MAX_SEGMENTS_COUNT - 1))
@@ -152,14 +215,14 @@ RegionPercept::Segment* Regionizer::connectToRegions(RegionPercept::Segment* new
       {
         if(!uniteRegions(lastColumPointer, newSegment))
         {
-          neighborRegions.push_back(lastColumPointer->region);
+          neighborRegions.push_back(getRegion(lastColumPointer));
         }
       }
       else
       {
         if(lastColumPointer->region)
         {
-          neighborRegions.push_back(lastColumPointer->region);
+          neighborRegions.push_back(getRegion(lastColumPointer));
         }
       }
     }
@@ -192,14 +255,14 @@ RegionPercept::Segment* Regionizer::connectToRegions(RegionPercept::Segment* new
       {
         if(!uniteRegions(tmpLastColumPointer, newSegment))
         {
-          neighborRegions.push_back(tmpLastColumPointer->region);
+          neighborRegions.push_back(getRegion(tmpLastColumPointer));
         }
       }
       else
       {
         if(tmpLastColumPointer->region)
         {
-          neighborRegions.push_back(tmpLastColumPointer->region);
+          neighborRegions.push_back(getRegion(tmpLastColumPointer));
         }
       }
     }
@@ -216,11 +279,11 @@ RegionPercept::Segment* Regionizer::connectToRegions(RegionPercept::Segment* new
       return NULL;
     }
   }
+  RegionPercept::Region* region = getRegion(newSegment);
   for(std::vector<RegionPercept::Region*>::iterator nb_reg = neighborRegions.begin(); nb_reg != neighborRegions.end(); nb_reg++)
   {
-    ASSERT(newSegment->region);
-    (*nb_reg)->neighborRegions.push_back(newSegment->region);
-    newSegment->region->neighborRegions.push_back(*nb_reg);
+    (*nb_reg)->neighborRegions.push_back(region);
+    region->neighborRegions.push_back(*nb_reg);
   }
   return lastColumPointer;
 }
@@ -229,7 +292,13 @@ bool Regionizer::createNewRegionForSegment(RegionPercept::Segment* seg)
 {
   if(regionPercept->regionsCounter < MAX_REGIONS_COUNT)
   {
-    seg->region = regionPercept->regions + regionPercept->regionsCounter++;
+    const int index = regionPercept->regionsCounter++;
+    parent[index] = index;
+    rank[index] = 0;
+    owner[index] = index;
+    childrenCount[index] = 1;
+    lastChild[index] = seg;
+    seg->region = regionPercept->regions + index;
     seg->region->color = seg->color;
     seg->region->children.clear();
     seg->region->neighborRegions.clear();
@@ -237,7 +306,6 @@ bool Regionizer::createNewRegionForSegment(RegionPercept::Segment* seg)
     seg->region->max_y = seg->y + seg->length;
     seg->region->root = NULL;
     seg->region->size = seg->explored_size;
-    seg->region->children.push_back(seg);
     return true;
   }
   return false;
@@ -280,9 +348,9 @@ void Regionizer::buildRegions()
     }
     if(lastSegment != NULL)
     {
-      if(newSegment-> y - (lastSegment->y + lastSegment->length) < skipOffset)
+      if(newSegment-> y - (lastSegment->y + lastSegment->length) < scaledSkipOffset)
       {
-        lastSegment->region->neighborRegions.push_back(newSegment->region);
+        getRegion(lastSegment)->neighborRegions.push_back(getRegion(newSegment));
         newSegment->region->neighborRegions.push_back(lastSegment->region);
       }
       else
@@ -294,6 +362,15 @@ void Regionizer::buildRegions()
     lastSegment = newSegment;
     lastx = newSegment->x;
   }
+
+  // the segments array is sorted by x and y, so the children of each region are as well
+  for(RegionPercept::Segment* seg = regionPercept->segments; seg < regionPercept->segments + regionPercept->segmentsCounter; ++seg)
+  {
+    if(seg->region)
+    {
+      getRegion(seg)->children.push_back(seg);
+    }
+  }
 }
 
 void Regionizer::scanVertically()
@@ -321,10 +398,24 @@ void Regionizer::scanVertically()
     fBoundary = theFieldBoundary.getBoundaryY(x) - 1; // -1 is the tolerance
     theBodyContour.clipBottom(x, yEnd);
     y = yStart = std::max(yHorizon, fBoundary);
+
+    // The colors are taken from the runs of the scan grid, which are followed
+    // from top to bottom. Only if the scan grid does not cover the scanline,
+    // the pixels are classified by the point explorer.
+    const ScanGrid::Line* line = theScanGrid.getVerticalLine(x);
+    const ScanGrid::Run* run = line && line->from <= yStart && yEnd <= line->to && yStart < yEnd ? theScanGrid.getRun(*line, yStart) : 0;
+    auto getColor = [&]() -> ColorClasses::Color
+    {
+      if(!run || y >= line->to)
+        return pointExplorer.getColor(x, y);
+      while(run->to <= y)
+        ++run;
+      return PointExplorer::getColor(run->getColorClasses());
+    };
+
     while(y < yEnd)
     {
-      const Image::Pixel* pixel = theImage[y] + x;
-      curColor = pointExplorer.getColor(pixel);
+      curColor = getColor();
       if(ballScanline && CameraInfo::upper == theCameraInfo.camera)
       {
         const int ballYEnd = std::min(yStart + 30, theImage.height - 1); //value 30 determined by empiric
@@ -378,12 +469,11 @@ void Regionizer::scanVertically()
           break;
         }
         y = yTemp;
-        pixel = theImage[y] + x;
-        curColor = pointExplorer.getColor(pixel);
+        curColor = getColor();
         explored_size = pointExplorer.explorePoint(x, y, curColor, std::max(0, x - gridStepSize), yEnd, y, run_end_y, explored_min_y, explored_max_y);
       }
       // end of using banZones
-      if(run_end_y - y >= minSegSize[curColor])
+      if(run_end_y - y >= scaledMinSegSize[curColor])
       {
         if(run_end_y > yStart)
         {
@@ -411,4 +501,4 @@ void Regionizer::scanVertically()
     ballScanline = !ballScanline;
   }
 }
-MAKE_MODULE(Regionizer, Perception)
+MAKE_CONCURRENT_MODULE(Regionizer, Perception)
@@ -10,12 +10,14 @@
 #include "Tools/Module/Module.h"
 #include "Tools/Math/Geometry.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
 #include "Representations/Perception/BodyContour.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
 #include "Representations/Perception/RegionPercept.h"
 #include "Representations/Perception/FieldBoundary.h"
 #include "Representations/Perception/ObstacleSpots.h"
+#include "Representations/Perception/ScanGrid.h"
 #include "PointExplorer.h"
 
 MODULE(Regionizer)
@@ -27,15 +29,16 @@ MODULE(Regionizer)
   REQUIRES(FieldBoundary)
   REQUIRES(ObstacleSpots)
   REQUIRES(CameraInfo)
+  REQUIRES(ScanGrid)
+  REQUIRES(ProcessingResolution)
   PROVIDES_WITH_MODIFY_AND_DRAW(RegionPercept)
-  LOADS_PARAMETER(int, gridStepSize) /**< The distance in pixels between neighboring scan lines. */
-  LOADS_PARAMETER(int, skipOffset) /**< The maximum number of pixels to skip when grouping pixels to segments. */
-  LOADS_PARAMETER(int[ColorClasses::numOfColors], minSegSize) /**< The minimal size/length for a segment in pixels for each color. */
+  LOADS_PARAMETER(int, skipOffset) /**< The maximum number of pixels to skip when grouping pixels to segments (at full resolution). */
+  LOADS_PARAMETER(int[ColorClasses::numOfColors], minSegSize) /**< The minimal size/length for a segment in pixels for each color (at full resolution). */
   LOADS_PARAMETER(float[ColorClasses::numOfColors], regionLengthFactor) /**< The maximal allowed factor one segment is to be longer than another when grouping to a region */
   LOADS_PARAMETER(int, regionMaxSize) /**< The maximal number of segments per region */
   LOADS_PARAMETER(float, maxAngleDiff) /**< The maximal angle difference from one segment to another.
                                         The angle is the vector from the middle of the last segment to the next one. */
-  LOADS_PARAMETER(int, exploreStepSize) /**< The distance in pixels between exploring scanlines */
+  LOADS_PARAMETER(int, exploreStepSize) /**< The distance in pixels between exploring scanlines (at full resolution) */
 END_MODULE
 
 /**
@@ -49,6 +52,20 @@ private:
   typedef std::vector<Vector2<int> >::const_iterator CI;
   RegionPercept* regionPercept; /**< internal pointer to the RegionPercept */
   PointExplorer pointExplorer; /**< PointerExplorer instance for running in the image */
+  int gridStepSize; /**< The distance in pixels between neighboring scan lines, i.e. every second vertical line of the scan grid. */
+  int scaledSkipOffset; /**< The skipOffset converted to the resolution of the current image. */
+  int scaledMinSegSize[ColorClasses::numOfColors]; /**< The minSegSize converted to the resolution of the current image. */
+
+  /**
+   * The regions are merged using a union-find structure over the indices of the regions
+   * in the RegionPercept. The region that holds the data of a set is not necessarily the
+   * root of the set, because the region of the first segment always survives a merge.
+   */
+  int parent[MAX_REGIONS_COUNT]; /**< The parent of each region in the union-find structure. */
+  int rank[MAX_REGIONS_COUNT]; /**< An upper bound for the height of each set in the union-find structure. */
+  int owner[MAX_REGIONS_COUNT]; /**< For the root of each set, the region that holds the data of the set. */
+  int childrenCount[MAX_REGIONS_COUNT]; /**< The number of segments of each region that holds data. */
+  RegionPercept::Segment* lastChild[MAX_REGIONS_COUNT]; /**< The last segment in the segments array of each region that holds data. */
 
   /** Updates the RegionPercept */
   void update(RegionPercept& rPercept);
@@ -94,6 +111,28 @@ private:
    */
   inline RegionPercept::Segment* connectToRegions(RegionPercept::Segment* newSegment, RegionPercept::Segment* lastColumPointer, int xDiff);
 
+  /**
+   * Returns the root of the set of a region with path compression.
+   * @param index The index of the region.
+   * @return The index of the root.
+   */
+  inline int find(int index);
+
+  /**
+   * Returns the region that currently holds the data of the region of a segment.
+   * The region of the segment is updated accordingly.
+   * @param seg A segment that has a region.
+   * @return The region.
+   */
+  inline RegionPercept::Region* getRegion(RegionPercept::Segment* seg);
+
+  /**
+   * Merges the sets of two regions. The first region holds the data of the union.
+   * @param region The region that survives.
+   * @param other The region that is merged into the first one.
+   */
+  void mergeRegions(RegionPercept::Region* region, RegionPercept::Region* other);
+
   /**
    * Builds the regions from the segments.
    */
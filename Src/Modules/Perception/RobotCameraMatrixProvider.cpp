@@ -7,7 +7,7 @@
 
 #include "RobotCameraMatrixProvider.h"
 
-MAKE_MODULE(RobotCameraMatrixProvider, Perception);
+MAKE_PURE_MODULE(RobotCameraMatrixProvider, Perception);
 
 void RobotCameraMatrixProvider::update(RobotCameraMatrix& robotCameraMatrix)
 {
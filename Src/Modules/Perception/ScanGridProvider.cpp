@@ -0,0 +1,168 @@
+/**
+* @file ScanGridProvider.cpp
+* This file implements a module that classifies the pixels on a grid of vertical and
+* horizontal scanlines once per frame.
+*/
+
+#include "ScanGridProvider.h"
+#include <algorithm>
+#include <cstring>
+#include <emmintrin.h>
+
+void ScanGridProvider::update(ScanGrid& scanGrid)
+{
+  ASSERT(lineDistance > 0);
+  ASSERT(horizontalLineDistance > 0);
+
+  DEBUG_RESPONSE("module:ScanGridProvider:benchmark", benchmark(););
+
+  // the distances are given for images at full resolution
+  const int xStep = theProcessingResolution.scale(lineDistance, theCameraInfo.camera);
+  const int yStep = theProcessingResolution.scale(horizontalLineDistance, theCameraInfo.camera);
+
+  scanGrid.verticalLines.clear();
+  scanGrid.horizontalLines.clear();
+  scanGrid.runs.clear();
+  scanGrid.lineDistance = xStep;
+  scanGrid.firstX = 2 * xStep - 1 + (theImage.width % (2 * xStep)) / 2;
+
+  if(!theCameraMatrix.isValid)
+    return;
+
+  const int horizon = std::max(0, std::min(static_cast<int>(theImageCoordinateSystem.origin.y), theImage.height));
+
+  // vertical scanlines from the horizon down to the body contour
+  for(int x = scanGrid.firstX; x < theImage.width; x += xStep)
+  {
+    int yEnd = theImage.height;
+    theBodyContour.clipBottom(x, yEnd);
+    yEnd = std::max(horizon, std::min(yEnd, theImage.height));
+    scanGrid.verticalLines.push_back(ScanGrid::Line(x, horizon, yEnd, scanGrid.runs.size()));
+    classify(scanGrid, scanGrid.verticalLines.back(), &theImage[horizon][x], theImage.widthStep);
+  }
+
+  // horizontal scanlines, the first one directly below the horizon
+  for(int y = std::min(std::max(1, horizon), theImage.height - 2); y < theImage.height; y += yStep)
+  {
+    scanGrid.horizontalLines.push_back(ScanGrid::Line(y, 0, theImage.width, scanGrid.runs.size()));
+    classify(scanGrid, scanGrid.horizontalLines.back(), theImage[y], 1);
+  }
+}
+
+void ScanGridProvider::classify(ScanGrid& scanGrid, ScanGrid::Line& line, const Image::Pixel* pixel, int step)
+{
+  if(line.from >= line.to)
+    return;
+
+  theColorReference.classifyRow(pixel, line.to - line.from, step, colors);
+  addRuns(scanGrid, line, colors);
+}
+
+void ScanGridProvider::addRuns(ScanGrid& scanGrid, ScanGrid::Line& line, const unsigned char* colors)
+{
+  const int count = line.to - line.from;
+  int from = 0;
+
+  // Each pixel is compared with its successor. Every difference ends a run.
+  int pos = 0;
+  for(; pos + 16 < count; pos += 16)
+  {
+    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + pos));
+    const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + pos + 1));
+    const int ends = ~_mm_movemask_epi8(_mm_cmpeq_epi8(current, next)) & 0xffff;
+    if(ends)
+      for(int i = 0; i < 16; ++i)
+        if(ends >> i & 1)
+        {
+          scanGrid.runs.push_back(ScanGrid::Run(line.from + from, line.from + pos + i + 1, colors[from]));
+          from = pos + i + 1;
+        }
+  }
+
+  for(++pos; pos < count; ++pos)
+    if(colors[pos] != colors[pos - 1])
+    {
+      scanGrid.runs.push_back(ScanGrid::Run(line.from + from, line.from + pos, colors[from]));
+      from = pos;
+    }
+  scanGrid.runs.push_back(ScanGrid::Run(line.from + from, line.to, colors[from]));
+  line.endRun = scanGrid.runs.size();
+}
+
+void ScanGridProvider::addRunsScalar(ScanGrid& scanGrid, ScanGrid::Line& line, const unsigned char* colors)
+{
+  const unsigned char* c = colors;
+  int from = line.from;
+  for(int pos = from + 1; pos < line.to; ++pos)
+    if(colors[pos - line.from] != *c)
+    {
+      scanGrid.runs.push_back(ScanGrid::Run(from, pos, *c));
+      from = pos;
+      c = colors + (pos - line.from);
+    }
+  scanGrid.runs.push_back(ScanGrid::Run(from, line.to, *c));
+  line.endRun = scanGrid.runs.size();
+}
+
+void ScanGridProvider::benchmark()
+{
+  bool same = true;
+  STOP_TIME_ON_REQUEST("ScanGridProvider:classifyRowScalar",
+  {
+    for(int y = 0; y < theImage.height; ++y)
+      theColorReference.classifyRowScalar(theImage[y], theImage.width, 1, colorsScalar);
+    for(int x = 0; x < theImage.width; ++x)
+      theColorReference.classifyRowScalar(&theImage[0][x], theImage.height, theImage.widthStep, colorsScalar);
+  });
+  STOP_TIME_ON_REQUEST("ScanGridProvider:classifyRow",
+  {
+    for(int y = 0; y < theImage.height; ++y)
+      theColorReference.classifyRow(theImage[y], theImage.width, 1, colors);
+    for(int x = 0; x < theImage.width; ++x)
+      theColorReference.classifyRow(&theImage[0][x], theImage.height, theImage.widthStep, colors);
+  });
+  for(int y = 0; y < theImage.height && same; ++y)
+  {
+    theColorReference.classifyRow(theImage[y], theImage.width, 1, colors);
+    theColorReference.classifyRowScalar(theImage[y], theImage.width, 1, colorsScalar);
+    same = !memcmp(colors, colorsScalar, theImage.width);
+  }
+  for(int x = 0; x < theImage.width && same; ++x)
+  {
+    theColorReference.classifyRow(&theImage[0][x], theImage.height, theImage.widthStep, colors);
+    theColorReference.classifyRowScalar(&theImage[0][x], theImage.height, theImage.widthStep, colorsScalar);
+    same = !memcmp(colors, colorsScalar, theImage.height);
+  }
+  if(!same)
+    OUTPUT_WARNING("ScanGridProvider: classifyRow and classifyRowScalar differ!");
+
+  // run detection on all columns
+  std::vector<unsigned char> columns(theImage.width * theImage.height);
+  for(int x = 0; x < theImage.width; ++x)
+    theColorReference.classifyRow(&theImage[0][x], theImage.height, theImage.widthStep, &columns[x * theImage.height]);
+  ScanGrid grid, gridScalar;
+  STOP_TIME_ON_REQUEST("ScanGridProvider:addRunsScalar",
+  {
+    for(int x = 0; x < theImage.width; ++x)
+    {
+      gridScalar.verticalLines.push_back(ScanGrid::Line(x, 0, theImage.height, gridScalar.runs.size()));
+      addRunsScalar(gridScalar, gridScalar.verticalLines.back(), &columns[x * theImage.height]);
+    }
+  });
+  STOP_TIME_ON_REQUEST("ScanGridProvider:addRuns",
+  {
+    for(int x = 0; x < theImage.width; ++x)
+    {
+      grid.verticalLines.push_back(ScanGrid::Line(x, 0, theImage.height, grid.runs.size()));
+      addRuns(grid, grid.verticalLines.back(), &columns[x * theImage.height]);
+    }
+  });
+  same = grid.runs.size() == gridScalar.runs.size();
+  for(size_t i = 0; i < grid.runs.size() && same; ++i)
+    same = grid.runs[i].from == gridScalar.runs[i].from && grid.runs[i].to == gridScalar.runs[i].to &&
+           grid.runs[i].colors == gridScalar.runs[i].colors;
+  if(!same)
+    OUTPUT_WARNING("ScanGridProvider: addRuns and addRunsScalar differ!");
+}
+
+MAKE_MODULE(ScanGridProvider, Perception)
@@ -0,0 +1,78 @@
+/**
+* @file ScanGridProvider.h
+* This file declares a module that classifies the pixels on a grid of vertical and
+* horizontal scanlines once per frame.
+*/
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/Image.h"
+#include "Representations/Infrastructure/ProcessingResolution.h"
+#include "Representations/Perception/BodyContour.h"
+#include "Representations/Perception/CameraMatrix.h"
+#include "Representations/Perception/ColorReference.h"
+#include "Representations/Perception/ImageCoordinateSystem.h"
+#include "Representations/Perception/ScanGrid.h"
+
+MODULE(ScanGridProvider)
+  REQUIRES(BodyContour)
+  REQUIRES(CameraInfo)
+  REQUIRES(CameraMatrix)
+  REQUIRES(ColorReference)
+  REQUIRES(Image)
+  REQUIRES(ImageCoordinateSystem)
+  REQUIRES(ProcessingResolution)
+  PROVIDES_WITH_DRAW(ScanGrid)
+  DEFINES_PARAMETER(int, lineDistance, 3) /**< The distance between neighboring vertical scanlines in pixels at full resolution. The Regionizer scans every second one of them. */
+  DEFINES_PARAMETER(int, horizontalLineDistance, 24) /**< The distance between neighboring horizontal scanlines in pixels at full resolution. */
+END_MODULE
+
+/**
+* @class ScanGridProvider
+* The module classifies all pixels on vertical scanlines between the horizon and the body contour
+* and on horizontal scanlines starting at the horizon. The results are stored as runs of pixels
+* with equal color classes.
+*/
+class ScanGridProvider : public ScanGridProviderBase
+{
+private:
+  void update(ScanGrid& scanGrid);
+
+  /**
+  * The method classifies the pixels of a scanline and appends the runs found to the scan grid.
+  * @param scanGrid The scan grid the runs are added to.
+  * @param line The scanline. Its range of runs is updated.
+  * @param pixel The first pixel of the scanline.
+  * @param step The distance between two successive pixels of the scanline in the image buffer.
+  */
+  void classify(ScanGrid& scanGrid, ScanGrid::Line& line, const Image::Pixel* pixel, int step);
+
+  /**
+  * The method appends the runs of a classified scanline to the scan grid. The color classes
+  * of 16 neighboring pixels are compared at once using SSE2, so that uniformly colored parts
+  * of the scanline are skipped quickly.
+  * @param scanGrid The scan grid the runs are added to.
+  * @param line The scanline. Its range of runs is updated.
+  * @param colors The color classes of all pixels of the scanline.
+  */
+  static void addRuns(ScanGrid& scanGrid, ScanGrid::Line& line, const unsigned char* colors);
+
+  /**
+  * The method appends the runs of a classified scanline to the scan grid pixel by pixel.
+  * Same parameters and results as addRuns.
+  */
+  static void addRunsScalar(ScanGrid& scanGrid, ScanGrid::Line& line, const unsigned char* colors);
+
+  /**
+  * The method classifies all rows and columns of the image with ColorReference::classifyRow
+  * and ColorReference::classifyRowScalar and determines the runs of all columns with addRuns
+  * and addRunsScalar. It measures the time all of them require and checks that the results
+  * are the same. It is executed on the debug request "module:ScanGridProvider:benchmark".
+  */
+  void benchmark();
+
+  unsigned char colors[maxResolutionWidth]; /**< Buffer for the color classes of the pixels of a scanline. */
+  unsigned char colorsScalar[maxResolutionWidth]; /**< Second buffer used by the benchmark. */
+};
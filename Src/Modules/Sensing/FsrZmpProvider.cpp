@@ -3,7 +3,7 @@
 #include "Tools/Math/Pose3D.h"
 #include <float.h>
 
-MAKE_MODULE(FsrZmpProvider, Sensing)
+MAKE_PURE_MODULE(FsrZmpProvider, Sensing)
 
 FsrZmpProvider::FsrZmpProvider()
 {
@@ -70,4 +70,4 @@ void RobotModelProvider::update(RobotModel& robotModel)
 }
 
 
-MAKE_MODULE(RobotModelProvider, Sensing)
+MAKE_PURE_MODULE(RobotModelProvider, Sensing)
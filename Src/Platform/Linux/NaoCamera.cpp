@@ -25,14 +25,57 @@
 #include "Tools/Debugging/Debugging.h"
 #include "Tools/Streams/InStreams.h"
 
+Semaphore NaoCamera::frameArrived;
+
+NaoCamera::Lease::Lease(const Lease& other) : camera(other.camera), index(other.index)
+{
+  if(camera)
+    camera->addReference(index);
+}
+
+NaoCamera::Lease& NaoCamera::Lease::operator=(const Lease& other)
+{
+  if(other.camera)
+    other.camera->addReference(other.index);
+  release();
+  camera = other.camera;
+  index = other.index;
+  return *this;
+}
+
+void NaoCamera::Lease::release()
+{
+  if(camera)
+  {
+    camera->removeReference(index);
+    camera = 0;
+  }
+}
+
+const unsigned char* NaoCamera::Lease::getImage() const
+{
+  return camera ? static_cast<const unsigned char*>(camera->mem[index]) : 0;
+}
+
+unsigned long long NaoCamera::Lease::getTimeStamp() const
+{
+  return camera ? camera->frames[index].timeStamp : 0;
+}
+
+unsigned long long NaoCamera::Lease::getArrivalTime() const
+{
+  return camera ? camera->frames[index].arrivalTime : 0;
+}
+
 NaoCamera::NaoCamera(const char* device, CameraInfo::Camera camera, int width, int height, bool flip) :
   timeWaitedForLastImage(0),
+  readyIndex(-1),
+  failed(false),
   WIDTH(width * 2),
   HEIGHT(height * 2),
 #ifndef NDEBUG
   SIZE(WIDTH * HEIGHT * 2),
 #endif
-  currentBuf(0),
   timeStamp(0), camera(camera), first(true),
   lastCameraSettingTimestamp(0), cameraSettingApplicationRate(16000)
 {
@@ -47,10 +90,30 @@ NaoCamera::NaoCamera(const char* device, CameraInfo::Camera camera, int width, i
   initDefaultControlSettings(flip);
 
   startCapturing();
+
+  captureThread.setPriority(20);
+  captureThread.start(this, &NaoCamera::capture);
 }
 
 NaoCamera::~NaoCamera()
 {
+  releaseImage();
+
+  // Other threads (e.g. the one of the logger) only hold leases for a short time.
+  for(;;)
+  {
+    {
+      SYNC;
+      int i = 0;
+      while(i < frameBufferCount && !frames[i].references)
+        ++i;
+      if(i == frameBufferCount)
+        break;
+    }
+    SystemCall::sleep(1);
+  }
+  captureThread.stop();
+
   // disable streaming
   int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
   VERIFY(ioctl(fd, VIDIOC_STREAMOFF, &type) != -1);
@@ -68,150 +131,186 @@ NaoCamera::~NaoCamera()
   free(buf);
 }
 
-void NaoCamera::releaseImage()
+void NaoCamera::capture()
+{
+  NAME_THREAD(camera == CameraInfo::upper ? "UpperCamera" : "LowerCamera");
+  while(captureThread.isRunning())
+  {
+    // A timeout allows to check whether the thread should terminate.
+    struct pollfd pollfd = {fd, POLLIN | POLLPRI, 0};
+    const int polled = poll(&pollfd, 1, 100);
+    if(polled == 0 || (polled < 0 && errno == EINTR))
+      continue;
+    else if(polled < 0 || pollfd.revents & (POLLERR | POLLNVAL) || ioctl(fd, VIDIOC_DQBUF, buf) == -1)
+    {
+      // Debug output is not available in this thread. captureNew reports the error.
+      SYNC;
+      failed = true;
+      frameArrived.post();
+      return;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts); // the clock video4linux timestamps use
+    {
+      SYNC;
+      Frame& frame = frames[buf->index];
+      frame.queued = false;
+      frame.timeStamp = (unsigned long long) buf->timestamp.tv_sec * 1000000ll + buf->timestamp.tv_usec;
+      frame.arrivalTime = (unsigned long long) ts.tv_sec * 1000000ll + ts.tv_nsec / 1000;
+
+      // Only the newest frame is kept. The one it replaces was never captured.
+      if(readyIndex >= 0)
+        queueBuffer(readyIndex);
+      readyIndex = buf->index;
+    }
+    frameArrived.post();
+  }
+}
+
+bool NaoCamera::takeReadyFrame()
 {
-  if(currentBuf)
+  int index;
   {
-    VERIFY(ioctl(fd, VIDIOC_QBUF, currentBuf) != -1);
-    currentBuf = 0;
+    SYNC;
+    if(readyIndex < 0)
+      return false;
+    index = readyIndex;
+    readyIndex = -1;
+    ++frames[index].references;
   }
+  currentLease = Lease(this, index); // the reference was added above
+  timeStamp = currentLease.getTimeStamp();
+
+  if(first)
+  {
+    first = false;
+    printf("%s camera is working\n", CameraInfo::getName(camera));
+  }
+  return true;
+}
+
+void NaoCamera::addReference(int index)
+{
+  SYNC;
+  ASSERT(frames[index].references > 0);
+  ++frames[index].references;
+}
+
+void NaoCamera::removeReference(int index)
+{
+  SYNC;
+  ASSERT(frames[index].references > 0);
+  if(!--frames[index].references)
+    queueBuffer(index);
+}
+
+void NaoCamera::queueBuffer(int index)
+{
+  ASSERT(!frames[index].queued);
+  struct v4l2_buffer buffer;
+  memset(&buffer, 0, sizeof(buffer));
+  buffer.index = index;
+  buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+#ifdef USE_USERPTR
+  buffer.memory = V4L2_MEMORY_USERPTR;
+  buffer.m.userptr = (unsigned long)mem[index];
+  buffer.length = memLength[index];
+#else
+  buffer.memory = V4L2_MEMORY_MMAP;
+#endif
+  VERIFY(ioctl(fd, VIDIOC_QBUF, &buffer) != -1);
+  frames[index].queued = true;
+}
+
+void NaoCamera::releaseImage()
+{
+  currentLease.release();
 }
 
 bool NaoCamera::captureNew(NaoCamera& cam1, NaoCamera& cam2, int timeout, bool& errorCam1, bool& errorCam2)
 {
   NaoCamera* cams[2] = { &cam1, &cam2 };
 
-  ASSERT(cam1.currentBuf == 0);
-  ASSERT(cam2.currentBuf == 0);
+  ASSERT(!cam1.hasImage());
+  ASSERT(!cam2.hasImage());
 
   errorCam1 = errorCam2 = false;
 
-  struct pollfd pollfds[2] = {
-    {cams[0]->fd, POLLIN | POLLPRI, 0},
-    {cams[1]->fd, POLLIN | POLLPRI, 0},
-  };
-  int polled = poll(pollfds, 2, timeout);
-  if(polled < 0)
-  {
-    OUTPUT_ERROR("Cannot poll for camera images. Reason: " << strerror(errno));
-    ASSERT(false);
-    return false;
-  }
-  else if(polled == 0)
+  const unsigned startPollingTimestamp = SystemCall::getCurrentSystemTime();
+  for(;;)
   {
-    OUTPUT_ERROR("One second passed and there's still no image to read from any camera. Terminating.");
-    return false;
-  }
+    // Ignore older notifications. Frames that arrive after this are signaled again.
+    while(frameArrived.tryWait());
 
-  for(int i = 0; i < 2; ++i)
-  {
-    if(pollfds[i].revents & POLLIN)
+    bool captured = false;
+    for(int i = 0; i < 2; ++i)
     {
-      //VERIFY(ioctl(cams[i]->fd, VIDIOC_DQBUF, cams[i]->buf) != -1);
-      int error = ioctl(cams[i]->fd, VIDIOC_DQBUF, cams[i]->buf);
-      if(error == -1)
+      captured |= cams[i]->takeReadyFrame();
+      SYNC_WITH(*cams[i]);
+      if(cams[i]->failed)
       {
-        OUTPUT_ERROR("VIDIOC_DQBUF failed: " << strerror(errno));
+        OUTPUT_ERROR(CameraInfo::getName(cams[i]->camera) << " camera : Capturing failed.");
         (i == 0 ? errorCam1 : errorCam2) = true;
       }
-      else
-      {
-        //OUTPUT_ERROR("VIDIOC_DQBUF success revents=" << pollfds[i].revents);
-        //ASSERT(buf->bytesused == SIZE);
-        cams[i]->currentBuf = cams[i]->buf;
-        cams[i]->timeStamp = (unsigned long long) cams[i]->currentBuf->timestamp.tv_sec * 1000000ll + cams[i]->currentBuf->timestamp.tv_usec;
-
-        if(cams[i]->first)
-        {
-          cams[i]->first = false;
-          printf("%s camera is working\n", CameraInfo::getName(cams[i]->camera));
-        }
-      }
     }
-    else if(pollfds[i].revents)
+    if(captured || errorCam1 || errorCam2)
+      break;
+
+    const int waited = SystemCall::getTimeSince(startPollingTimestamp);
+    if(waited >= timeout || !frameArrived.wait(timeout - waited))
     {
-      OUTPUT_ERROR("strane poll results: " << pollfds[i].revents);
-      (i == 0 ? errorCam1 : errorCam2) = true;
+      OUTPUT_ERROR("One second passed and there's still no image to read from any camera. Terminating.");
+      return false;
     }
   }
-  /*
-  if(!success)
-  {
-    OUTPUT_ERROR("Polling failed.");
-    return false;
-  }
-  */
-
+  cam1.timeWaitedForLastImage = cam2.timeWaitedForLastImage = SystemCall::getTimeSince(startPollingTimestamp);
   return true;
 }
 
 bool NaoCamera::captureNew()
 {
-  // requeue the buffer of the last captured image which is obsolete now
-  if(currentBuf)
-  {
-    BH_TRACE;
-    VERIFY(ioctl(fd, VIDIOC_QBUF, currentBuf) != -1);
-  }
-  BH_TRACE;
+  // release the last captured image which is obsolete now
+  releaseImage();
 
   const unsigned startPollingTimestamp = SystemCall::getCurrentSystemTime();
-  struct pollfd pollfd = {fd, POLLIN | POLLPRI, 0};
-  int polled = poll(&pollfd, 1, 200); // Fail after missing 6 frames (200ms)
-  if(polled < 0)
-  {
-    OUTPUT_ERROR(CameraInfo::getName(camera) << "camera : Cannot poll. Reason: " << strerror(errno));
-    ASSERT(false);
-  }
-  else if(polled == 0)
-  {
-    OUTPUT_ERROR(CameraInfo::getName(camera) << "camera : 200 ms passed and there's still no image to read from the camera. Terminating.");
-    return false;
-  }
-  else if(pollfd.revents & (POLLERR | POLLNVAL))
-  {
-    OUTPUT_ERROR(CameraInfo::getName(camera) << "camera : Polling failed.");
-    return false;
-  }
-  // dequeue a frame buffer (this call blocks when there is no new image available) */
-  VERIFY(ioctl(fd, VIDIOC_DQBUF, buf) != -1);
-  BH_TRACE;
-  //ASSERT(buf->bytesused == SIZE);
-  currentBuf = buf;
-  timeStamp = (unsigned long long) currentBuf->timestamp.tv_sec * 1000000ll + currentBuf->timestamp.tv_usec;
-  const unsigned endPollingTimestamp = SystemCall::getCurrentSystemTime();
-  timeWaitedForLastImage = endPollingTimestamp - startPollingTimestamp;
-
-  if(first)
+  for(;;)
   {
-    first = false;
-    printf("%s camera is working\n", CameraInfo::getName(camera));
+    while(frameArrived.tryWait());
+    if(takeReadyFrame())
+      break;
+    {
+      SYNC;
+      if(failed)
+      {
+        OUTPUT_ERROR(CameraInfo::getName(camera) << "camera : Capturing failed.");
+        return false;
+      }
+    }
+    const int waited = SystemCall::getTimeSince(startPollingTimestamp);
+    if(waited >= 200 || !frameArrived.wait(200 - waited)) // Fail after missing 6 frames (200ms)
+    {
+      OUTPUT_ERROR(CameraInfo::getName(camera) << "camera : 200 ms passed and there's still no image to read from the camera. Terminating.");
+      return false;
+    }
   }
-
+  timeWaitedForLastImage = SystemCall::getTimeSince(startPollingTimestamp);
   return true;
 }
 
 const unsigned char* NaoCamera::getImage() const
 {
-#ifdef USE_USERPTR
-  unsigned char* imageBuffer = currentBuf ? (unsigned char*)currentBuf->m.userptr : 0;
-#else
-  unsigned char* imageBuffer = currentBuf ? static_cast<unsigned char*>(mem[currentBuf->index]) : 0;
-#endif
-  return imageBuffer;
+  return currentLease.getImage();
 }
 
 bool NaoCamera::hasImage() const
 {
-  return !!currentBuf;
+  return !currentLease.isEmpty();
 }
 
 unsigned long long NaoCamera::getTimeStamp() const
 {
-  if(!currentBuf)
-    return 0;
-  ASSERT(currentBuf);
-  return timeStamp;
+  return currentLease.getTimeStamp();
 }
 
 float NaoCamera::getFrameRate() const
@@ -409,18 +508,7 @@ void NaoCamera::initQueueAllBuffers()
 {
   // queue the buffers
   for(int i = 0; i < frameBufferCount; ++i)
-  {
-    buf->index = i;
-    buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-#ifdef USE_USERPTR
-    buf->memory = V4L2_MEMORY_USERPTR;
-    buf->m.userptr = (unsigned long)mem[i];
-    buf->length  = memLength[i];
-#else
-    buf->memory = V4L2_MEMORY_MMAP;
-#endif
-    VERIFY(ioctl(fd, VIDIOC_QBUF, buf) != -1);
-  }
+    queueBuffer(i);
 }
 
 void NaoCamera::initDefaultControlSettings(bool flip)
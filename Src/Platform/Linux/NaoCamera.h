@@ -7,17 +7,79 @@
 #pragma once
 
 #include "Tools/Streams/InStreams.h"
+#include "Platform/Thread.h"
+#include "Platform/Semaphore.h"
 #include "Representations/Configuration/CameraSettings.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 
 /**
 * @class NaoCamera
-* Interface to a camera of the NAO
+* Interface to a camera of the NAO. A thread per camera dequeues the frame
+* buffers as soon as the driver filled them. The newest frame is kept until
+* it is captured. Older frames nobody holds are returned to the driver
+* immediately. Captured frames are accessed through reference counted leases.
+* A frame buffer is only returned to the driver when its last lease is released.
 */
 class NaoCamera
 {
 public:
+  /**
+  * @class Lease
+  * A reference to a captured frame. As long as a lease of a frame exists,
+  * its buffer is not reused by the driver. Leases can be copied and
+  * released in any thread. The destructor of the camera waits until all
+  * leases were released.
+  */
+  class Lease
+  {
+  private:
+    NaoCamera* camera; /**< The camera the frame buffer belongs to. 0 if this lease is empty. */
+    int index; /**< The index of the frame buffer. */
+
+  public:
+    /** Constructs an empty lease. */
+    Lease() : camera(0), index(0) {}
+
+    /**
+    * Constructs a lease of a frame buffer. The frame buffer must already be referenced.
+    * @param camera The camera the frame buffer belongs to.
+    * @param index The index of the frame buffer.
+    */
+    Lease(NaoCamera* camera, int index) : camera(camera), index(index) {}
+
+    Lease(const Lease& other);
+    Lease& operator=(const Lease& other);
+    ~Lease() {release();}
+
+    /** Releases the frame. The lease is empty afterwards. */
+    void release();
+
+    /**
+    * Is a frame referenced by this lease?
+    * @return Does the lease contain a frame?
+    */
+    bool isEmpty() const {return !camera;}
+
+    /**
+    * The image data of the frame.
+    * @return The image data buffer or 0 if the lease is empty.
+    */
+    const unsigned char* getImage() const;
+
+    /**
+    * Timestamp of the frame in µs as set by the driver.
+    * @return The timestamp or 0 if the lease is empty.
+    */
+    unsigned long long getTimeStamp() const;
+
+    /**
+    * Time in µs when the frame was dequeued by the capture thread.
+    * The clock is the same as the one of the timestamp.
+    * @return The arrival time or 0 if the lease is empty.
+    */
+    unsigned long long getArrivalTime() const;
+  };
 
   /**
   * Constructor.
@@ -29,7 +91,7 @@ public:
   */
   NaoCamera(const char* device, CameraInfo::Camera camera, int width, int height, bool flip);
 
-  /** Destructor. */
+  /** Destructor. Waits until the leases other threads hold were released. */
   ~NaoCamera();
 
   /**
@@ -62,9 +124,17 @@ public:
 
   /**
   * Releases an image that has been captured. That way the buffer can be used to capture another image
+  * as soon as no other lease references it anymore.
   */
   void releaseImage();
 
+  /**
+  * Returns a lease of the last captured image. Holding it keeps the image
+  * valid after it was released by releaseImage().
+  * @return The lease. It is empty if there is no captured image.
+  */
+  Lease getLease() const {return currentLease;}
+
   /**
   * The last captured image.
   * @return The image data buffer.
@@ -118,14 +188,37 @@ public:
   unsigned int timeWaitedForLastImage;
 
 private:
+  /**
+  * The state of a frame buffer that is not queued in the driver.
+  */
+  class Frame
+  {
+  public:
+    unsigned long long timeStamp; /**< Timestamp of the image as set by the driver in µs. */
+    unsigned long long arrivalTime; /**< Time when the image was dequeued in µs. */
+    int references; /**< The number of leases of this frame. */
+    bool queued; /**< Is the buffer currently queued in the driver? */
+
+    Frame() : timeStamp(0), arrivalTime(0), references(0), queued(false) {}
+  };
+
   CameraSettings settings; /**< The camera control settings. */
   CameraSettings appliedSettings; /**< The camera settings that are known to be applied. */
 
   enum
   {
-    frameBufferCount = 3, /**< Amount of available frame buffers. */
+    frameBufferCount = 6, /**< Amount of available frame buffers. Leased frames are not available to the driver. */
   };
 
+  static Semaphore frameArrived; /**< Is posted by the capture threads of all cameras whenever a new frame is ready. */
+
+  DECLARE_SYNC; /**< Synchronizes the frame states between the capture thread and the leases. */
+  Thread<NaoCamera> captureThread; /**< The thread that dequeues the frame buffers. */
+  Frame frames[frameBufferCount]; /**< The states of all frame buffers. */
+  int readyIndex; /**< The index of the newest frame that was not captured yet or -1 if there is none. */
+  bool failed; /**< Did the capture thread fail to dequeue a frame buffer? */
+  Lease currentLease; /**< The lease of the last captured image. */
+
   unsigned int WIDTH; /**< The width of the yuv 422 image */
   unsigned int HEIGHT; /**< The height of the yuv 422 image */
 #ifndef NDEBUG
@@ -134,8 +227,7 @@ private:
   int fd; /**< The file descriptor for the video device. */
   void* mem[frameBufferCount]; /**< Frame buffer addresses. */
   int memLength[frameBufferCount]; /**< The length of each frame buffer. */
-  struct v4l2_buffer* buf; /**< Reusable parameter struct for some ioctl calls. */
-  struct v4l2_buffer* currentBuf; /**< The last dequeued frame buffer. */
+  struct v4l2_buffer* buf; /**< Reusable parameter struct for some ioctl calls. Only used by the capture thread after initialization. */
   unsigned long long timeStamp; /**< Timestamp of the last captured image in microseconds. */
   CameraInfo::Camera camera; /**< The camera accessed by this driver. */
   bool first; /**< First image grabbed? */
@@ -166,6 +258,35 @@ private:
   bool setControlSettings(std::list<CameraSettings::V4L2Setting> controlsettings,
                           std::list<CameraSettings::V4L2Setting> appliedControlSettings);
 
+  /**
+  * Takes the newest frame that was not captured yet.
+  * @return Was there such a frame?
+  */
+  bool takeReadyFrame();
+
+  /**
+  * Adds a lease to a frame buffer.
+  * @param index The index of the frame buffer.
+  */
+  void addReference(int index);
+
+  /**
+  * Removes a lease from a frame buffer. If it was the last one, the buffer
+  * is queued in the driver again.
+  * @param index The index of the frame buffer.
+  */
+  void removeReference(int index);
+
+  /**
+  * Queues a frame buffer in the driver. Must be called inside a SYNC block
+  * after initialization.
+  * @param index The index of the frame buffer.
+  */
+  void queueBuffer(int index);
+
+  /** The main function of the capture thread. */
+  void capture();
+
   void initOpenVideoDevice(const char* device);
   void initSetImageFormat();
   void initRequestAndMapBuffers();
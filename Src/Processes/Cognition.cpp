@@ -57,6 +57,9 @@ bool Cognition::main()
 
   if(CognitionLogDataProvider::isFrameDataComplete() && CameraProvider::isFrameDataComplete() && CameraProvider::isFrameDataComplete())
   {
+    bool performanceCounters = false;
+    DEBUG_RESPONSE("timing:performance counters", performanceCounters = true;);
+    timingManager.setPerformanceCounters(performanceCounters);
     timingManager.signalProcessStart();
 
     // There must not be any TEAM_OUTPUT before this in each frame.
@@ -67,7 +70,12 @@ bool Cognition::main()
     DECLARE_DEBUG_DRAWING("origin:Reset", "drawingOnField"); // Set the origin to the (0,0,0)
     ORIGIN("origin:Reset", 0.0f, 0.0f, 0.0f);
 
-    STOP_TIME_ON_REQUEST_WITH_PLOT("Cognition", moduleManager.execute(););
+    // On the robot, optional modules are skipped if the frame would not be finished
+    // before the next image arrives.
+    const unsigned budget = SystemCall::getMode() == SystemCall::physicalRobot && &Blackboard::theInstance->theFrameInfo
+                            ? unsigned(Blackboard::theInstance->theFrameInfo.cycleTime * 1000.f) : 0;
+    STOP_TIME_ON_REQUEST_WITH_PLOT("Cognition", moduleManager.execute(budget););
+    CameraProvider::outputJPEGImage();
 
     DEBUG_RESPONSE("process:Cognition:jointDelay",
     {
@@ -101,7 +109,14 @@ bool Cognition::main()
       timingManager.getData().copyAllMessages(theDebugSender);
     );
 
-    logger.run();
+    // With camera pipelines, the blackboard does not contain the results of an image pending.
+    if(!moduleManager.isImagePending())
+    {
+#ifdef CAMERA_INCLUDED
+      logger.setImageLease(CameraProvider::getImageLease());
+#endif
+      logger.run();
+    }
 
     if(theDebugSender.getNumberOfMessages() > numberOfMessages + 1)
     {
@@ -49,6 +49,9 @@ bool Motion::main()
 
   if(MotionLogDataProvider::isFrameDataComplete() && NaoProvider::isFrameDataComplete())
   {
+    bool performanceCounters = false;
+    DEBUG_RESPONSE("timing:performance counters", performanceCounters = true;);
+    timingManager.setPerformanceCounters(performanceCounters);
     timingManager.signalProcessStart();
 
     STOP_TIME_ON_REQUEST_WITH_PLOT("Motion", moduleManager.execute(););
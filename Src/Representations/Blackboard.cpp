@@ -31,6 +31,8 @@ Blackboard::Blackboard() :
   theTeamDataSenderOutput(theTeamDataSenderOutput),
   theUSRequest(theUSRequest),
   theThumbnail(theThumbnail),
+  theFrameBudget(theFrameBudget),
+  theProcessingResolution(theProcessingResolution),
 
 // Configuration
   theCameraSettings(theCameraSettings),
@@ -60,6 +62,9 @@ Blackboard::Blackboard() :
   theColorReference(theColorReference),
   theFieldBoundary(theFieldBoundary),
   theObstacleSpots(theObstacleSpots),
+  theScanGrid(theScanGrid),
+  theImagePyramid(theImagePyramid),
+  theProjectionGrid(theProjectionGrid),
 
 // Modeling
   theArmContactModel(theArmContactModel),
@@ -32,6 +32,8 @@ class RobotHealth;
 class TeamDataSenderOutput;
 class USRequest;
 class Thumbnail;
+class FrameBudget;
+class ProcessingResolution;
 
 // Configuration
 class CameraSettings;
@@ -61,6 +63,9 @@ class BodyContour;
 class ColorReference;
 class FieldBoundary;
 class ObstacleSpots;
+class ScanGrid;
+class ImagePyramid;
+class ProjectionGrid;
 
 // Modeling
 class ArmContactModel;
@@ -167,6 +172,8 @@ protected:
   const TeamDataSenderOutput& theTeamDataSenderOutput;
   const USRequest& theUSRequest;
   const Thumbnail& theThumbnail;
+  const FrameBudget& theFrameBudget;
+  const ProcessingResolution& theProcessingResolution;
 
   // Configuration
   const CameraSettings& theCameraSettings;
@@ -196,6 +203,9 @@ protected:
   const ColorReference& theColorReference;
   const FieldBoundary& theFieldBoundary;
   const ObstacleSpots& theObstacleSpots;
+  const ScanGrid& theScanGrid;
+  const ImagePyramid& theImagePyramid;
+  const ProjectionGrid& theProjectionGrid;
 
   // Modeling
   const ArmContactModel& theArmContactModel;
@@ -312,4 +322,5 @@ public:
   friend class Motion; /**< The class Motion can read theInstance. */
   friend class Framework; /**< The class Framework can set theInstance. */
   friend class CognitionLogger; /**< The cogniton logger needs to read theInstance */
+  friend class ModuleManager; /**< The class ModuleManager sets theInstance in its worker threads. */
 };
@@ -343,12 +343,12 @@ Vector2<int> FieldDimensions::CornersTable::getClosest(const Vector2<int>& p) co
 
 void FieldDimensions::serialize(In* in, Out* out)
 {
-  ASSERT(in); // handling center circle only works when reading
-
   std::vector<LinesTable::Line>& carpetBorder(this->carpetBorder.lines);
   std::vector<LinesTable::Line>& fieldBorder(this->fieldBorder.lines);
   std::vector<LinesTable::Line>& fieldLines(this->fieldLines.lines);
-  LinesTable::Circle centerCircle;
+  LinesTable::Circle centerCircle; // when writing, its segments are already part of the field lines
+  centerCircle.radius = 0.f;
+  centerCircle.numOfSegments = 0;
   std::vector<Vector2<> >& xCorner(corners[FieldDimensions::xCorner]);
   std::vector<Vector2<> >& tCorner0(corners[FieldDimensions::tCorner0]);
   std::vector<Vector2<> >& tCorner90(corners[FieldDimensions::tCorner90]);
@@ -365,7 +365,8 @@ void FieldDimensions::serialize(In* in, Out* out)
   STREAM(fieldBorder);
   STREAM(fieldLines);
   STREAM(centerCircle);
-  this->fieldLines.pushCircle(centerCircle.center, centerCircle.radius, centerCircle.numOfSegments);
+  if(centerCircle.numOfSegments > 0)
+    this->fieldLines.pushCircle(centerCircle.center, centerCircle.radius, centerCircle.numOfSegments);
 
   STREAM(xCorner);
   STREAM(tCorner0);
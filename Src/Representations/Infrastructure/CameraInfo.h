@@ -43,6 +43,11 @@ public:
   float focalLenPow2;
   float focalLenPow4;
 
+  /** Constructor. The image is empty until real camera information is received. */
+  CameraInfo() :
+    camera(upper), width(0), height(0), openingAngleWidth(0.f), openingAngleHeight(0.f),
+    focalLength(0.f), focalLengthInv(0.f), focalLenPow2(0.f), focalLenPow4(0.f) {}
+
 private:
   virtual void serialize(In* in, Out* out);
 };
@@ -0,0 +1,26 @@
+/**
+* @file FrameBudget.h
+* The file declares a class that contains the decisions of the module manager
+* about skipping optional modules to keep a frame within its time budget and
+* about skipping providers of lazy representations nobody demanded.
+*/
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+#include <string>
+#include <vector>
+
+/**
+* @class FrameBudget
+* The time budget of the previous frame and the representations that were not
+* updated in that frame, because their optional providers were skipped or
+* because they were lazy and not demanded.
+*/
+STREAMABLE(FrameBudget,
+{,
+  (unsigned)(0) budget, /**< The time available per frame in ms. 0 if optional modules are never skipped. */
+  (unsigned)(0) duration, /**< The time the execution of all modules took in ms. */
+  (std::vector<std::string>) skipped, /**< The representations whose providers were skipped. */
+  (std::vector<std::string>) notDemanded, /**< The lazy representations whose providers were skipped, because nothing read them. */
+});
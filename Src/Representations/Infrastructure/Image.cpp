@@ -132,6 +132,12 @@ void Image::serialize(In* in, Out* out)
       out->write((*this)[y], width * sizeof(Pixel));
   else
   {
+    // The pixels read must not overwrite an image stored elsewhere, e.g. a camera buffer.
+    if(isReference)
+    {
+      image = new Pixel[maxResolutionHeight * maxResolutionWidth * 2];
+      isReference = false;
+    }
     widthStep = width * 2;
     for(int y = 0; y < height; ++y)
       in->read((*this)[y], width * sizeof(Pixel));
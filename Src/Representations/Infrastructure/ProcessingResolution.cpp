@@ -0,0 +1,38 @@
+/**
+* @file ProcessingResolution.cpp
+* Implementation of the subsampling methods of class ProcessingResolution.
+*/
+
+#include "ProcessingResolution.h"
+#include "Platform/BHAssert.h"
+
+void ProcessingResolution::subsample(Image& image, Image::Pixel* buffer)
+{
+  ASSERT(buffer || !image.isReference);
+  const int width = image.width / 2;
+  const int height = image.height / 2;
+
+  // The rows of the result are image.width pixels apart. Since every destination
+  // pixel is located before its source pixel, the image can also be subsampled in place.
+  Image::Pixel* dest = buffer ? buffer : image[0];
+  for(int y = 0; y < height; ++y, dest += width * 2)
+  {
+    const Image::Pixel* src = image[y * 2];
+    for(Image::Pixel* p = dest, * pEnd = dest + width; p < pEnd; ++p, src += 2)
+      *p = *src;
+  }
+  image.setResolution(width, height);
+  if(buffer)
+    image.setImage(reinterpret_cast<unsigned char*>(buffer));
+}
+
+void ProcessingResolution::subsample(CameraInfo& cameraInfo)
+{
+  cameraInfo.width /= 2;
+  cameraInfo.height /= 2;
+  cameraInfo.opticalCenter *= 0.5f;
+  cameraInfo.focalLength *= 0.5f;
+  cameraInfo.focalLengthInv *= 2.f;
+  cameraInfo.focalLenPow2 = cameraInfo.focalLength * cameraInfo.focalLength;
+  cameraInfo.focalLenPow4 = cameraInfo.focalLenPow2 * cameraInfo.focalLenPow2;
+}
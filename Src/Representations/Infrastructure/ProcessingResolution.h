@@ -0,0 +1,81 @@
+/**
+* @file ProcessingResolution.h
+* The file declares a class that states at which resolution the images of
+* each camera are processed.
+*/
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/Image.h"
+
+/**
+* @class ProcessingResolution
+* Which camera images are subsampled to half of their width and height before
+* they are processed? The decision is made at the beginning of each frame,
+* before the image is provided, so that all perception modules know the
+* resolution of the current image.
+*/
+STREAMABLE(ProcessingResolution,
+{
+public:
+  /**
+  * The method returns whether the images of a camera are processed at half resolution.
+  * @param camera The camera.
+  * @return Are the images subsampled?
+  */
+  bool isHalf(CameraInfo::Camera camera) const {return camera == CameraInfo::upper ? upperHalf : lowerHalf;}
+
+  /**
+  * The method converts a distance in pixels that refers to the full resolution of
+  * a camera into the resolution the images of that camera are processed at.
+  * @param pixels The distance at full resolution.
+  * @param camera The camera.
+  * @return The distance at the processing resolution.
+  */
+  float scale(float pixels, CameraInfo::Camera camera) const {return isHalf(camera) ? pixels * 0.5f : pixels;}
+
+  /**
+  * The method converts a distance in pixels that refers to the full resolution of
+  * a camera into the resolution the images of that camera are processed at.
+  * @param pixels The distance at full resolution. It is rounded up when it is halved,
+  *               so that positive distances stay positive.
+  * @param camera The camera.
+  * @return The distance at the processing resolution.
+  */
+  int scale(int pixels, CameraInfo::Camera camera) const {return isHalf(camera) ? (pixels + 1) / 2 : pixels;}
+
+  /** Same as above for unsigned distances. */
+  unsigned scale(unsigned pixels, CameraInfo::Camera camera) const {return isHalf(camera) ? (pixels + 1) / 2 : pixels;}
+
+  /**
+  * The method converts an area in pixels that refers to the full resolution of
+  * a camera into the resolution the images of that camera are processed at.
+  * Both dimensions are halved, so the area is quartered.
+  * @param pixels The area at full resolution. It is rounded up when it is quartered,
+  *               so that positive areas stay positive.
+  * @param camera The camera.
+  * @return The area at the processing resolution.
+  */
+  int scaleArea(int pixels, CameraInfo::Camera camera) const {return isHalf(camera) ? (pixels + 3) / 4 : pixels;}
+
+  /**
+  * The method subsamples an image to half of its width and height. It keeps every
+  * second pixel of every second row. The widthStep is again twice the width.
+  * @param image The image that is subsampled.
+  * @param buffer A buffer of at least maxResolutionWidth * maxResolutionHeight / 2 pixels
+  *               the image is changed to reference. If it is 0, the image is subsampled
+  *               in place, which requires that the image owns its pixels.
+  */
+  static void subsample(Image& image, Image::Pixel* buffer = 0);
+
+  /**
+  * The method adapts the camera information to an image subsampled by subsample(Image&).
+  * @param cameraInfo The camera information that is changed.
+  */
+  static void subsample(CameraInfo& cameraInfo),
+
+  (bool)(false) upperHalf, /**< Are the images of the upper camera processed at half resolution? */
+  (bool)(false) lowerHalf, /**< Are the images of the lower camera processed at half resolution? */
+});
@@ -18,7 +18,7 @@ public:
   void draw() const,
 
   (Vector2<>) positionInImage,         /**< The position of the ball in the current image */
-  (float) radiusInImage,               /**< The radius of the ball in the current image */
+  (float)(0.f) radiusInImage,          /**< The radius of the ball in the current image */
   (bool)(false) ballWasSeen,           /**< Indicates, if the ball was seen in the current image. */
   (Vector2<>) relativePositionOnField, /**< Ball position relative to the robot. */
 });
@@ -9,12 +9,30 @@
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Debugging/DebugDrawings3D.h"
 #include "ColorReference.h"
+#include <algorithm>
+#include <limits>
 
 BodyContour::Line::Line(const Vector2<int>& p1, const Vector2<int>& p2)
 : p1(p1.x < p2.x ? p1 : p2),
   p2(p1.x < p2.x ? p2 : p1) {}
 
-void BodyContour::clipBottom(int x, int& y) const
+void BodyContour::updateBottom()
+{
+  bottom.assign(std::max(0, cameraResolution.x), std::numeric_limits<int>::max());
+  for(const Line& line : lines)
+  {
+    // The same range and formula as in Line::yAt
+    const int xEnd = std::min(line.p2.x, cameraResolution.x);
+    for(int x = std::max(line.p1.x, 0); x < xEnd; ++x)
+    {
+      const int y = line.p1.y + (line.p2.y - line.p1.y) * (x - line.p1.x) / (line.p2.x - line.p1.x);
+      if(y < bottom[x])
+        bottom[x] = y;
+    }
+  }
+}
+
+void BodyContour::clipBottomWithLines(int x, int& y) const
 {
   int yIntersection;
   for(std::vector<Line>::const_iterator i = lines.begin(); i != lines.end(); ++i)
@@ -14,8 +14,11 @@
 * @class BodyContour
 * A class that represents the contour of the robot's body in the image.
 * The contour can be used to exclude the robot's body from image processing.
+* In addition to the lines, the lowest y coordinate that is not covered by the
+* body is kept for each column of the image. It is not streamed, but recomputed
+* from the lines when the contour is read.
 */
-STREAMABLE(BodyContour,
+class BodyContour : public Streamable
 {
 public:
   /** A class representing a line in 2-D space. */
@@ -69,14 +72,35 @@ public:
     (Vector2<int>) p2, /**< The right point of the line. */
   });
 
+  std::vector<Line> lines; /**< The clipping lines. */
+  Vector2<int> cameraResolution; /**< The resolution of the image the contour was computed for. */
+
+  BodyContour() {lines.reserve(50);}
+
+  /**
+  * The method recomputes the lowest valid y coordinate of each column of the image.
+  * It must be called whenever the lines or the camera resolution were changed.
+  */
+  void updateBottom();
+
   /**
   * The method clips the bottom y coordinate of a vertical line.
+  * For columns inside the image, this is a lookup.
   * @param x The x coordinate of the vertical line.
   * @param y The original y coordinate of the bottom of the vertical line.
   *          It will be replaced if necessary. Note that the resulting point
   *          can be outside the image!
   */
-  void clipBottom(int x, int& y) const;
+  void clipBottom(int x, int& y) const
+  {
+    if(x >= 0 && x < (int) bottom.size())
+    {
+      if(bottom[x] < y)
+        y = bottom[x];
+    }
+    else
+      clipBottomWithLines(x, y);
+  }
 
    /**
   * The method clips the bottom y coordinate of a vertical line.
@@ -116,11 +140,27 @@ public:
   int getMaxY() const;
 
   /** Creates drawings of the contour. */
-  void draw() const,
+  void draw() const;
 
-  (std::vector<Line>) lines, /**< The clipping lines. */
-  (Vector2<int>) cameraResolution, /**< Only for drawing. */
+private:
+  std::vector<int> bottom; /**< For each column, the highest intersection with a line or the maximum int if there is none. */
 
-  // Initialization
-  lines.reserve(50);
-});
+  /**
+  * The method clips the bottom y coordinate of a vertical line by intersecting
+  * it with all lines.
+  * @param x The x coordinate of the vertical line.
+  * @param y The original y coordinate of the bottom of the vertical line.
+  *          It will be replaced if necessary.
+  */
+  void clipBottomWithLines(int x, int& y) const;
+
+  virtual void serialize(In* in, Out* out)
+  {
+    STREAM_REGISTER_BEGIN;
+    STREAM(lines);
+    STREAM(cameraResolution);
+    STREAM_REGISTER_FINISH;
+    if(in)
+      updateBottom();
+  }
+};
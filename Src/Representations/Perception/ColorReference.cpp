@@ -1,11 +1,13 @@
 #include "ColorReference.h"
 #include "Tools/ImageProcessing/ColorModelConversions.h"
 #include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/MMX.h"
 #include "snappy-c.h"
+#include <cstring>
 
 /**
  * A table that maps YCbCr color values to HSI color values.
- * The resolution of this table is the one used by the ColorReference class.
+ * The resolution of this table is the finest one supported by the ColorReference class.
  */
 static class ColorSpaceMapper
 {
@@ -36,14 +38,143 @@ public:
   }
 } colorSpaceMapper;
 
+ColorReference::ColorReference() :
+  colorTable(colorTables[0]),
+  yIndex(yIndices[0]),
+  outdatedColors(0xff),
+  backgroundColors(0)
+{
+  setLayout(yCbCr, 8 - shiftFactor, 8 - shiftFactor, 8 - shiftFactor);
+}
+
+ColorReference::ColorReference(const ColorReference& other) :
+  colorTable(colorTables[0]),
+  yIndex(yIndices[0])
+{
+  *this = other;
+}
+
+ColorReference& ColorReference::operator=(const ColorReference& other)
+{
+  if(this == &other)
+    return *this;
+  colorTable = colorTables[0];
+  yIndex = yIndices[0];
+  setLayout(other.layout, other.yBits, other.cbBits, other.crBits);
+  memcpy(yIndex, other.yIndex, sizeof(yIndices[0]));
+  memcpy(colorTable, other.colorTable, other.getTableSize());
+  backgroundColors = 0;
+  changed = other.changed;
+  thresholdGreen = other.thresholdGreen;
+  thresholdYellow = other.thresholdYellow;
+  thresholdOrange = other.thresholdOrange;
+  thresholdRed = other.thresholdRed;
+  thresholdBlue = other.thresholdBlue;
+  thresholdWhite = other.thresholdWhite;
+  thresholdBlack = other.thresholdBlack;
+  return *this;
+}
+
 ColorReference::MultiColor ColorReference::getColorClasses(const Image::Pixel* pixel) const
 {
-  return colorTable[pixel->y>>shiftFactor]
-                   [pixel->cb>>shiftFactor]
-                   [pixel->cr>>shiftFactor];
+  if(fullResolution)
+    return colorTable[(pixel->y >> shiftFactor) * colorTableSize * colorTableSize +
+                      (pixel->cb >> shiftFactor) * colorTableSize +
+                      (pixel->cr >> shiftFactor)];
+  else
+    return colorTable[getIndex(*pixel)];
 }
 
-ColorReference::MultiColor ColorReference::getColorClassesFromHSI(const Image::Pixel& pixel) const
+void ColorReference::classifyRow(const Image::Pixel* pixel, int count, int step, unsigned char* colors) const
+{
+  if(!fullResolution)
+  {
+    classifyRowLookup(pixel, count, step, colors);
+    return;
+  }
+
+  static_assert(colorTableSize * colorTableSize <= 32767, "Table index factors must fit into 16 bits.");
+
+  // Per pixel (bytes yCbCrPadding, cb, y, cr): cb and y as 16 bit words, cr as 32 bit word.
+  static const __m128i cbYMask = _mm_setr_epi8(1, -1, 2, -1, 5, -1, 6, -1, 9, -1, 10, -1, 13, -1, 14, -1);
+  static const __m128i crMask = _mm_setr_epi8(3, -1, -1, -1, 7, -1, -1, -1, 11, -1, -1, -1, 15, -1, -1, -1);
+  static const __m128i factors = _mm_setr_epi16(colorTableSize, colorTableSize * colorTableSize,
+                                                colorTableSize, colorTableSize * colorTableSize,
+                                                colorTableSize, colorTableSize * colorTableSize,
+                                                colorTableSize, colorTableSize * colorTableSize);
+  int indices[4];
+
+  const unsigned char* end = colors + (count & ~3);
+  while(colors < end)
+  {
+    __m128i p;
+    if(step == 1)
+      p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixel));
+    else
+      p = _mm_setr_epi32(pixel[0].color, pixel[step].color, pixel[2 * step].color, pixel[3 * step].color);
+    pixel += 4 * step;
+
+    // index = (y >> shiftFactor) * colorTableSize^2 + (cb >> shiftFactor) * colorTableSize + (cr >> shiftFactor)
+    const __m128i cbY = _mm_srli_epi16(SHUFFLE(p, cbYMask), shiftFactor);
+    const __m128i cr = _mm_srli_epi32(SHUFFLE(p, crMask), shiftFactor);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), _mm_add_epi32(_mm_madd_epi16(cbY, factors), cr));
+
+    *colors++ = colorTable[indices[0]];
+    *colors++ = colorTable[indices[1]];
+    *colors++ = colorTable[indices[2]];
+    *colors++ = colorTable[indices[3]];
+  }
+
+  classifyRowScalar(pixel, count & 3, step, colors);
+}
+
+void ColorReference::classifyRowScalar(const Image::Pixel* pixel, int count, int step, unsigned char* colors) const
+{
+  for(const unsigned char* end = colors + count; colors < end; ++colors, pixel += step)
+    *colors = getColorClasses(pixel).colors;
+}
+
+void ColorReference::setLayout(Layout layout, int yBits, int cbBits, int crBits)
+{
+  this->layout = layout;
+  this->yBits = yBits;
+  this->cbBits = cbBits;
+  this->crBits = crBits;
+  updateIndexing();
+  outdatedColors = 0xff;
+}
+
+void ColorReference::updateIndexing()
+{
+  ASSERT(yBits >= 1 && yBits <= 8 - shiftFactor);
+  ASSERT(cbBits >= 1 && cbBits <= 8 - shiftFactor);
+  ASSERT(crBits >= 1 && crBits <= 8 - shiftFactor);
+
+  // the offsets of all values of a channel that share the same bits used are the same
+  for(int i = 0; i < 256; ++i)
+  {
+    const unsigned y = i >> (8 - yBits);
+    const unsigned cb = i >> (8 - cbBits);
+    const unsigned cr = i >> (8 - crBits);
+    if(layout == cbCrY)
+    {
+      yIndices[0][i] = yIndices[1][i] = y;
+      crIndex[i] = cr << yBits;
+      cbIndex[i] = cb << (yBits + crBits);
+    }
+    else
+    {
+      // the planes of yBuckets are not known before the table is computed
+      yIndices[0][i] = yIndices[1][i] = layout == yCbCr ? y << (cbBits + crBits) : 0;
+      crIndex[i] = cr;
+      cbIndex[i] = cb << crBits;
+    }
+  }
+
+  fullResolution = layout == yCbCr && yBits == 8 - shiftFactor && cbBits == 8 - shiftFactor && crBits == 8 - shiftFactor;
+}
+
+ColorReference::MultiColor ColorReference::getColorClassesFromHSI(const Image::Pixel& pixel, unsigned char colors) const
 {
   const Image::Pixel& hsi = colorSpaceMapper.fromYCbCrToHSI(pixel);
   float h = hsi.h * pi2/ 255.f;
@@ -52,42 +183,47 @@ ColorReference::MultiColor ColorReference::getColorClassesFromHSI(const Image::P
 
   MultiColor multiColor(0);
 
-  if(thresholdGreen.hue.isInside(h) &&
+  if((colors & green) &&
+     thresholdGreen.hue.isInside(h) &&
      thresholdGreen.saturation.isInside(s) &&
      thresholdGreen.value.isInside(v))
   {
     multiColor.colors |= green;
   }
 
-  if(thresholdOrange.hue.isInside(h) &&
+  if((colors & orange) &&
+     thresholdOrange.hue.isInside(h) &&
      thresholdOrange.saturation.isInside(s) &&
      thresholdOrange.value.isInside(v))
   {
     multiColor.colors |= orange;
   }
 
-  if(thresholdYellow.hue.isInside(h) &&
+  if((colors & yellow) &&
+     thresholdYellow.hue.isInside(h) &&
      thresholdYellow.saturation.isInside(s) &&
      thresholdYellow.value.isInside(v))
   {
     multiColor.colors |= yellow;
   }
 
-  if(thresholdBlue.hue.isInside(h) &&
+  if((colors & blue) &&
+     thresholdBlue.hue.isInside(h) &&
      thresholdBlue.saturation.isInside(s) &&
      thresholdBlue.value.isInside(v))
   {
     multiColor.colors |= blue;
   }
 
-  if(thresholdRed.hue.isInside(h) &&
+  if((colors & red) &&
+     thresholdRed.hue.isInside(h) &&
      thresholdRed.saturation.isInside(s) &&
      thresholdRed.value.isInside(v))
   {
     multiColor.colors |= red;
   }
 
-  if(!multiColor.isGreen())
+  if((colors & white) && !multiColor.isGreen())
   {
     unsigned char r, g, b;
     ColorModelConversions::fromYCbCrToRGB(pixel.y, pixel.cb, pixel.cr, r, g, b);
@@ -95,28 +231,88 @@ ColorReference::MultiColor ColorReference::getColorClassesFromHSI(const Image::P
       multiColor.colors |= white;
   }
 
-  if(pixel.cb == thresholdBlack.first && pixel.cr == thresholdBlack.second && pixel.y <= thresholdBlack.third)
+  if((colors & black) &&
+     pixel.cb == thresholdBlack.first && pixel.cr == thresholdBlack.second && pixel.y <= thresholdBlack.third)
     multiColor.colors |= black;
 
   return multiColor;
 }
 
-void ColorReference::update()
+void ColorReference::update(unsigned char colors)
+{
+  // white depends on whether a pixel is green
+  if(colors & (green | white))
+    colors |= green | white;
+  update(colors, colorTable, yIndex);
+  outdatedColors |= colors;
+}
+
+void ColorReference::updateInBackground(unsigned char colors)
+{
+  if(colors & (green | white))
+    colors |= green | white;
+  const int background = colorTable == colorTables[0] ? 1 : 0;
+  update(colors | outdatedColors, colorTables[background], yIndices[background]);
+  outdatedColors = 0;
+  backgroundColors |= colors;
+}
+
+void ColorReference::swapColorTables()
 {
+  // the table that was in use lacks the color classes just updated
+  const int background = colorTable == colorTables[0] ? 1 : 0;
+  colorTable = colorTables[background];
+  yIndex = yIndices[background];
+  outdatedColors = backgroundColors;
+  backgroundColors = 0;
+}
+
+void ColorReference::update(unsigned char colors, unsigned char* table, unsigned* yIndex) const
+{
+  // each entry is computed for the smallest pixel value it represents
+  const int yStep = 1 << (8 - yBits);
+  const int cbStep = 1 << (8 - cbBits);
+  const int crStep = 1 << (8 - crBits);
   Image::Pixel p;
 
-  for(int y = 0; y < colorTableSize; ++y)
+  if(layout == yBuckets)
   {
-    for(int cb = 0; cb < colorTableSize; ++cb)
+    // Each plane is computed behind the last one. It is only kept if it differs from it.
+    const unsigned planeSize = 1 << (cbBits + crBits);
+    unsigned end = 0;
+    for(int y = 0; y < 256; y += yStep)
     {
-      for(int cr = 0; cr < colorTableSize; ++cr)
+      unsigned char* entry = table + end;
+      p.y = (unsigned char) y;
+      for(int cb = 0; cb < 256; cb += cbStep)
       {
-        p.y   = (unsigned char)(y<<shiftFactor);
-        p.cb  = (unsigned char)(cb<<shiftFactor);
-        p.cr  = (unsigned char)(cr<<shiftFactor);
+        p.cb = (unsigned char) cb;
+        for(int cr = 0; cr < 256; cr += crStep)
+        {
+          p.cr = (unsigned char) cr;
+          *entry++ = getColorClassesFromHSI(p).colors;
+        }
+      }
+      if(!end || memcmp(table + end - planeSize, table + end, planeSize))
+        end += planeSize;
+      for(int i = y; i < y + yStep; ++i)
+        yIndex[i] = end - planeSize;
+    }
+    return;
+  }
 
-        ColorReference::MultiColor colors = getColorClassesFromHSI(p);
-        colorTable[y][cb][cr] = colors.colors;
+  const unsigned char keep = (unsigned char) ~colors;
+  for(int y = 0; y < 256; y += yStep)
+  {
+    p.y = (unsigned char) y;
+    for(int cb = 0; cb < 256; cb += cbStep)
+    {
+      p.cb = (unsigned char) cb;
+      for(int cr = 0; cr < 256; cr += crStep)
+      {
+        p.cr = (unsigned char) cr;
+        unsigned char& entry = table[yIndex[y] + cbIndex[cb] + crIndex[cr]];
+        entry = (unsigned char) ((entry & keep) | getColorClassesFromHSI(p, colors).colors);
       }
     }
   }
@@ -125,7 +321,23 @@ void ColorReference::update()
 void ColorReference::serialize(In* in, Out* out)
 {
   STREAM_REGISTER_BEGIN;
-  size_t ctUncompressedSize = (int) pow(colorTableSize*sizeof(colorTable[0][0][0]), 3);
+  STREAM(layout, ColorReference);
+  STREAM(yBits);
+  STREAM(cbBits);
+  STREAM(crBits);
+  if(in)
+    updateIndexing();
+
+  // the planes of the layout yBuckets are needed to know the size of the color table
+  if(layout == yBuckets)
+  {
+    if(out)
+      out->write(yIndex, sizeof(yIndices[0]));
+    else if(in)
+      in->read(yIndex, sizeof(yIndices[0]));
+  }
+
+  size_t ctUncompressedSize = getTableSize() * sizeof(colorTable[0]);
   size_t ctCompressedSize = 0;
   std::vector<char> ctCompressed;
 
@@ -137,7 +349,7 @@ void ColorReference::serialize(In* in, Out* out)
 
     // compress
     const snappy_status status =
-      snappy_compress((char*) &colorTable[0][0][0], ctUncompressedSize, ctCompressed.data(), &ctCompressedSize);
+      snappy_compress((char*) colorTable, ctUncompressedSize, ctCompressed.data(), &ctCompressedSize);
     VERIFY(status == SNAPPY_OK);
 
     // stream
@@ -155,8 +367,9 @@ void ColorReference::serialize(In* in, Out* out)
 
     // uncompress
     const snappy_status status =
-      snappy_uncompress(ctCompressed.data(), ctCompressedSize, (char*) &colorTable[0][0][0], &ctUncompressedSize);
+      snappy_uncompress(ctCompressed.data(), ctCompressedSize, (char*) colorTable, &ctUncompressedSize);
     VERIFY(status == SNAPPY_OK);
+    outdatedColors = 0xff;
   }
   else
     ASSERT(false);
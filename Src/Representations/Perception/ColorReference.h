@@ -9,6 +9,7 @@
 #include "Representations/Infrastructure/Image.h"
 #include "Tools/ColorClasses.h"
 #include "Tools/Range.h"
+#include "Tools/Enum.h"
 
 class ColorReference : public Streamable
 {
@@ -19,9 +20,28 @@ friend class ThresholdSelector;
 friend class ColorCalibrationWidget;
 
 public:
-  static const unsigned char shiftFactor = 1;
+  static const unsigned char shiftFactor = 1; /**< The finest resolution of the color table (7 bits per channel). */
   static const unsigned char colorTableSize = 256 >> shiftFactor;
 
+  /**
+   * The order in which the channels form the index of the color table.
+   * The last channel changes fastest, i.e. neighboring values of this
+   * channel are neighbors in memory.
+   */
+  ENUM(Layout,
+    yCbCr, /**< Brightness first. Pixels of the same color but different brightness are far apart. */
+    cbCrY, /**< Brightness last. Pixels of the same color but different brightness share cache lines. */
+    yBuckets /**< Brightness first, but successive brightness values with the same cb/cr plane share a single copy of it. */
+  );
+
+  ColorReference();
+
+  /** Copies the thresholds and the color table in use. */
+  ColorReference(const ColorReference& other);
+
+  /** Copies the thresholds and the color table in use. */
+  ColorReference& operator=(const ColorReference& other);
+
   /**
    * This class describes thresholds for a color.
    * first, second and third are the typical component of a color,
@@ -150,6 +170,33 @@ public:
 
   ColorReference::MultiColor getColorClasses(const Image::Pixel* pixel) const;
 
+  /**
+   * Classifies a sequence of pixels. The color table indices of four pixels are
+   * computed at once using SSSE3 shuffles. Color tables with another layout or
+   * resolution look up the offsets of the channels instead.
+   * @param pixel The first pixel.
+   * @param count The number of pixels to classify.
+   * @param step The distance between two successive pixels in the image buffer,
+   *             i.e. 1 for a row and Image::widthStep for a column.
+   * @param colors The color classes of the pixels (as MultiColor::colors) are written
+   *               to this array. It must provide space for count entries.
+   */
+  void classifyRow(const Image::Pixel* pixel, int count, int step, unsigned char* colors) const;
+
+  /**
+   * Classifies a sequence of pixels one by one using getColorClasses.
+   * Same parameters and results as classifyRow.
+   */
+  void classifyRowScalar(const Image::Pixel* pixel, int count, int step, unsigned char* colors) const;
+
+  Layout getLayout() const {return layout;}
+
+  /** The number of bytes of the color table that are actually used. */
+  unsigned getTableSize() const
+  {
+    return layout == yBuckets ? yIndex[255] + (1 << (cbBits + crBits)) : 1 << (yBits + cbBits + crBits);
+  }
+
 private:
   static const unsigned char none = 0;
   static const unsigned char orange = 1 << (ColorClasses::orange - 1);
@@ -160,10 +207,24 @@ private:
   static const unsigned char black = 1 << (ColorClasses::black - 1);
   static const unsigned char red = 1 << (ColorClasses::red - 1);
 
-  // color table
-  unsigned char colorTable[colorTableSize][colorTableSize][colorTableSize];
+  // color tables: the one in use and one that can be updated while the other one is used
+  unsigned char colorTables[2][colorTableSize * colorTableSize * colorTableSize];
+  unsigned char* colorTable; /**< The color table in use, i.e. one of the colorTables. */
+  unsigned char outdatedColors; /**< The color classes (as MultiColor::colors) that are outdated in the color table not in use. */
+  unsigned char backgroundColors; /**< The color classes updated in the color table not in use since the last swap. */
   bool changed;
 
+  // layout of color table
+  Layout layout;
+  int yBits; /**< The number of bits of y used for the index (1..7). */
+  int cbBits; /**< The number of bits of cb used for the index (1..7). */
+  int crBits; /**< The number of bits of cr used for the index (1..7). */
+  unsigned yIndices[2][256]; /**< For each of the colorTables, the offset of the entries of each y value. */
+  unsigned* yIndex; /**< The offsets of y for the color table in use, i.e. one of the yIndices. */
+  unsigned cbIndex[256]; /**< The offset of the entries of each cb value. */
+  unsigned crIndex[256]; /**< The offset of the entry of each cr value. */
+  bool fullResolution; /**< Is the layout yCbCr with the finest resolution of all channels? Then, the index is computed directly. */
+
   // thresholds for color
   HSVColorDefinition thresholdGreen;
   HSVColorDefinition thresholdYellow;
@@ -173,7 +234,79 @@ private:
   ColorThreshold<int> thresholdWhite; // minR, minB, minRB
   ColorThreshold<int> thresholdBlack; // cb, cr, maxY
 
-  ColorReference::MultiColor getColorClassesFromHSI(const Image::Pixel& pixel) const;
-  void update();
+  /**
+   * Sets the layout and the resolution of the color table.
+   * The color table must be recomputed afterwards.
+   * @param layout The order of the channels in the index.
+   * @param yBits The number of bits of y used for the index (1..7).
+   * @param cbBits The number of bits of cb used for the index (1..7).
+   * @param crBits The number of bits of cr used for the index (1..7).
+   */
+  void setLayout(Layout layout, int yBits, int cbBits, int crBits);
+
+  /**
+   * Computes the offsets of the channels from the layout and the resolution.
+   * The offsets of y of the layout yBuckets are only determined when the color
+   * table is computed.
+   */
+  void updateIndexing();
+
+  /**
+   * Classifies a sequence of pixels if the color table does not have the finest resolution
+   * and the layout yCbCr. Same parameters and results as classifyRow.
+   */
+  void classifyRowLookup(const Image::Pixel* pixel, int count, int step, unsigned char* colors) const
+  {
+    for(const unsigned char* end = colors + count; colors < end; ++colors, pixel += step)
+      *colors = colorTable[getIndex(*pixel)];
+  }
+
+  /** Computes the index of a pixel in the color table in use from the offsets of its channels. */
+  unsigned getIndex(const Image::Pixel& pixel) const
+  {
+    return yIndex[pixel.y] + cbIndex[pixel.cb] + crIndex[pixel.cr];
+  }
+
+  /**
+   * Determines the color classes of a pixel from the thresholds.
+   * @param pixel The pixel in YCbCr.
+   * @param colors Only these color classes (as MultiColor::colors) are checked.
+   * @return The color classes among "colors" the pixel belongs to.
+   */
+  ColorReference::MultiColor getColorClassesFromHSI(const Image::Pixel& pixel, unsigned char colors = 0xff) const;
+
+  /** Recomputes the whole color table. */
+  void update() {update(0xff);}
+
+  /**
+   * Recomputes only some color classes in the color table in use. The bits of all other
+   * color classes remain unchanged. Since white is only assigned to pixels that
+   * are not green, white and green are always recomputed together. The layout
+   * yBuckets is always recomputed completely, because the planes shared depend
+   * on all color classes.
+   * @param colors The color classes (as MultiColor::colors) whose thresholds changed.
+   */
+  void update(unsigned char colors);
+
+  /**
+   * Recomputes some color classes in the color table that is not in use, e.g. in a
+   * worker thread while the other table is still used. The color classes that are
+   * outdated in this table are recomputed as well. The thresholds must not change
+   * until swapColorTables() was called.
+   * @param colors The color classes (as MultiColor::colors) whose thresholds changed.
+   */
+  void updateInBackground(unsigned char colors);
+
+  /** Makes the color table updated by updateInBackground the one in use. Only a pointer is changed. */
+  void swapColorTables();
+
+  /**
+   * Recomputes some color classes in a color table.
+   * @param colors The color classes (as MultiColor::colors) to recompute.
+   * @param table The color table. Bits of other color classes remain unchanged.
+   * @param yIndex The offsets of y of this table. They are determined here for the layout yBuckets.
+   */
+  void update(unsigned char colors, unsigned char* table, unsigned* yIndex) const;
+
   virtual void serialize(In* in, Out* out);
 };
\ No newline at end of file
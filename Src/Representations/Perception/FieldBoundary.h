@@ -40,6 +40,7 @@ public:
   (InImage) boundarySpots,     ///< Spots on the boundary.
   (InImage) convexBoundary,    ///< A convex upper hull arround the spots that schould fit best the actual boundary.
   (InField) boundaryOnField,   ///< The boundary projectet to the Field in relative coordinates.
+  (InField) lowerCamConvexHullOnField, ///< The convex boundary of the last lower image on the field. The next upper image uses it.
   (InImage) boundaryInImage,   ///< The boundary in image coordinates.
   (Vector2<int>) highestPoint, ///< The highest pont of the boundary.
   (bool)(false) isValid,	   ///< True if a boundary could be detected.
@@ -20,7 +20,6 @@
 */
 STREAMABLE(ImageCoordinateSystem,
 {
-  CameraInfo cameraInfo;
   int* xTable;
   int* yTable;
   int table[6144];
@@ -245,6 +244,7 @@ public:
   (Vector2<>) offset, /**< The offset of the previous image to the current one. */
   (float)(0) a, /**< Constant part of equation to motion distortion. */
   (float)(0) b, /**< Linear part of equation to motion distortion. */
+  (CameraInfo) cameraInfo, /**< The camera the coordinate system refers to. It is streamed, because the corrections depend on it. */
 
   // Initialization
   xTable = yTable = 0;
@@ -0,0 +1,98 @@
+/**
+* @file ImagePyramid.h
+* Declaration of a class that contains the camera image in several lower resolutions.
+* Each level halves the width and the height of the previous one by averaging
+* blocks of 2x2 pixels. Coarse searches can run on a low level and only refine
+* their results on the full resolution image.
+*/
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include "Representations/Infrastructure/Image.h"
+#include "Platform/BHAssert.h"
+#include <vector>
+
+class ImagePyramid : public Streamable
+{
+public:
+  /**
+  * An image of a single level of the pyramid.
+  */
+  class Level : public Streamable
+  {
+  public:
+    int width; /**< The width of this level in pixels. */
+    int height; /**< The height of this level in pixels. */
+    std::vector<Image::Pixel> pixels; /**< The pixels of all rows without any gaps. */
+
+    Level() : width(0), height(0) {}
+
+    /**
+    * Sets the resolution of this level.
+    * @param width The new width in pixels.
+    * @param height The new height in pixels.
+    */
+    void setResolution(int width, int height)
+    {
+      this->width = width;
+      this->height = height;
+      pixels.resize(width * height);
+    }
+
+    Image::Pixel* operator[](int y) {return pixels.data() + y * width;}
+    const Image::Pixel* operator[](int y) const {return pixels.data() + y * width;}
+
+  private:
+    virtual void serialize(In* in, Out* out)
+    {
+      STREAM_REGISTER_BEGIN;
+      STREAM(width);
+      STREAM(height);
+      if(out)
+        out->write(pixels.data(), width * height * sizeof(Image::Pixel));
+      else
+      {
+        setResolution(width, height);
+        in->read(pixels.data(), width * height * sizeof(Image::Pixel));
+      }
+      STREAM_REGISTER_FINISH;
+    }
+  };
+
+  enum {numOfLevels = 3}; /**< The number of levels, i.e. the lowest resolution is 1/8 of the image. */
+
+  /**
+  * Returns a level of the pyramid.
+  * @param level The level. 1 is half of the resolution of the image, 2 a quarter,
+  *              and numOfLevels the lowest resolution.
+  * @return The image of this level.
+  */
+  const Level& operator[](int level) const
+  {
+    ASSERT(level > 0 && level <= numOfLevels);
+    return levels[level - 1];
+  }
+
+  /**
+  * Returns the factor by which the coordinates of a level must be multiplied
+  * to get the coordinates in the image.
+  * @param level The level.
+  * @return The scale, i.e. 2 to the power of the level.
+  */
+  static int getScale(int level) {return 1 << level;}
+
+  Level levels[numOfLevels]; /**< The levels with decreasing resolutions. */
+  unsigned timeStamp; /**< The time stamp of the image the pyramid was built from. */
+
+  ImagePyramid() : timeStamp(0) {}
+
+private:
+  virtual void serialize(In* in, Out* out)
+  {
+    STREAM_REGISTER_BEGIN;
+    STREAM(timeStamp);
+    STREAM(levels);
+    STREAM_REGISTER_FINISH;
+  }
+};
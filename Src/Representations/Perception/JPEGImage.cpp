@@ -9,6 +9,7 @@
 #include "Tools/MMX.h"
 #include "Tools/Debugging/Stopwatch.h"
 #include "Platform/SystemCall.h"
+#include <cstring>
 
 JPEGImage::JPEGImage(const Image& image)
 {
@@ -20,8 +21,87 @@ JPEGImage& JPEGImage::operator=(const Image& src)
   setResolution(src.width, src.height);
   timeStamp = src.timeStamp;
   unsigned char* aiboAlignedImage = (unsigned char*) SystemCall::alignedMalloc(width * height * 3, 16);
-  toAiboAlignment((const unsigned char*)src[0], aiboAlignedImage);
+  toAiboAlignment(src, 0, height, aiboAlignedImage);
+  size = compress(aiboAlignedImage, width, height, (unsigned char*)(*this)[0], width * height);
+  SystemCall::alignedFree(aiboAlignedImage);
+
+  return *this;
+}
+
+void JPEGImage::compressSlice(const Image& src, int yStart, int yEnd, std::vector<unsigned char>& dest)
+{
+  const int height = yEnd - yStart;
+  unsigned char* aiboAlignedImage = (unsigned char*) SystemCall::alignedMalloc(src.width * height * 3, 16);
+  toAiboAlignment(src, yStart, yEnd, aiboAlignedImage);
+  dest.resize(src.width * height + 1024); // same ratio as for complete images plus space for the header
+  dest.resize(compress(aiboAlignedImage, src.width, height, dest.data(), unsigned(dest.size())));
+  SystemCall::alignedFree(aiboAlignedImage);
+}
+
+/**
+* The function searches for a marker in the header of a JPEG stream.
+* @param stream The JPEG stream.
+* @param marker The second byte of the marker.
+* @return The offset of the marker in the stream.
+*/
+static size_t findMarker(const std::vector<unsigned char>& stream, unsigned char marker)
+{
+  size_t pos = 2; // skip SOI
+  while(stream[pos + 1] != marker)
+  {
+    ASSERT(stream[pos] == 0xff && stream[pos + 1] != 0xda); // not found before the scan
+    pos += 2 + (stream[pos + 2] << 8 | stream[pos + 3]);
+  }
+  return pos;
+}
 
+void JPEGImage::combineSlices(const Image& src, const std::vector<std::vector<unsigned char> >& slices, int sliceHeight)
+{
+  ASSERT(!slices.empty());
+  ASSERT(sliceHeight % 8 == 0);
+  setResolution(src.width, src.height);
+  timeStamp = src.timeStamp;
+
+  // The header of the first slice is used with the height of the whole image and
+  // a restart interval that contains all blocks of a slice.
+  const std::vector<unsigned char>& first = slices.front();
+  const size_t sof = findMarker(first, 0xc0);
+  const size_t sos = findMarker(first, 0xda);
+  const unsigned restartInterval = sliceHeight / 8 * ((width * 3 + 7) / 8);
+  ASSERT(restartInterval < 0x10000);
+
+  unsigned char* dest = (unsigned char*)(*this)[0];
+  unsigned char* p = dest;
+  memcpy(p, first.data(), sos);
+  p[sof + 5] = (unsigned char) (height >> 8);
+  p[sof + 6] = (unsigned char) height;
+  p += sos;
+  const unsigned char dri[] = {0xff, 0xdd, 0, 4, (unsigned char) (restartInterval >> 8), (unsigned char) restartInterval};
+  memcpy(p, dri, sizeof(dri));
+  p += sizeof(dri);
+
+  // The scans of all slices without their EOI markers are separated by restart markers.
+  for(size_t i = 0; i < slices.size(); ++i)
+  {
+    const std::vector<unsigned char>& slice = slices[i];
+    size_t start = i ? findMarker(slice, 0xda) : sos;
+    if(i)
+    {
+      start += 2 + (slice[start + 2] << 8 | slice[start + 3]); // skip SOS segment
+      *p++ = 0xff;
+      *p++ = (unsigned char) (0xd0 + (i - 1) % 8);
+    }
+    ASSERT(slice[slice.size() - 2] == 0xff && slice[slice.size() - 1] == 0xd9);
+    memcpy(p, slice.data() + start, slice.size() - 2 - start);
+    p += slice.size() - 2 - start;
+  }
+  *p++ = 0xff;
+  *p++ = 0xd9;
+  size = unsigned(p - dest);
+}
+
+unsigned JPEGImage::compress(const unsigned char* src, int width, int height, unsigned char* dest, unsigned capacity)
+{
   jpeg_compress_struct cInfo;
   jpeg_error_mgr jem;
   cInfo.err = jpeg_std_error(&jem);
@@ -33,8 +113,8 @@ JPEGImage& JPEGImage::operator=(const Image& src)
   cInfo.dest->init_destination = onDestIgnore;
   cInfo.dest->empty_output_buffer = onDestEmpty;
   cInfo.dest->term_destination = onDestIgnore;
-  cInfo.dest->next_output_byte = (JOCTET*)(*this)[0];
-  cInfo.dest->free_in_buffer = width * height;
+  cInfo.dest->next_output_byte = dest;
+  cInfo.dest->free_in_buffer = capacity;
 
   cInfo.image_width = width * 3;
   cInfo.image_height = height;
@@ -49,16 +129,14 @@ JPEGImage& JPEGImage::operator=(const Image& src)
 
   while(cInfo.next_scanline < cInfo.image_height)
   {
-    JSAMPROW rowPointer = const_cast<JSAMPROW>(&aiboAlignedImage[cInfo.next_scanline * cInfo.image_width]);
+    JSAMPROW rowPointer = const_cast<JSAMPROW>(&src[cInfo.next_scanline * cInfo.image_width]);
     jpeg_write_scanlines(&cInfo, &rowPointer, 1);
   }
 
   jpeg_finish_compress(&cInfo);
-  size = (char unsigned*) cInfo.dest->next_output_byte - (unsigned char*)(*this)[0];
+  const unsigned size = unsigned(cInfo.dest->next_output_byte - dest);
   jpeg_destroy_compress(&cInfo);
-  SystemCall::alignedFree(aiboAlignedImage);
-
-  return *this;
+  return size;
 }
 
 void JPEGImage::toImage(Image& dest) const
@@ -161,8 +239,9 @@ void JPEGImage::serialize(In* in, Out* out)
   STREAM_REGISTER_FINISH;
 }
 
-void JPEGImage::toAiboAlignment(const unsigned char* src, unsigned char* dst) const
+void JPEGImage::toAiboAlignment(const Image& src, int yStart, int yEnd, unsigned char* dst)
 {
+  const int width = src.width;
   ASSERT(width % 16 == 0);
 
   unsigned char mask[16] =
@@ -191,11 +270,11 @@ void JPEGImage::toAiboAlignment(const unsigned char* src, unsigned char* dst) co
   __m128i mHighCr;
 
 
-  for(int y = 0; y < height; ++y)
+  for(int y = yStart; y < yEnd; ++y)
   {
-    pSrc = (__m128i*)(src + y * widthStep * 4);
-    pSrcLineEnd = (__m128i*)(src + y * widthStep * 4 + (width * 4));
-    pDst = (__m128i*)(dst + y * width * 3);
+    pSrc = (const __m128i*) src[y];
+    pSrcLineEnd = (const __m128i*) (src[y] + width);
+    pDst = (__m128i*)(dst + (y - yStart) * width * 3);
     for(; pSrc < pSrcLineEnd; pSrc += 4, ++pDst)
     {
       p0 = _mm_loadu_si128(pSrc);       // yPadd1 cb1 y1 cr1 yPadd2 cb2 y2 cr2 yPadd3 cb3 y3 cr3 yPadd4 cb4 y4 cr4
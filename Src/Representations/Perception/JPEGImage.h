@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Representations/Infrastructure/Image.h"
+#include <vector>
 
 #ifdef WIN32
 
@@ -77,14 +78,50 @@ public:
   */
   void toImage(Image& dest) const;
 
+  /**
+  * Compresses a horizontal slice of an image into a separate JPEG stream.
+  * The method does not access any global data, so slices can be compressed
+  * in parallel by different threads.
+  * @param src The image.
+  * @param yStart The first row of the slice.
+  * @param yEnd The row after the last row of the slice.
+  * @param dest Will receive the JPEG stream.
+  */
+  static void compressSlice(const Image& src, int yStart, int yEnd, std::vector<unsigned char>& dest);
+
+  /**
+  * Combines the JPEG streams of the slices of an image into this image.
+  * Each slice becomes a restart interval of a single JPEG stream, so the
+  * result is decompressed like any other JPEG image.
+  * @param src The image the slices were compressed from. Only its resolution
+  *            and its time stamp are used.
+  * @param slices The JPEG streams of the slices from top to bottom.
+  * @param sliceHeight The height of all slices except for the last one, which
+  *                    may be lower. It must be a multiple of 8.
+  */
+  void combineSlices(const Image& src, const std::vector<std::vector<unsigned char> >& slices, int sliceHeight);
+
 private:
+  /**
+  * Compresses an image in Aibo's alignment.
+  * @param src The image in Aibo's alignment.
+  * @param width The width of the image in pixels.
+  * @param height The height of the image.
+  * @param dest Will receive the JPEG stream.
+  * @param capacity The number of bytes available in dest.
+  * @return The size of the JPEG stream.
+  */
+  static unsigned compress(const unsigned char* src, int width, int height, unsigned char* dest, unsigned capacity);
+
   /**
   * Convert image from Nao's alignment (YUV422) to Aibo's alignment (one channel per line)
   * destination is asserted to be allocated
-  * @param src Pointer to the source image in Nao's alignment
+  * @param src The source image in Nao's alignment
+  * @param yStart The first row converted.
+  * @param yEnd The row after the last row converted.
   * @param dst Pointer to the destination image
   */
-  void toAiboAlignment(const unsigned char* src, unsigned char* dst) const;
+  static void toAiboAlignment(const Image& src, int yStart, int yEnd, unsigned char* dst);
 
   /**
   * Convert image from Aibo's alignment (one channel per line) to Nao's alignment (YUV422)
@@ -10,7 +10,6 @@
 #include "Representations/Perception/ImageCoordinateSystem.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Configuration/FieldDimensions.h"
-#include <list>
 
 /**
 * @class LinePercept
@@ -81,9 +80,8 @@ public:
    */
   STREAMABLE(CircleSpot,
   {
-    friend class LinePerceptor; // Access to iterator
-    std::list<LineSegment>::iterator iterator, /**< An temporary iterator pointing to the according segment
-                                                    in the singleSegs list */
+    friend class LinePerceptor; // Access to segment
+    int segment, /**< A temporary index of the according segment in the singleSegs list of the LinePerceptor */
     (Vector2<float>) pos, /**< The position of the center of the center circle in field coordinates */
     (bool)(false) found, /**< Whether the center circle was found in this frame */
     (unsigned)(0) lastSeen, /**< The last time the center circle was seen */
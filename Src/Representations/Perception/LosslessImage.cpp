@@ -0,0 +1,363 @@
+/**
+ * @file LosslessImage.cpp
+ *
+ * Implementation of class LosslessImage
+ */
+
+#include "LosslessImage.h"
+#include "Platform/BHAssert.h"
+#include <algorithm>
+#include <cstring>
+
+/** The modes of a compressed image. */
+enum Mode : unsigned char
+{
+  stored, /**< The channels are stored uncompressed, because compressing did not reduce the size. */
+  predicted /**< The channels are predicted and the errors are Golomb-Rice coded. */
+};
+
+static const int maxUnary = 24; /**< Mapped errors whose quotient reaches this are stored in 8 bits. */
+static const int numOfActivities = 10; /**< The number of classes of local activity, i.e. bit lengths of 0..510. */
+
+/**
+ * Writes bit strings to a buffer, the most significant bit first.
+ */
+class BitWriter
+{
+private:
+  unsigned long long bits; /**< The bits not written yet in the lowest positions. */
+  int count; /**< The number of bits not written yet. */
+
+public:
+  unsigned char* p; /**< The next byte written. */
+
+  BitWriter(unsigned char* p) : bits(0), count(0), p(p) {}
+
+  /**
+  * Appends bits.
+  * @param value The bits in the lowest positions.
+  * @param n The number of bits. At most 32.
+  */
+  void write(unsigned value, int n)
+  {
+    bits = bits << n | value;
+    count += n;
+    while(count >= 8)
+    {
+      count -= 8;
+      *p++ = (unsigned char) (bits >> count);
+    }
+  }
+
+  /** Writes the remaining bits, padded with zeros to a full byte. */
+  void flush()
+  {
+    if(count)
+      write(0, 8 - count);
+  }
+};
+
+/**
+ * Reads bit strings written by a BitWriter.
+ */
+class BitReader
+{
+private:
+  unsigned long long bits; /**< The bits read ahead in the highest positions. */
+  int count; /**< The number of bits read ahead. */
+  const unsigned char* p; /**< The next byte read. */
+  const unsigned char* end; /**< The end of the buffer. */
+
+public:
+  BitReader(const unsigned char* p, const unsigned char* end) : bits(0), count(0), p(p), end(end) {}
+
+  /** Reads ahead so that at least 57 bits are available. */
+  void fill()
+  {
+    for(; count <= 56; count += 8)
+      bits |= (unsigned long long) (p < end ? *p++ : 0) << (56 - count);
+  }
+
+  /**
+  * Reads bits. fill() must have been called before.
+  * @param n The number of bits. At most 32.
+  * @return The bits in the lowest positions.
+  */
+  unsigned read(int n)
+  {
+    const unsigned value = n ? unsigned(bits >> (64 - n)) : 0;
+    bits <<= n;
+    count -= n;
+    return value;
+  }
+
+  /**
+  * Reads a unary code, i.e. ones terminated by a zero. fill() must have been called before.
+  * @param max The maximum number of ones. The code is not terminated if it is reached.
+  * @return The number of ones.
+  */
+  int readUnary(int max)
+  {
+    const int ones = std::min(~bits ? __builtin_clzll(~bits) : 64, max);
+    read(ones < max ? ones + 1 : ones);
+    return ones;
+  }
+};
+
+/**
+ * The statistics of the errors of a class of samples. They determine the
+ * parameter of the Golomb-Rice code.
+ */
+class Context
+{
+private:
+  unsigned sum; /**< The sum of the mapped errors. */
+  unsigned n; /**< The number of errors summed up. */
+
+public:
+  Context() : sum(4), n(1) {}
+
+  /**
+  * Returns the parameter k of the Golomb-Rice code, i.e. the number of bits
+  * stored directly.
+  */
+  int getK() const
+  {
+    int k = 0;
+    while((n << k) < sum && k < 7)
+      ++k;
+    return k;
+  }
+
+  /**
+  * Adds a mapped error. Older errors lose influence over time.
+  */
+  void update(int error)
+  {
+    sum += error;
+    if(++n == 64)
+    {
+      sum >>= 1;
+      n >>= 1;
+    }
+  }
+};
+
+/**
+ * Predicts a sample from its neighbors like the median edge detector of JPEG-LS,
+ * i.e. the median of a, b, and a + b - c.
+ * @param a The left neighbor.
+ * @param b The upper neighbor.
+ * @param c The upper left neighbor.
+ * @return The prediction.
+ */
+static inline int predict(int a, int b, int c)
+{
+  return std::max(std::min(a, b), std::min(std::max(a, b), a + b - c));
+}
+
+/**
+ * Determines the class of local activity of a sample.
+ * @return The bit length of the sum of the gradients.
+ */
+static inline int getActivity(int a, int b, int c)
+{
+  const unsigned gradient = std::abs(a - c) + std::abs(b - c);
+  return gradient ? 32 - __builtin_clz(gradient) : 0;
+}
+
+/**
+ * Encodes a sample.
+ * @param value The sample.
+ * @param a The left neighbor.
+ * @param b The upper neighbor.
+ * @param c The upper left neighbor.
+ * @param contexts The statistics of the channel of the sample.
+ * @param out The writer that receives the code.
+ */
+static inline void encode(int value, int a, int b, int c, Context* contexts, BitWriter& out)
+{
+  const signed char error = (signed char) (value - predict(a, b, c));
+  const int mapped = error >= 0 ? 2 * error : -2 * error - 1;
+  Context& context = contexts[getActivity(a, b, c)];
+  const int k = context.getK();
+  const int quotient = mapped >> k;
+  if(quotient < maxUnary)
+    out.write(((2u << quotient) - 2) << k | (mapped & ((1 << k) - 1)), quotient + 1 + k);
+  else
+  {
+    out.write((1u << maxUnary) - 1, maxUnary);
+    out.write(mapped, 8);
+  }
+  context.update(mapped);
+}
+
+/**
+ * Decodes a sample.
+ * @param a The left neighbor.
+ * @param b The upper neighbor.
+ * @param c The upper left neighbor.
+ * @param contexts The statistics of the channel of the sample.
+ * @param in The reader that provides the code.
+ * @return The sample.
+ */
+static inline unsigned char decode(int a, int b, int c, Context* contexts, BitReader& in)
+{
+  Context& context = contexts[getActivity(a, b, c)];
+  const int k = context.getK();
+  in.fill();
+  const int quotient = in.readUnary(maxUnary);
+  const int mapped = quotient < maxUnary ? quotient << k | in.read(k) : in.read(8);
+  context.update(mapped);
+  return (unsigned char) (predict(a, b, c) + (mapped & 1 ? -((mapped + 1) >> 1) : mapped >> 1));
+}
+
+/**
+ * Compresses a plane. The first row is predicted from the left neighbors
+ * and the first column from the upper neighbors.
+ * @param plane The samples of all rows without gaps.
+ * @param width The number of samples per row.
+ * @param height The number of rows.
+ * @param phases The number of interleaved channels (1 or 2), each with its own statistics.
+ * @param out The writer that receives the codes.
+ * @param limit Compressing is stopped when the writer reaches this address.
+ * @return Did the compressed plane fit into the buffer?
+ */
+static bool compressPlane(const unsigned char* plane, int width, int height, int phases, BitWriter& out, const unsigned char* limit)
+{
+  Context contexts[2][numOfActivities];
+  const int phaseMask = phases - 1;
+  int left = 128;
+  for(int x = 0; x < width; ++x)
+  {
+    encode(plane[x], left, left, left, contexts[x & phaseMask], out);
+    left = plane[x];
+  }
+  for(const unsigned char* above = plane, * row = plane + width, * end = plane + width * height; row < end; above = row, row += width)
+  {
+    encode(row[0], above[0], above[0], above[0], contexts[0], out);
+    for(int x = 1; x < width; ++x)
+      encode(row[x], row[x - 1], above[x], above[x - 1], contexts[x & phaseMask], out);
+    if(out.p >= limit)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Uncompresses a plane.
+ * @param plane Receives the samples of all rows without gaps.
+ * @param width The number of samples per row.
+ * @param height The number of rows.
+ * @param phases The number of interleaved channels (1 or 2), each with its own statistics.
+ * @param in The reader that provides the codes.
+ */
+static void uncompressPlane(unsigned char* plane, int width, int height, int phases, BitReader& in)
+{
+  Context contexts[2][numOfActivities];
+  const int phaseMask = phases - 1;
+  int left = 128;
+  for(int x = 0; x < width; ++x)
+    left = plane[x] = decode(left, left, left, contexts[x & phaseMask], in);
+  for(unsigned char* above = plane, * row = plane + width, * end = plane + width * height; row < end; above = row, row += width)
+  {
+    row[0] = decode(above[0], above[0], above[0], contexts[0], in);
+    for(int x = 1; x < width; ++x)
+      row[x] = decode(row[x - 1], above[x], above[x - 1], contexts[x & phaseMask], in);
+  }
+}
+
+LosslessImage::LosslessImage(const Image& src) : Image(false), size(0)
+{
+  *this = src;
+}
+
+LosslessImage& LosslessImage::operator=(const Image& src)
+{
+  setResolution(src.width, src.height);
+  timeStamp = src.timeStamp;
+
+  // Separate the channels. The luminance plane contains both Y values of each pixel.
+  const int pixels = width * height;
+  planes.resize(pixels * 4);
+  unsigned char* lum = planes.data();
+  unsigned char* cb = lum + pixels * 2;
+  unsigned char* cr = cb + pixels;
+  for(int y = 0; y < height; ++y)
+    for(const Pixel* p = src[y], * pEnd = p + width; p < pEnd; ++p)
+    {
+      *lum++ = p->yCbCrPadding;
+      *lum++ = p->y;
+      *cb++ = p->cb;
+      *cr++ = p->cr;
+    }
+
+  unsigned char* dest = (unsigned char*) (*this)[0];
+  const unsigned char* limit = dest + 1 + pixels * 4; // stop when not smaller than stored channels
+  BitWriter out(dest + 1);
+  if(compressPlane(planes.data(), width * 2, height, 2, out, limit) &&
+     compressPlane(planes.data() + pixels * 2, width, height, 1, out, limit) &&
+     compressPlane(planes.data() + pixels * 3, width, height, 1, out, limit))
+  {
+    out.flush();
+    *dest = predicted;
+    size = unsigned(out.p - dest);
+  }
+  else
+  {
+    *dest = stored;
+    memcpy(dest + 1, planes.data(), pixels * 4);
+    size = 1 + pixels * 4;
+  }
+  return *this;
+}
+
+void LosslessImage::toImage(Image& dest) const
+{
+  dest.setResolution(width, height);
+  dest.timeStamp = timeStamp;
+
+  const int pixels = width * height;
+  std::vector<unsigned char> planes(pixels * 4);
+  const unsigned char* src = (const unsigned char*) (*this)[0];
+  if(*src == stored)
+    memcpy(planes.data(), src + 1, pixels * 4);
+  else
+  {
+    ASSERT(*src == predicted);
+    BitReader in(src + 1, src + size);
+    uncompressPlane(planes.data(), width * 2, height, 2, in);
+    uncompressPlane(planes.data() + pixels * 2, width, height, 1, in);
+    uncompressPlane(planes.data() + pixels * 3, width, height, 1, in);
+  }
+
+  const unsigned char* lum = planes.data();
+  const unsigned char* cb = lum + pixels * 2;
+  const unsigned char* cr = cb + pixels;
+  for(int y = 0; y < height; ++y)
+    for(Pixel* p = dest[y], * pEnd = p + width; p < pEnd; ++p)
+    {
+      p->yCbCrPadding = *lum++;
+      p->y = *lum++;
+      p->cb = *cb++;
+      p->cr = *cr++;
+    }
+}
+
+void LosslessImage::serialize(In* in, Out* out)
+{
+  STREAM_REGISTER_BEGIN;
+  STREAM(width);
+  STREAM(height);
+
+  STREAM(timeStamp);
+  STREAM(size);
+  if(in)
+  {
+    widthStep = 2 * width;
+    in->read((*this)[0], size);
+  }
+  else
+    out->write((*this)[0], size);
+  STREAM_REGISTER_FINISH;
+}
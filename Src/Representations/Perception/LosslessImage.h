@@ -0,0 +1,54 @@
+/**
+ * @file LosslessImage.h
+ *
+ * Declaration of class LosslessImage
+ */
+
+#pragma once
+
+#include "Representations/Infrastructure/Image.h"
+#include <vector>
+
+/**
+ * Definition of a class for losslessly compressed images. It is meant for
+ * logging images on the robot, so compressing must be fast.
+ * The channels are separated into a luminance plane with both Y values of each
+ * pixel and the two chroma planes. Each sample is predicted from its neighbors
+ * as in JPEG-LS (median edge detector) and the prediction error is encoded with
+ * adaptive Golomb-Rice codes. The parameters of the codes depend on the local
+ * activity and, for the luminance, on whether the sample is the first or the
+ * second Y of a pixel.
+ */
+class LosslessImage : public Image
+{
+private:
+  void serialize(In* in, Out* out);
+
+  unsigned size; /**< The size of the compressed image. */
+  std::vector<unsigned char> planes; /**< A buffer for the separated channels when compressing. */
+
+public:
+  /**
+  * Empty constructor.
+  */
+  LosslessImage() : Image(false), size(0) {}
+
+  /**
+  * Constructs a compressed image from an image.
+  * @param src The image used as template.
+  */
+  LosslessImage(const Image& src);
+
+  /**
+  * Assignment operator.
+  * @param src The image used as template.
+  * @return The resulting compressed image.
+  */
+  LosslessImage& operator=(const Image& src);
+
+  /**
+  * Uncompress image.
+  * @param dest Will receive the uncompressed image.
+  */
+  void toImage(Image& dest) const;
+};
@@ -0,0 +1,80 @@
+/**
+* @file ProjectionGrid.h
+* Declaration of a class that projects image points to the field plane by
+* interpolating on a sparse grid. For each node of the grid, the direction of
+* the ray through the pixel is computed once per frame, including the
+* compensation of the rolling shutter. Interpolating the rays instead of the
+* points on the field keeps the result precise close to the horizon.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Tools/Math/Vector2.h"
+#include "Tools/Math/Vector3.h"
+#include "Tools/Streams/AutoStreamable.h"
+#include "Platform/BHAssert.h"
+
+STREAMABLE(ProjectionGrid,
+{
+public:
+  /**
+  * Returns the direction of the ray through an image point relative to the robot.
+  * The direction is scaled so that its length along the optical axis is 1.
+  * Points outside the image are extrapolated from the closest cell.
+  * @param imagePoint The point in (uncorrected) image coordinates.
+  * @return The direction of the ray.
+  */
+  Vector3<> getRay(const Vector2<>& imagePoint) const
+  {
+    ASSERT(columns > 1 && rows > 1);
+    const float x = imagePoint.x / float(spacing);
+    const float y = imagePoint.y / float(spacing);
+    const int column = std::max(0, std::min(columns - 2, int(x)));
+    const int row = std::max(0, std::min(rows - 2, int(y)));
+    const Vector3<>* node = &rays[row * columns + column];
+    const Vector3<> top = node[0] + (node[1] - node[0]) * (x - float(column));
+    const Vector3<> bottom = node[columns] + (node[columns + 1] - node[columns]) * (x - float(column));
+    return top + (bottom - top) * (y - float(row));
+  }
+
+  /**
+  * Projects an image point to the field plane.
+  * The result is the same as Geometry::calculatePointOnField for the corrected point.
+  * @param imagePoint The point in (uncorrected) image coordinates.
+  * @param pointOnField The point on the field relative to the robot. It is also set if
+  *                     the point is too far away.
+  * @return Is the point below the horizon and not too far away?
+  */
+  bool getPointOnField(const Vector2<>& imagePoint, Vector2<>& pointOnField) const
+  {
+    const Vector3<> ray = getRay(imagePoint);
+    if(ray.z > maxRayZ)
+      return false;
+    const float f = cameraPosition.z / ray.z;
+    pointOnField.x = cameraPosition.x - f * ray.x;
+    pointOnField.y = cameraPosition.y - f * ray.y;
+    return std::abs(pointOnField.x) < maxDistance && std::abs(pointOnField.y) < maxDistance;
+  }
+
+  /**
+  * Projects an image point to the field plane.
+  * @param imagePoint The point in (uncorrected) image coordinates.
+  * @param pointOnField The point on the field relative to the robot.
+  * @return Is the point below the horizon and not too far away?
+  */
+  bool getPointOnField(const Vector2<int>& imagePoint, Vector2<>& pointOnField) const
+  {
+    return getPointOnField(Vector2<>(float(imagePoint.x), float(imagePoint.y)), pointOnField);
+  },
+
+  (std::vector<Vector3<> >) rays, /**< The directions of the rays through all nodes, row by row. */
+  (int)(0) columns, /**< The number of nodes per row. */
+  (int)(0) rows, /**< The number of rows. */
+  (int)(1) spacing, /**< The distance between two neighboring nodes in pixels. */
+  (Vector3<>) cameraPosition, /**< The position of the camera relative to the robot. */
+  (float)(0) maxRayZ, /**< Rays with a larger z component are considered to be above the horizon. */
+  (float)(0) maxDistance, /**< The maximum x and y coordinate of a point projected to the field. */
+});
@@ -6,6 +6,75 @@
 
 #include "RegionPercept.h"
 
+void RegionPercept::serialize(In* in, Out* out)
+{
+  STREAM_REGISTER_BEGIN;
+  STREAM(segmentsCounter);
+  STREAM(regionsCounter);
+  STREAM(gridStepSize);
+
+  // pointers are streamed as indices into the arrays, -1 is NULL
+  if(out)
+  {
+    for(const Segment* segment = segments; segment < segments + segmentsCounter; ++segment)
+      *out << segment->x << segment->y << segment->length
+           << segment->explored_min_y << segment->explored_max_y << segment->explored_size
+           << (unsigned char) segment->color
+           << (int) (segment->link ? segment->link - segments : -1)
+           << (int) (segment->region ? segment->region - regions : -1);
+    for(const Region* region = regions; region < regions + regionsCounter; ++region)
+    {
+      *out << region->min_y << region->max_y << (unsigned char) region->color << region->size
+           << (int) (region->root ? region->root - regions : -1)
+           << (unsigned) region->children.size();
+      for(const Segment* child : region->children)
+        *out << (int) (child - segments);
+      *out << (unsigned) region->neighborRegions.size();
+      for(const Region* neighbor : region->neighborRegions)
+        *out << (int) (neighbor - regions);
+    }
+  }
+  else
+  {
+    ASSERT(segmentsCounter <= MAX_SEGMENTS_COUNT && regionsCounter <= MAX_REGIONS_COUNT);
+    int index;
+    unsigned char color;
+    unsigned size;
+    for(Segment* segment = segments; segment < segments + segmentsCounter; ++segment)
+    {
+      *in >> segment->x >> segment->y >> segment->length
+          >> segment->explored_min_y >> segment->explored_max_y >> segment->explored_size
+          >> color;
+      segment->color = (ColorClasses::Color) color;
+      *in >> index;
+      segment->link = index < 0 ? NULL : segments + index;
+      *in >> index;
+      segment->region = index < 0 ? NULL : regions + index;
+    }
+    for(Region* region = regions; region < regions + regionsCounter; ++region)
+    {
+      *in >> region->min_y >> region->max_y >> color >> region->size >> index;
+      region->color = (ColorClasses::Color) color;
+      region->root = index < 0 ? NULL : regions + index;
+      *in >> size;
+      region->children.resize(size);
+      for(Segment*& child : region->children)
+      {
+        *in >> index;
+        child = segments + index;
+      }
+      *in >> size;
+      region->neighborRegions.resize(size);
+      for(Region*& neighbor : region->neighborRegions)
+      {
+        *in >> index;
+        neighbor = regions + index;
+      }
+    }
+  }
+  STREAM_REGISTER_FINISH;
+}
+
 RegionPercept::Region* RegionPercept::Region::getRootRegion() const
 {
   Region* r = root;
@@ -114,52 +183,6 @@ float RegionPercept::Region::calcCMoment02(int swp_y) const
   return cm02;
 }
 
-void RegionPercept::Region::mergeWithRegion(Region* other)
-{
-  //merge the childs of both regions (sorted)
-  std::vector<RegionPercept::Segment*>::iterator regIter1 = children.begin();
-  std::vector<RegionPercept::Segment*>::iterator regIter2 = other->children.begin();
-  std::vector<RegionPercept::Segment*> mergedChildren;
-  while(!(regIter1 == children.end() && regIter2 == other->children.end()))
-  {
-    if(regIter1 == children.end())
-    {
-      ASSERT(*regIter2 != NULL);
-      mergedChildren.push_back(*regIter2);
-      (*regIter2)->region = this;
-      regIter2++;
-    }
-    else if(regIter2 == other->children.end())
-    {
-      ASSERT(*regIter1 != NULL);
-      mergedChildren.push_back(*regIter1);
-      regIter1++;
-    }
-    else
-    {
-      if(*regIter1 < *regIter2)
-      {
-        mergedChildren.push_back(*regIter1);
-        regIter1++;
-      }
-      else
-      {
-        mergedChildren.push_back(*regIter2);
-        (*regIter2)->region = this;
-        regIter2++;
-      }
-    }
-  }
-  children = mergedChildren;
-
-  size += other->size;
-  neighborRegions.insert(neighborRegions.end(), other->neighborRegions.begin(), other->neighborRegions.end());
-  if(other->min_y < min_y)
-    min_y = other->min_y;
-  if(other->max_y > max_y)
-    max_y = other->max_y;
-}
-
 bool RegionPercept::Segment::operator<(Segment* s2)
 {
   if(this->x < s2->x)
@@ -63,11 +63,7 @@ private:
   * @param in  streaming in ...
   * @param out ... streaming out.
   */
-  void serialize(In* in, Out* out)
-  {
-    STREAM_REGISTER_BEGIN;
-    STREAM_REGISTER_FINISH;
-  }
+  void serialize(In* in, Out* out);
 
 public:
   class Segment;
@@ -133,13 +129,6 @@ public:
      * */
     float calcCMoment02(int swp_y) const;
 
-    /**
-     * Merges another region to this one. This will be the parent (root)
-     * region, the other one will be "dead".
-     * @param other region to merge into this one
-     */
-    void mergeWithRegion(Region* other);
-
     std::vector<Segment*> children; /**< The child segments of this region. */
     std::vector<Region*> neighborRegions; /**< The neighbor Regions of this region. */
     int min_y, /**< The minimum y value of the childs. */
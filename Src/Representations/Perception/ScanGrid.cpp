@@ -0,0 +1,68 @@
+/**
+* @file ScanGrid.cpp
+* Implementation of a class that contains the color classes of the pixels on a grid
+* of vertical and horizontal scanlines.
+*/
+
+#include "ScanGrid.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include "Platform/BHAssert.h"
+#include <algorithm>
+
+ScanGrid::Run::Run(int from, int to, unsigned char colors)
+: from(static_cast<short>(from)),
+  to(static_cast<short>(to)),
+  colors(colors) {}
+
+ScanGrid::Line::Line(int position, int from, int to, unsigned firstRun)
+: position(static_cast<short>(position)),
+  from(static_cast<short>(from)),
+  to(static_cast<short>(to)),
+  firstRun(firstRun),
+  endRun(firstRun) {}
+
+const ScanGrid::Line* ScanGrid::getVerticalLine(int x) const
+{
+  if(x < firstX || (x - firstX) % lineDistance)
+    return 0;
+  const unsigned index = (x - firstX) / lineDistance;
+  return index < verticalLines.size() ? &verticalLines[index] : 0;
+}
+
+const ScanGrid::Run* ScanGrid::getRun(const Line& line, int pos) const
+{
+  ASSERT(line.isInside(pos));
+  return std::upper_bound(begin(line), end(line), pos, [](int pos, const Run& run) {return pos < run.to;});
+}
+
+void ScanGrid::draw() const
+{
+  DECLARE_DEBUG_DRAWING("representation:ScanGrid:vertical", "drawingOnImage");
+  DECLARE_DEBUG_DRAWING("representation:ScanGrid:horizontal", "drawingOnImage");
+
+  COMPLEX_DRAWING("representation:ScanGrid:vertical",
+  {
+    for(const Line& line : verticalLines)
+      for(const Run* run = begin(line); run != end(line); ++run)
+        for(int c = 1; c < ColorClasses::numOfColors; ++c)
+          if(run->getColorClasses() == (ColorClasses::Color) c)
+          {
+            LINE("representation:ScanGrid:vertical", line.position, run->from, line.position, run->to - 1,
+                 0, Drawings::ps_solid, (ColorClasses::Color) c);
+            break;
+          }
+  });
+
+  COMPLEX_DRAWING("representation:ScanGrid:horizontal",
+  {
+    for(const Line& line : horizontalLines)
+      for(const Run* run = begin(line); run != end(line); ++run)
+        for(int c = 1; c < ColorClasses::numOfColors; ++c)
+          if(run->getColorClasses() == (ColorClasses::Color) c)
+          {
+            LINE("representation:ScanGrid:horizontal", run->from, line.position, run->to - 1, line.position,
+                 0, Drawings::ps_solid, (ColorClasses::Color) c);
+            break;
+          }
+  });
+}
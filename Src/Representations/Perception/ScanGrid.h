@@ -0,0 +1,93 @@
+/**
+* @file ScanGrid.h
+* Declaration of a class that contains the color classes of the pixels on a grid
+* of vertical and horizontal scanlines. The pixels are classified once per frame
+* and stored as runs of pixels that share the same color classes, so that the
+* perceptors do not have to look up the color table for the same pixels again.
+*/
+
+#pragma once
+
+#include <vector>
+#include "Tools/Streams/AutoStreamable.h"
+#include "ColorReference.h"
+
+STREAMABLE(ScanGrid,
+{
+public:
+  /**
+   * A sequence of neighboring pixels on a scanline that all have the same color classes.
+   */
+  STREAMABLE(Run,
+  {
+  public:
+    Run(int from, int to, unsigned char colors);
+
+    ColorReference::MultiColor getColorClasses() const {return ColorReference::MultiColor(colors);},
+
+    (short) from, /**< The first pixel of the run (y for vertical, x for horizontal scanlines). */
+    (short) to, /**< The first pixel after the run. */
+    (unsigned char) colors, /**< The color classes of all pixels of the run (see ColorReference::MultiColor). */
+  });
+
+  /**
+   * A scanline, i.e. a range of runs in the list of all runs.
+   */
+  STREAMABLE(Line,
+  {
+  public:
+    Line(int position, int from, int to, unsigned firstRun);
+
+    bool isInside(int pos) const {return pos >= from && pos < to;},
+
+    (short) position, /**< The x coordinate of a vertical or the y coordinate of a horizontal scanline. */
+    (short) from, /**< The first pixel classified on this scanline. */
+    (short) to, /**< The first pixel after the classified range. */
+    (unsigned) firstRun, /**< The index of the first run of this scanline in "runs". */
+    (unsigned) endRun, /**< The index after the last run of this scanline in "runs". */
+  });
+
+  /**
+   * Returns the vertical scanline at a certain x coordinate.
+   * @param x The x coordinate in the image.
+   * @return The scanline or 0 if there is no vertical scanline at this x coordinate.
+   */
+  const Line* getVerticalLine(int x) const;
+
+  /**
+   * Returns the run that contains a certain pixel of a scanline.
+   * @param line The scanline.
+   * @param pos The y coordinate (vertical) or x coordinate (horizontal) of the pixel.
+   * @return The run. It must be inside the classified range of the scanline.
+   */
+  const Run* getRun(const Line& line, int pos) const;
+
+  /**
+   * Returns the color classes of a pixel on a scanline.
+   * @param line The scanline.
+   * @param pos The y coordinate (vertical) or x coordinate (horizontal) of the pixel.
+   * @return The color classes. The pixel must be inside the classified range of the scanline.
+   */
+  ColorReference::MultiColor getColorClasses(const Line& line, int pos) const {return getRun(line, pos)->getColorClasses();}
+
+  /** The first run of a scanline. */
+  const Run* begin(const Line& line) const {return runs.data() + line.firstRun;}
+
+  /** The run after the last run of a scanline. */
+  const Run* end(const Line& line) const {return runs.data() + line.endRun;}
+
+  /**
+   * The method draws the runs.
+   */
+  void draw() const,
+
+  (std::vector<Line>) verticalLines, /**< The vertical scanlines from left to right. */
+  (std::vector<Line>) horizontalLines, /**< The horizontal scanlines from top to bottom. */
+  (std::vector<Run>) runs, /**< The runs of all scanlines. */
+  (int)(0) firstX, /**< The x coordinate of the leftmost vertical scanline. */
+  (int)(1) lineDistance, /**< The distance between neighboring vertical scanlines in pixels. */
+
+  // Initialization
+  verticalLines.reserve(maxResolutionWidth);
+  runs.reserve(maxResolutionWidth * 16);
+});
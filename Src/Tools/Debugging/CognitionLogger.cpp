@@ -10,6 +10,7 @@
 #include "Tools/Streams/Streamable.h"
 #include "Tools/Streams/InStreams.h"
 #include "Representations/Blackboard.h"
+#include "Representations/Perception/LosslessImage.h"
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/GameInfo.h"
 #include "Tools/MessageQueue/MessageQueue.h"
@@ -26,6 +27,12 @@
 #include <algorithm>
 using namespace std;
 
+/**
+ * The number of camera buffers the logger may lease at the same time. Leased buffers cannot be filled by the driver,
+ * and each camera only has a few of them. Images are copied by the cognition thread while this number is reached.
+ */
+static const unsigned maxImageLeases = 2;
+
 #define REGISTER_REPRESENTATION(name) \
   representations[#name] = make_pair(id##name,(Streamable*)&Blackboard::theInstance->the##name)
 
@@ -35,6 +42,7 @@ struct CognitionLogger::Parameters : public Streamable
   std::string logFilePath; /**< Where to write the log file.*/
   unsigned int maxBufferSize; /**< Max size of the buffer in bytes. */
   unsigned int blockSize; /**< Size per frame. (in bytes) */
+  unsigned int imageBufferSize; /**< Number of images buffered until the writer thread compresses them. */
   std::vector<std::string> representations; /**< Contains the representations that should be logged. */
   bool enabled; /**< Determines whether the logger is enabled or disabled. */
   int writePriority;
@@ -51,6 +59,7 @@ struct CognitionLogger::Parameters : public Streamable
       conf >> *this;
     }
     ASSERT(maxBufferSize > 0);
+    ASSERT(imageBufferSize > 1);
   }
 
   void serialize(In* in, Out* out)
@@ -59,6 +68,7 @@ struct CognitionLogger::Parameters : public Streamable
       STREAM(logFilePath);
       STREAM(maxBufferSize);
       STREAM(blockSize);
+      STREAM(imageBufferSize);
       STREAM(representations);
       STREAM(enabled);
       STREAM(writePriority);
@@ -77,7 +87,13 @@ CognitionLogger::CognitionLogger(const ModuleManager& moduleManager) :
                                          frameCounter(0),
                                          framesToWrite(0),
                                          shouldPlayLogSound(false),
-                                         moduleManager(moduleManager)
+                                         moduleManager(moduleManager),
+                                         losslessImage(nullptr),
+                                         imageReadIndex(0),
+                                         imagesBuffered(0),
+                                         imagesCopied(0),
+                                         imagesToCopy(0),
+                                         logFile(nullptr)
 {
   initStateFunctors();
   writerThread.setPriority(params.writePriority);
@@ -122,11 +138,18 @@ void CognitionLogger::initRepresentations()
   REGISTER_REPRESENTATION(ObstacleSpots);
   REGISTER_REPRESENTATION(ObstacleWheel);
   REGISTER_REPRESENTATION(BodyContour);
+
+  //raw images are too large, so they are compressed by the writer thread before they are written
+  losslessImage = new LosslessImage;
+  representations["Image"] = make_pair(idLosslessImage, (Streamable*) losslessImage);
 }
 
 void CognitionLogger::run()
 {
   states[state]();
+#ifdef CAMERA_INCLUDED
+  imageLease.release();
+#endif
 }
 
 void CognitionLogger::preInitial()
@@ -153,6 +176,17 @@ void CognitionLogger::initial()
       buffer.push_back(new MessageQueue());
       buffer.back()->setSize(params.blockSize);
     }
+    if(std::find(params.representations.begin(), params.representations.end(), "Image") != params.representations.end())
+    {
+      for(unsigned int i = 0; i < params.imageBufferSize; i++)
+      {
+        images.push_back(new Image(false));
+      }
+#ifdef CAMERA_INCLUDED
+      imageLeases.resize(params.imageBufferSize);
+#endif
+      copierThread.start(this, &CognitionLogger::copyThread);
+    }
     logFilename = generateFilename();
     writerThread.start(this, &CognitionLogger::writeThread);
     writerIdle = false; //this should be false until the writer wrote something for the first time
@@ -220,9 +254,33 @@ void CognitionLogger::logFrame()
   {
     ASSERT(representations.find(repName) != representations.end());
     const pair<MessageID, Streamable*>& representation = representations[repName];
-    const unsigned size = getStreamableSize(*representation.second);
-    //some streamables do not stream anything. If no data is streamed the queue crashes.
-    if(size > 0)
+    if(representation.first == idLosslessImage)
+    {//compressing takes too long for this thread. Only buffer the image and log its number.
+      const Image& image = Blackboard::theInstance->theImage;
+      const int imageWriteIndex = imagesBuffered % params.imageBufferSize;
+      if((imageWriteIndex + 1) % params.imageBufferSize == imageReadIndex)
+      {
+        OUTPUT_WARNING("Logger: Writer thread too slow, discarding image");
+      }
+      else
+      {
+        Image& copy = *images[imageWriteIndex];
+#ifdef CAMERA_INCLUDED
+        if(imageLease.getImage() == (const unsigned char*) image[0] && imagesBuffered - imagesCopied < maxImageLeases)
+        {//copying takes long as well. Keep the camera buffer until the copy thread copied it.
+          copy.setResolution(image.width, image.height);
+          copy.timeStamp = image.timeStamp;
+          imageLeases[imageWriteIndex] = imageLease;
+        }
+        else
+#endif
+          copy = image;
+        buffer[writeIndex]->out.bin << imagesBuffered++;
+        buffer[writeIndex]->out.finishMessage(idLosslessImage);
+        imagesToCopy.post();
+      }
+    }
+    else if(getStreamableSize(*representation.second) > 0) //some streamables do not stream anything. If no data is streamed the queue crashes.
     {
       buffer[writeIndex]->out.bin << *representation.second;
       buffer[writeIndex]->out.finishMessage(representation.first);
@@ -301,12 +359,15 @@ void CognitionLogger::writeThread()
 {
   /**
    * Logfile format:
-   * magic byte | size of next compressed block | compressed block | size | compressed block | etc...
-   * Each block is compressed using libsnappy
+   * magic byte | chunk | chunk | etc...
+   * Each chunk looks like this:
+   * | compressed (bool) | size of the next block | block |
+   * Images are compressed by LosslessImage and stored in blocks of their own that are not compressed again.
+   * All other blocks are compressed using libsnappy.
    *
    * Block format (after decompression):
-   * | -1 (int) | -1 (int) | Frame | Frame | Frame | ... | Frame |
-   * The -1 at the beginning indicates that the number of frames that follows is unknown
+   * | size (int) | number of messages (int) | Log data | Log data | ... | Log data |
+   * The blocks of all chunks form a sequence of frames.
    *
    * Each frame looks like this:
    * | ProcessBegin | Log data 1 | Log data 2 | ... | Log data n | ProcessFinished |
@@ -317,15 +378,13 @@ void CognitionLogger::writeThread()
   //create and open file
   OutBinaryFile file(logFilename);
   ASSERT(file.exists());
-  file << logFileCompressed; //write magic byte that indicates a compressed log file
-  
-  const int uncompressedSize = params.blockSize + 8; // + 8 because of header
-  vector<char> uncompresedBuffer;
-  uncompresedBuffer.resize(uncompressedSize);//contains data before compression
-  const size_t compressedSize = snappy_max_compressed_length(uncompressedSize);
-  vector<char> compressedBuffer;
-  compressedBuffer.resize(compressedSize); //data after compression
+  file << logFileChunked; //write magic byte that indicates a chunked log file
+  logFile = &file;
 
+  const int uncompressedSize = params.blockSize + 8; // + 8 because of header
+  uncompressedBuffer.resize(uncompressedSize);
+  compressedBuffer.resize(snappy_max_compressed_length(uncompressedSize));
+  chunk.setSize(params.blockSize);
 
   while(writerThread.isRunning()) //check if we are expecting more data
   {
@@ -333,18 +392,11 @@ void CognitionLogger::writeThread()
     {
       writerIdle = false;
       int rIndex = readIndex; //readIndex is shared between both threads. therefore avoid accessing it too often
-      const unsigned int numOfMsgs = buffer[rIndex]->getNumberOfMessages();
-      if(numOfMsgs > 0)
+      if(buffer[rIndex]->getNumberOfMessages() > 0)
       {
-        OutBinaryMemory mem(uncompresedBuffer.data());
-        
-        mem << *buffer[rIndex];
+        buffer[rIndex]->handleAllMessages(*this);
         buffer[rIndex]->clear();
-        size_t size = compressedSize;
-        VERIFY(snappy_compress(uncompresedBuffer.data(), (size_t)mem.getLength(),
-                        compressedBuffer.data(), &size) == SNAPPY_OK);
-        file << (unsigned)size;
-        file.write(compressedBuffer.data(), size);
+        writeChunk(true);
       }
       readIndex = (rIndex + 1) % params.maxBufferSize;
     }
@@ -354,6 +406,81 @@ void CognitionLogger::writeThread()
       writerIdleStart = SystemCall::getCurrentSystemTime();
     }
   }
+  logFile = nullptr;
+}
+
+void CognitionLogger::copyThread()
+{
+  Image leasedImage(false);
+  while(copierThread.isRunning())
+  {
+    if(imagesToCopy.wait(100))
+    {
+#ifdef CAMERA_INCLUDED
+      const int imageIndex = imagesCopied % params.imageBufferSize;
+      NaoCamera::Lease& lease = imageLeases[imageIndex];
+      if(!lease.isEmpty())
+      {
+        Image& copy = *images[imageIndex];
+        leasedImage.setResolution(copy.width, copy.height);
+        leasedImage.timeStamp = copy.timeStamp;
+        leasedImage.setImage(lease.getImage());
+        copy = leasedImage;
+        lease.release();
+      }
+#endif
+      ++imagesCopied; //images that were copied by the cognition thread are only counted
+    }
+  }
+}
+
+bool CognitionLogger::handleMessage(InMessage& message)
+{
+  if(message.getMessageID() == idLosslessImage)
+  {//the message only contains the number of the buffered image
+    unsigned imageNumber;
+    message.bin >> imageNumber;
+    while(imagesCopied <= imageNumber) //the copy thread has not copied the leased camera buffer yet
+    {
+      SystemCall::sleep(1);
+    }
+    const int imageIndex = imageNumber % params.imageBufferSize;
+    writeChunk(true);
+    *losslessImage = *images[imageIndex];
+    imageReadIndex = (imageIndex + 1) % params.imageBufferSize; //also releases copies whose index could not be logged
+    chunk.out.bin << *losslessImage;
+    chunk.out.finishMessage(idLosslessImage);
+    writeChunk(false);
+  }
+  else
+  {
+    message >> chunk;
+  }
+  return true;
+}
+
+void CognitionLogger::writeChunk(bool compress)
+{
+  if(chunk.isEmpty())
+  {
+    return;
+  }
+  if(compress)
+  {
+    OutBinaryMemory mem(uncompressedBuffer.data());
+    mem << chunk;
+    size_t size = compressedBuffer.size();
+    VERIFY(snappy_compress(uncompressedBuffer.data(), (size_t)mem.getLength(),
+                           compressedBuffer.data(), &size) == SNAPPY_OK);
+    *logFile << true << (unsigned)size;
+    logFile->write(compressedBuffer.data(), size);
+  }
+  else
+  {
+    *logFile << false << (unsigned)chunk.getStreamedSize();
+    *logFile << chunk;
+  }
+  chunk.clear();
 }
 
 unsigned CognitionLogger::getFreeSpace() const
@@ -383,4 +510,13 @@ void CognitionLogger::sortRepresentations()
 CognitionLogger::~CognitionLogger()
 {
   writerThread.stop();
+  copierThread.stop();
+  if(losslessImage)
+  {
+    delete losslessImage;
+  }
+  for(Image* image : images)
+  {
+    delete image;
+  }
 }
\ No newline at end of file
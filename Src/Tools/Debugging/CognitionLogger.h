@@ -13,12 +13,15 @@
 #include <vector>
 #include <atomic>
 #include "Tools/MessageQueue/MessageIDs.h"
+#include "Tools/MessageQueue/MessageQueue.h"
 #include "Tools/Streams/OutStreams.h"
 #include "Platform/Thread.h"
 #include "Platform/Semaphore.h"
+#include "Platform/Camera.h"
 class Streamable;
-class MessageQueue;
 class ModuleManager;
+class Image;
+class LosslessImage;
 
 /**
  * This is a simple state machine that logs representations and writes them to disk.
@@ -43,14 +46,27 @@ class ModuleManager;
  * Everything that the logger logs is written into a ring buffer. The buffer size can be configured (see logger.cfg).
  * A non-real-time thread slowly writes the data from the buffer to the disk. If the bhuman process is stopped while
  * there is still data inside the buffer that data is lost!
+ * Images are only copied into a second ring buffer. The writer thread compresses them when it writes them to the disk.
+ * On the robot, even the copy is not made by the cognition process. It only leases the camera buffer of the image and
+ * a third thread copies it into the ring buffer.
  *
  * Usage of the logger:
  * run() should be called once in the end of every frame.
  */
-class CognitionLogger {
+class CognitionLogger : private MessageHandler
+{
 public:
   /**Run one iteration of the logger state machine*/
   void run();
+
+#ifdef CAMERA_INCLUDED
+  /**
+   * Sets the lease of the camera buffer the current image was taken from. It is released at the end of run().
+   * @param lease The lease. It is only used if the image still references the camera buffer, i.e. it was not subsampled.
+   */
+  void setImageLease(const NaoCamera::Lease& lease) {imageLease = lease;}
+#endif
+
   ~CognitionLogger();
 
 private:
@@ -87,6 +103,20 @@ private:
   int mod(int a, int b);
   /**A thread that writes the logged data from the buffer to the disk*/
   void writeThread();
+  /**A thread that copies the leased camera images into the image buffer in the order they were buffered*/
+  void copyThread();
+  /**
+   * Collects the messages of a block for the writer thread. Images are compressed and written
+   * as chunks of their own. All other messages are collected in chunks compressed by snappy.
+   * @param message The message from the block.
+   * @return Always true.
+   */
+  bool handleMessage(InMessage& message);
+  /**
+   * Writes the messages collected by the writer thread to the log file and clears them.
+   * @param compress Compress the messages with snappy?
+   */
+  void writeChunk(bool compress);
   /**generates the filename for the log file. The mane contains the robot name, player number and the date*/
   std::string generateFilename();
   /**returns the free space left on the device in KB */
@@ -118,4 +148,21 @@ private:
   bool shouldPlayLogSound; /**< what the name says */
   const ModuleManager& moduleManager; /**< Reference to the module manager. Used to gather information about execution order of modules */
   std::vector<std::string> representationNames; /**< contains all representations that should be logged in execution order */
+  LosslessImage* losslessImage; /**< The image is logged losslessly compressed. Only used by the writer thread. */
+
+  std::vector<Image*> images; /**< Ring buffer of copies of the images that should be logged. Shared with the writer and the copy thread. */
+  std::atomic<int> imageReadIndex; /**< the first index of the image buffer that is still used by the writer thread */
+  unsigned imagesBuffered; /**< number of images added to the image buffer so far. The next one uses index imagesBuffered % imageBufferSize. */
+  std::atomic<unsigned> imagesCopied; /**< number of images of the image buffer that already contain their pixels */
+  Thread<CognitionLogger> copierThread; /**< used to copy leased camera images into the image buffer */
+  Semaphore imagesToCopy; /**< How many buffered images the copy thread has not handled yet */
+#ifdef CAMERA_INCLUDED
+  NaoCamera::Lease imageLease; /**< The lease of the camera buffer of the current image. Only used by the cognition thread. */
+  std::vector<NaoCamera::Lease> imageLeases; /**< Leases of the camera buffers the copy thread still has to copy into the images with the same indices. */
+#endif
+
+  OutBinaryFile* logFile; /**< The log file. Only used by the writer thread. */
+  MessageQueue chunk; /**< The messages that are written next to the log file. Only used by the writer thread. */
+  std::vector<char> uncompressedBuffer; /**< contains a chunk before compression. Only used by the writer thread. */
+  std::vector<char> compressedBuffer; /**< contains a chunk after compression. Only used by the writer thread. */
 };
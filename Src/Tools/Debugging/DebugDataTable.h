@@ -47,6 +47,7 @@ private:
    * Only a process is allowed to create the instance.
    */
   friend class Process;
+  friend class ModuleManager;
 
 public:
   ~DebugDataTable();
@@ -57,6 +58,10 @@ public:
    */
   template<class T> void updateObject(const char* name, T& t)
   {
+    // Searching converts the name to a string, which allocates memory for longer names
+    if(table.empty())
+      return;
+
     // Find entry in debug data table
     std::unordered_map<std::string, char*>::iterator iter = table.find(name);
     if(iter != table.end())
@@ -68,6 +73,11 @@ public:
 
   void processChangeRequest(InMessage& in);
 
+  /**
+   * Returns whether no object was modified through RobotControl so far.
+   */
+  bool isEmpty() const {return table.empty();}
+
   /**
    * Functions for ensuring that object is streamable at compile time.
    */
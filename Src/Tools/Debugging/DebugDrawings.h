@@ -218,6 +218,7 @@ private:
   friend class DrawingManager3D;
   friend class Framework;
   friend class TeamComm3DCtrl;
+  friend class ModuleManager;
   friend In& operator>>(In& stream, DrawingManager&);
   friend Out& operator<<(Out& stream, const DrawingManager&);
 };
@@ -68,6 +68,7 @@ private:
   friend class Process;
   friend class RobotConsole;
   friend class TeamComm3DCtrl;
+  friend class ModuleManager;
 
   enum { maxNumberOfDebugRequests = 1000 };
 
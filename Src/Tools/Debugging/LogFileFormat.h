@@ -11,4 +11,5 @@
 
 ENUM(LogFileFormat,
   logFileRegular,
-  logFileCompressed);
\ No newline at end of file
+  logFileCompressed,
+  logFileChunked); // chunks that are either compressed with snappy or stored as they are
\ No newline at end of file
@@ -0,0 +1,121 @@
+/**
+* @file PerformanceCounters.cpp
+* Implementation of a class that reads the hardware performance counters of the
+* thread that opened them.
+*/
+
+#include "PerformanceCounters.h"
+
+#ifdef LINUX
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+* The function opens a single counter for the calling thread.
+* @param type The type of the event.
+* @param config The event.
+* @param group The file descriptor of the leader of the group the counter is added to.
+*              If -1, the counter is not part of a group.
+* @param readFormat Additional flags for the data read from the counter.
+* @return The file descriptor of the counter or -1 if it is not available.
+*/
+static int openCounter(unsigned type, unsigned long long config, int group = -1, unsigned long long readFormat = 0)
+{
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | readFormat;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return (int) syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+PerformanceCounters::PerformanceCounters()
+{
+  for(int i = 0; i < numOfCounters; ++i)
+    fds[i] = -1;
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+  close();
+}
+
+bool PerformanceCounters::open()
+{
+  close();
+#ifdef LINUX
+  fds[cycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1, PERF_FORMAT_GROUP);
+  if(fds[cycles] != -1)
+  {
+    fds[instructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[cycles], PERF_FORMAT_GROUP);
+    fds[l1dMisses] = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                 PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds[llcMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[branchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  }
+#endif
+  return isOpen();
+}
+
+void PerformanceCounters::close()
+{
+  for(int i = 0; i < numOfCounters; ++i)
+    if(fds[i] != -1)
+    {
+#ifdef LINUX
+      ::close(fds[i]);
+#endif
+      fds[i] = -1;
+    }
+}
+
+void PerformanceCounters::read(Reading& reading) const
+{
+  for(int i = 0; i < numOfCounters; ++i)
+    reading.raw[i] = reading.enabled[i] = reading.running[i] = 0;
+#ifdef LINUX
+  // The group: the number of counters, the time enabled, the time running, and the value of each counter
+  unsigned long long group[5];
+  if(fds[cycles] != -1 && ::read(fds[cycles], group, sizeof(group)) >= (ssize_t) (4 * sizeof(unsigned long long)))
+    for(int i = cycles; i <= instructions && i < (int) group[0]; ++i)
+    {
+      reading.raw[i] = group[3 + i - cycles];
+      reading.enabled[i] = group[1];
+      reading.running[i] = group[2];
+    }
+
+  for(int i = instructions + 1; i < numOfCounters; ++i)
+  {
+    // The value, the time the counter was enabled, and the time it was actually counting
+    unsigned long long data[3];
+    if(fds[i] != -1 && ::read(fds[i], data, sizeof(data)) == sizeof(data))
+    {
+      reading.raw[i] = data[0];
+      reading.enabled[i] = data[1];
+      reading.running[i] = data[2];
+    }
+  }
+#endif
+}
+
+void PerformanceCounters::Reading::getCountsSince(const Reading& start, Values& values) const
+{
+  for(int i = 0; i < numOfCounters; ++i)
+  {
+    const unsigned long long rawDiff = raw[i] - start.raw[i];
+    const unsigned long long enabledDiff = enabled[i] - start.enabled[i];
+    const unsigned long long runningDiff = running[i] - start.running[i];
+    if(!runningDiff)
+      values.counts[i] = 0;
+    else if(runningDiff == enabledDiff)
+      values.counts[i] = rawDiff;
+    else
+      values.counts[i] = (unsigned long long) ((double) rawDiff * (double) enabledDiff / (double) runningDiff);
+  }
+}
@@ -0,0 +1,104 @@
+/**
+* @file PerformanceCounters.h
+* Declaration of a class that reads the hardware performance counters of the
+* thread that opened them.
+*/
+
+#pragma once
+
+#include "Tools/Enum.h"
+
+/**
+* @class PerformanceCounters
+* The class reads the hardware performance counters of a thread through the
+* perf_event interface of Linux. Only events in user mode are counted. Cycles and
+* instructions form a group, i.e. they are always counted at the same time. The
+* kernel multiplexes the other events if the CPU has not enough counters for all
+* of them at the same time. Their counts are scaled accordingly.
+* On other platforms, the counters cannot be opened.
+*/
+class PerformanceCounters
+{
+public:
+  ENUM(Counter,
+    cycles,
+    instructions,
+    l1dMisses, /**< Read misses of the level 1 data cache. */
+    llcMisses, /**< Misses of the last level cache. */
+    branchMisses
+  );
+
+  /**
+  * The values of all counters.
+  */
+  class Values
+  {
+  public:
+    unsigned long long counts[numOfCounters]; /**< The value of each counter. */
+
+    Values()
+    {
+      for(int i = 0; i < numOfCounters; ++i)
+        counts[i] = 0;
+    }
+  };
+
+  /**
+  * The raw state of all counters at a certain moment.
+  */
+  class Reading
+  {
+  public:
+    unsigned long long raw[numOfCounters]; /**< The raw value of each counter. */
+    unsigned long long enabled[numOfCounters]; /**< The time each counter was enabled in ns. */
+    unsigned long long running[numOfCounters]; /**< The time each counter was actually counting in ns. */
+
+    Reading()
+    {
+      for(int i = 0; i < numOfCounters; ++i)
+        raw[i] = enabled[i] = running[i] = 0;
+    }
+
+    /**
+    * The method determines the counts between an earlier reading and this one.
+    * The raw difference of a counter is scaled by the ratio between the time it
+    * was enabled and the time it was actually counting in between.
+    * @param start The earlier reading.
+    * @param values The counts are returned here. Counters that did not count in
+    *               between are 0.
+    */
+    void getCountsSince(const Reading& start, Values& values) const;
+  };
+
+private:
+  int fds[numOfCounters]; /**< The file descriptors of the counters. -1 if a counter is not available. */
+
+public:
+  PerformanceCounters();
+
+  /** Destructor. Closes the counters. */
+  ~PerformanceCounters();
+
+  /**
+  * The method opens the counters for the calling thread. Only this thread is
+  * measured afterwards.
+  * @return Are at least the cycles counted?
+  */
+  bool open();
+
+  /** The method closes the counters. */
+  void close();
+
+  /**
+  * The method returns whether the counters are open.
+  * @return Are at least the cycles counted?
+  */
+  bool isOpen() const {return fds[cycles] != -1;}
+
+  /**
+  * The method reads the current state of all counters. Counters that are not
+  * available are always 0.
+  * @param reading The state is returned here.
+  */
+  void read(Reading& reading) const;
+};
@@ -26,10 +26,17 @@ struct TimingManager::Pimpl
    *       allocates only one address for all const string literals with the same value.
    *       If this ever changes you have to replace the key with std::string */
 
+  /** The state of a stopwatch. */
+  struct Timing
+  {
+    unsigned long long time; /**< If the timer has been started but not stopped, yet: the start time. Else: the time between start and stop. */
+    bool valid; /**< Was the timer started in the current frame? */
+  };
+
   /**Key: name of the timer
-   * value: If timer has been started but not stopped, yet: the start time.
-   *        Else: the time between start and stop.*/
-  unordered_map<const char*,unsigned long long> timing;
+   * value: The state of the timer. The entries are never removed, so starting a timer
+   *        does not allocate memory after it was started the first time.*/
+  unordered_map<const char*, Timing> timing;
   unordered_map<const char*, unsigned short> idTable; /**< Key: name of the stopwatch. Value: the id that is used when sending timing data over the network */
   unsigned currentProcessStartTime; /**< timestamp of the current process iteration */
   unsigned frameNo; /**<  Number of the current frame*/
@@ -38,25 +45,42 @@ struct TimingManager::Pimpl
   bool processRunning; /**< Is a process iteration running right now? */
   bool dataPrepared; /**< True if data hs already been prepared this frame */
   int watchNameIndex; /**< Every frame a few watch names are transmitted. This is the index of the watchname that is to be transmitted next */
+  PerformanceCounters counters; /**< The hardware performance counters of the thread using the stopwatches. */
+  bool countersEnabled; /**< Are the performance counters measured? */
+  bool countersFailed; /**< Did opening the performance counters fail? Then it is not tried again. */
+  /**Key: name of the timer
+   * value: The counts between start and stop of the timer in the current frame.*/
+  unordered_map<const char*, PerformanceCounters::Values> counts;
+  unordered_map<const char*, PerformanceCounters::Reading> startReadings; /**< Key: name of the timer. Value: The state of the counters when it was started last. */
 };
 
 void TimingManager::startTiming(const char* identifier)
 {
   unsigned long long startTime = SystemCall::getCurrentThreadTime();
-  if(prvt->timing.find(identifier) == prvt->timing.end())
+  if(prvt->idTable.find(identifier) == prvt->idTable.end())
   {//create new entry
     prvt->watchNames.push_back(identifier);
     prvt->idTable[identifier] = (unsigned short)prvt->idTable.size(); //NOTE: this assumes that an unsigned short will always be big big enough to count the timers...
   }
-  prvt->timing[identifier] = startTime;
+  Pimpl::Timing& timing = prvt->timing[identifier];
+  timing.time = startTime;
+  timing.valid = true;
   prvt->dataPrepared = false;
-
+  if(prvt->countersEnabled)
+    prvt->counters.read(prvt->startReadings[identifier]);
 }
 unsigned TimingManager::stopTiming(const char* identifier)
 {
   const unsigned long long stopTime = SystemCall::getCurrentThreadTime();
-  const unsigned diff = unsigned(stopTime - prvt->timing[identifier]);
-  prvt->timing[identifier] = diff;
+  Pimpl::Timing& timing = prvt->timing[identifier];
+  const unsigned diff = unsigned(stopTime - timing.time);
+  timing.time = diff;
+  if(prvt->countersEnabled)
+  {
+    PerformanceCounters::Reading stopReading;
+    prvt->counters.read(stopReading);
+    stopReading.getCountsSince(prvt->startReadings[identifier], prvt->counts[identifier]);
+  }
   return diff;
 }
 
@@ -66,6 +90,8 @@ TimingManager::TimingManager() : prvt(new TimingManager::Pimpl)
   prvt->data.setSize(500000);
   prvt->processRunning = false;
   prvt->watchNameIndex = 0;
+  prvt->countersEnabled = false;
+  prvt->countersFailed = false;
 }
 
 TimingManager::~TimingManager()
@@ -80,6 +106,11 @@ void TimingManager::signalProcessStart()
   prvt->processRunning = true;
   prvt->data.clear();
   prvt->dataPrepared = false;
+
+  // Stopwatches not executed in this frame, e.g. of providers skipped, must not report old values.
+  for(auto& it : prvt->timing)
+    it.second.valid = false;
+  prvt->counts.clear();
 }
 
 void TimingManager::signalProcessStop()
@@ -113,13 +144,17 @@ void TimingManager::prepareData()
     out << prvt->idTable[watchName] << watchName;
   }
 
-  //now write the data of all watches
-  out << (unsigned short)prvt->timing.size();
-  for(const pair<const char*, unsigned long long>& it : prvt->timing)
-  {
-    out << prvt->idTable[it.first];
-    out << (unsigned)it.second; //the cast is ok because the time between start and stop will never be bigger than an int...
-  }
+  //now write the data of all watches that were started in this frame
+  unsigned short numOfTimings = 0;
+  for(const auto& it : prvt->timing)
+    numOfTimings += it.second.valid;
+  out << numOfTimings;
+  for(const auto& it : prvt->timing)
+    if(it.second.valid)
+    {
+      out << prvt->idTable[it.first];
+      out << (unsigned)it.second.time; //the cast is ok because the time between start and stop will never be bigger than an int...
+    }
   out << prvt->currentProcessStartTime;
   out << prvt->frameNo;
   if(prvt->data.writeErrorOccurred())
@@ -127,6 +162,27 @@ void TimingManager::prepareData()
     OUTPUT_WARNING("TimingManager: queue is full!!!");
   }
   prvt->data.out.finishMessage(idStopwatch);
+
+  /** Protocol of the performance counters:
+   * unsigned char  : number of counters per stopwatch
+   * unsigned short : number of stopwatches
+   * for each stopwatch:
+   *  unsigned short : id of the stopwatch
+   *  unsigned long long : the count of each counter
+   * unsigned : frame number of the current frame
+   */
+  if(prvt->countersEnabled)
+  {
+    out << (unsigned char)PerformanceCounters::numOfCounters;
+    out << (unsigned short)prvt->counts.size();
+    for(const auto& it : prvt->counts)
+    {
+      out << prvt->idTable[it.first];
+      out.write(it.second.counts, sizeof(it.second.counts)); // the streams do not support 64 bit integers
+    }
+    out << prvt->frameNo;
+    prvt->data.out.finishMessage(idPerformanceCounters);
+  }
 }
 
 MessageQueue& TimingManager::getData()
@@ -139,3 +195,68 @@ MessageQueue& TimingManager::getData()
   }
   return prvt->data;
 }
+
+vector<pair<const char*, unsigned> > TimingManager::getTimes() const
+{
+  ASSERT(!prvt->processRunning);
+  vector<pair<const char*, unsigned> > times;
+  times.reserve(prvt->timing.size());
+  for(const auto& it : prvt->timing)
+    if(it.second.valid)
+      times.push_back(pair<const char*, unsigned>(it.first, (unsigned)it.second.time));
+  return times;
+}
+
+vector<pair<const char*, PerformanceCounters::Values> > TimingManager::getCounters() const
+{
+  ASSERT(!prvt->processRunning);
+  return vector<pair<const char*, PerformanceCounters::Values> >(prvt->counts.begin(), prvt->counts.end());
+}
+
+void TimingManager::takeTimes(TimingManager& other)
+{
+  for(auto& it : other.prvt->timing)
+    if(it.second.valid)
+    {
+      if(prvt->idTable.find(it.first) == prvt->idTable.end())
+      {//create new entry
+        prvt->watchNames.push_back(it.first);
+        prvt->idTable[it.first] = (unsigned short)prvt->idTable.size();
+      }
+      prvt->timing[it.first] = it.second;
+      it.second.valid = false;
+    }
+  for(const auto& it : other.prvt->counts)
+    prvt->counts[it.first] = it.second;
+  prvt->dataPrepared = false;
+
+  // The other one never sends its data. Its timings were invalidated above, but their
+  // entries are kept, so that it does not allocate them again in the next frame.
+  other.prvt->counts.clear();
+}
+
+bool TimingManager::setPerformanceCounters(bool enable)
+{
+  if(enable && !prvt->countersEnabled && !prvt->countersFailed)
+  {
+    prvt->countersEnabled = prvt->counters.open();
+    if(!prvt->countersEnabled)
+    {
+      prvt->countersFailed = true;
+      OUTPUT_WARNING("TimingManager: performance counters are not available!");
+    }
+  }
+  else if(!enable && prvt->countersEnabled)
+  {
+    prvt->counters.close();
+    prvt->counts.clear();
+    prvt->startReadings.clear();
+    prvt->countersEnabled = false;
+  }
+  return prvt->countersEnabled;
+}
+
+bool TimingManager::hasPerformanceCounters() const
+{
+  return prvt->countersEnabled;
+}
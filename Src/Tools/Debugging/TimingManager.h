@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include "PerformanceCounters.h"
+#include <vector>
+#include <utility>
+
 class Process;
 class MessageQueue;
 /**
@@ -28,7 +32,8 @@ public:
   /**The TimingManager has a special stopwatch that is used to keep track
    * of the overall process time.
    * You should call signalProcessStart at the beginning of every process iteration.
-   * It is used to calculate the frequency of the process. */
+   * It is used to calculate the frequency of the process. The times and counts of
+   * the previous frame are forgotten. */
   void signalProcessStart();
 
   /**Tells the TimingManager that the current process iteration is over.*/
@@ -38,6 +43,29 @@ public:
    *  Call this method in between signalProcessStop() and signalProcessStart.*/
   MessageQueue& getData();
 
+  /**Returns the names of all stopwatches measured in the current frame and their times in us.
+   * Call this method in between signalProcessStop() and signalProcessStart().*/
+  std::vector<std::pair<const char*, unsigned> > getTimes() const;
+
+  /**Returns the names of all stopwatches that were measured in the current frame while the
+   * performance counters were enabled and the counts they measured.
+   * Call this method in between signalProcessStop() and signalProcessStart().*/
+  std::vector<std::pair<const char*, PerformanceCounters::Values> > getCounters() const;
+
+  /**Adds the times and counts measured by another TimingManager, e.g. the one of a worker
+   * thread, to this one. The stopwatches of the other TimingManager are reset. */
+  void takeTimes(TimingManager& other);
+
+  /**Enables or disables measuring the hardware performance counters of each stopwatch.
+   * The counters are opened for the calling thread, so this must be called by the
+   * thread that uses the stopwatches. If they are enabled, getData() also contains
+   * the counts.
+   * @return Are the counters enabled? They are not if they cannot be opened. */
+  bool setPerformanceCounters(bool enable);
+
+  /**Are the hardware performance counters measured?*/
+  bool hasPerformanceCounters() const;
+
 
 private:
   /**Prepares timing data for streaming*/
@@ -47,6 +75,7 @@ private:
   Pimpl* prvt;
 
   friend class Process;
-  TimingManager(); //private so only Process can access it.
+  friend class ModuleManager;
+  TimingManager(); //private so only Process and the ModuleManager can access it.
   ~TimingManager();
 };
\ No newline at end of file
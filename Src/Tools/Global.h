@@ -94,9 +94,11 @@ public:
 
   friend class Process; // The class Process can set these pointers.
   friend class Cognition; // The class Cognition can set theTeamOut.
+  friend class PerceptionBench; // The class PerceptionBench can set theTeamOut.
   friend class Settings; // The class Settings can set a default StreamHandler.
   friend class ConsoleRoboCupCtrl; // The class ConsoleRoboCupCtrl can set theStreamHandler.
   friend class RobotConsole; // The class RobotConsole can set theDebugOut.
   friend class TeamComm3DCtrl;
   friend class Framework;
+  friend class ModuleManager; // The class ModuleManager sets these pointers in its worker threads.
 };
@@ -0,0 +1,52 @@
+/**
+* @file JPEGEncoder.cpp
+* Implementation of a class that compresses images to JPEG in other threads.
+*/
+
+#include "JPEGEncoder.h"
+#include <algorithm>
+
+JPEGEncoder::JPEGEncoder(int numOfWorkers) : image(0), sliceHeight(0)
+{
+  ASSERT(numOfWorkers > 0);
+  for(int i = 0; i < numOfWorkers; ++i)
+    workers.push_back(new Worker);
+}
+
+JPEGEncoder::~JPEGEncoder()
+{
+  if(image)
+    finish();
+  for(Worker* worker : workers)
+    delete worker;
+}
+
+void JPEGEncoder::start(const Image& image)
+{
+  ASSERT(!this->image);
+  ASSERT(image.height > 0);
+  this->image = &image;
+
+  // All slices except for the last one consist of complete blocks of 8 rows.
+  // Therefore, there might be less slices than workers.
+  const int numOfWorkers = int(workers.size());
+  sliceHeight = ((image.height + numOfWorkers - 1) / numOfWorkers + 7) & ~7;
+  slices.resize((image.height + sliceHeight - 1) / sliceHeight);
+  for(size_t i = 0; i < slices.size(); ++i)
+  {
+    const int yStart = int(i) * sliceHeight;
+    const int yEnd = std::min(yStart + sliceHeight, image.height);
+    std::vector<unsigned char>& slice = slices[i];
+    workers[i]->start([&image, yStart, yEnd, &slice]() {JPEGImage::compressSlice(image, yStart, yEnd, slice);});
+  }
+}
+
+const JPEGImage& JPEGEncoder::finish()
+{
+  ASSERT(image);
+  for(size_t i = 0; i < slices.size(); ++i)
+    workers[i]->wait();
+  jpegImage.combineSlices(*image, slices, sliceHeight);
+  image = 0;
+  return jpegImage;
+}
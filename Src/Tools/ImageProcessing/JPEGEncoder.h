@@ -0,0 +1,57 @@
+/**
+* @file JPEGEncoder.h
+* Declaration of a class that compresses images to JPEG in other threads.
+*/
+
+#pragma once
+
+#include "Representations/Perception/JPEGImage.h"
+#include "Tools/Worker.h"
+#include <vector>
+
+/**
+* @class JPEGEncoder
+* The class splits an image into horizontal slices and compresses each slice
+* in a worker thread. The thread that started the compression can continue
+* with other work until it needs the result. The slices are combined into a
+* single JPEG stream that is decompressed like any other JPEGImage.
+*/
+class JPEGEncoder
+{
+private:
+  std::vector<Worker*> workers; /**< The threads that compress the slices, one per slice. */
+  std::vector<std::vector<unsigned char> > slices; /**< The JPEG streams of the slices of the current image. */
+  const Image* image; /**< The image currently compressed or 0 if there is none. */
+  int sliceHeight; /**< The height of all slices except for the last one. */
+  JPEGImage jpegImage; /**< The compressed image returned by finish(). */
+
+public:
+  /**
+  * Constructor.
+  * @param numOfWorkers The number of threads that compress slices in parallel.
+  */
+  JPEGEncoder(int numOfWorkers);
+
+  /**
+  * Destructor. Waits for a compression that is still running.
+  */
+  ~JPEGEncoder();
+
+  /**
+  * Starts compressing an image.
+  * @param image The image. It must not be changed or freed before finish() was called.
+  */
+  void start(const Image& image);
+
+  /**
+  * Was the compression of an image started that was not finished yet?
+  * @return Is finish() expected to be called?
+  */
+  bool isBusy() const {return image != 0;}
+
+  /**
+  * Waits until all slices of the current image were compressed and combines them.
+  * @return The compressed image. It remains valid until the next call of finish().
+  */
+  const JPEGImage& finish();
+};
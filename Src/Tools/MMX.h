@@ -14,7 +14,8 @@
 
 #include <tmmintrin.h>
 
-#ifdef TARGET_SIM
+// The simulator may run on processors without SSSE3, unless it is compiled for them.
+#if defined(TARGET_SIM) && !defined(__SSSE3__)
 inline __m128i my_mm_shuffle_epi8(const __m128i& a, const __m128i& m)
 {
   __m128i r;
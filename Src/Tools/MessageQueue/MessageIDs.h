@@ -66,6 +66,7 @@ ENUM(MessageID,
   idExpRobotPercept,
   idObstacleWheel,
   idBodyContour,
+  idLosslessImage,
   // insert new data ids here
 
   numOfDataMessageIDs, /**< everything below this does not belong into log files */
@@ -122,5 +123,6 @@ ENUM(MessageID,
   idRobotDimensions,
   idJointCalibration,
   idUSRequest,
-  idWalkingEngineKick
+  idWalkingEngineKick,
+  idPerformanceCounters
 );
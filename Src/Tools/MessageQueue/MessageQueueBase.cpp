@@ -231,6 +231,7 @@ void MessageQueueBase::removeRepetitions()
 
       // data only from latest frame
     case idStopwatch:
+    case idPerformanceCounters:
     case idDebugImage:
     case idDebugJPEGImage:
     case idDebugDrawing:
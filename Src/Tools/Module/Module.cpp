@@ -9,6 +9,7 @@
 
 std::list<Requirements::Entry>* Requirements::entries = 0;
 std::list<Representations::Entry>* Representations::entries = 0;
+std::list<const char*>* Usages::entries = 0;
 ModuleBase* ModuleBase::first = 0;
 
 void Requirements::add(const char* name, void (*create)(), void (*free)(), void (*in)(In&))
@@ -17,7 +18,13 @@ void Requirements::add(const char* name, void (*create)(), void (*free)(), void
     entries->push_back(Entry(name, create, free, in));
 }
 
-void Representations::add(const char* name, void (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&))
+void Usages::add(const char* name)
+{
+  if(entries)
+    entries->push_back(name);
+}
+
+void Representations::add(const char* name, bool (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&))
 {
   if(entries)
     entries->push_back(Entry(name, update, create, free, out));
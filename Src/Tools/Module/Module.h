@@ -33,6 +33,20 @@
 * In the implementation file, the existence of the module has to be announced:
 *
 * MAKE_MODULE(MyImageProcessor)
+*
+* Modules whose results are not needed every frame can be announced as optional
+* together with the time they are expected to take (in ms). The module manager
+* skips them in frames that would otherwise miss their deadline:
+*
+* MAKE_OPTIONAL_MODULE(MyImageProcessor, Perception, 2.f)
+*
+* The module manager counts a new version of a representation each time its provider
+* is executed. Providers that did not change their representation in an update can
+* call keepVersion(). Modules whose update methods only depend on their requirements
+* and usages can be announced as pure. The module manager does not execute them if
+* none of these representations got a new version since their last execution:
+*
+* MAKE_PURE_MODULE(MyImageProcessor, Perception)
 */
 
 #pragma once
@@ -125,6 +139,45 @@ public:
   void operator=(const Requirement&) {add(getName(), create, free, in);}
 };
 
+/**
+* @class Usages
+* The class collects all representations a certain module uses, i.e. the
+* representations that are accessed but need not to be updated before the
+* module is executed.
+* Its contents are only temporary and will be created and deleted for
+* each module.
+*/
+class Usages
+{
+public:
+  typedef std::list<const char*> List; /**< Type of the list of all usages. */
+  static List* entries; /**< A pointer to the list of all usages. Valid while recording, i.e. when != 0. */
+
+protected:
+  /**
+  * The method adds a new usage to the list but only if the class
+  * is currently in recording mode.
+  * @param name The name of the representation used.
+  */
+  void add(const char* name);
+};
+
+/**
+* @class Usage
+* The class adds a single usage to the list of usages.
+* It works like the class Requirement.
+* @param getName A function which returns the name of the representation.
+*/
+template<const char * (*getName)()> class Usage : private Usages
+{
+public:
+  /**
+  * The assignment operator add the name of the template parameter
+  * as a usage.
+  */
+  void operator=(const Usage&) {add(getName());}
+};
+
 /**
 * @class Representations
 * The class collects all representations a certain module provides.
@@ -141,7 +194,7 @@ public:
   {
   public:
     const char* name; /**< The name of the representation. */
-    void (*update)(Blackboard&); /**< The handler that is called to update the representation. */
+    bool (*update)(Blackboard&); /**< The handler that is called to update the representation. Returns whether it was changed. */
     void (*create)(); /**< The handler that is called to create a new instance of the representation. */
     void (*free)(); /**< The handler that is called to delete the instance of the representation. */
     void (*out)(Out&); /**< The handler that is called to write the instance of the representation to a stream. */
@@ -154,7 +207,7 @@ public:
     * @param free The handler that is called to delete the instance of the representation.
     * @param out The handler that is called to write the instance of the representation to a stream.
     */
-    Entry(const char* name, void (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&)) :
+    Entry(const char* name, bool (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&)) :
       name(name),
       update(update),
       create(create),
@@ -183,7 +236,7 @@ protected:
   * @param free The handler that is called to delete the instance of the representation.
   * @param out The handler that is called to write the instance of the representation to a stream.
   */
-  void add(const char* name, void (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&));
+  void add(const char* name, bool (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&));
 };
 
 /**
@@ -199,7 +252,7 @@ protected:
 * @param free The handler that is called to delete the instance of the representation.
 * @param out The handler that is called to write the instance of the representation to a stream.
 */
-template<const char * (*getName)(), void (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&)>
+template<const char * (*getName)(), bool (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&)>
 class Representation : private Representations
 {
 public:
@@ -224,9 +277,13 @@ private:
   ModuleBase* next; /**< The next entry in the list of all modules. */
   const char* name, /**< The name of the module that can be created by this instance. */
             * category; /**< The name of the category of this module. */
+  float expectedCost; /**< The time in ms the module is expected to take if it is optional. 0 if it is not optional. */
+  bool concurrent; /**< Can the module be executed by a worker thread of the module manager? */
+  bool pure; /**< Do the update methods of the module only depend on its requirements and usages? */
 
 protected:
   Requirements::List requirements; /**< The list of all requirements of the module created by this instance. */
+  Usages::List usages; /**< The list of all representations used by the module created by this instance. */
   Representations::List representations; /**< The list of all representations provided by the module created by this instance. */
 
   /**
@@ -240,11 +297,17 @@ public:
   * Constructor.
   * @param name The name of the module that can be created by this instance.
   * @param category The name of the category of this module.
+  * @param expectedCost The time in ms an optional module is expected to take. 0 if the module is not optional.
+  * @param concurrent Can the module be executed by a worker thread of the module manager?
+  * @param pure Do the update methods of the module only depend on its requirements and usages?
   */
-  ModuleBase(const char* name, const char* category) :
+  ModuleBase(const char* name, const char* category, float expectedCost = 0.f, bool concurrent = false, bool pure = false) :
     next(first),
     name(name),
-    category(category)
+    category(category),
+    expectedCost(expectedCost),
+    concurrent(concurrent),
+    pure(pure)
   {
     first = this;
   }
@@ -288,17 +351,22 @@ public:
   * and it is used to do the registration of the information required.
   * @param name The name of the module that can be created by this instance.
   * @param category The name of the category of this module.
+  * @param expectedCost The time in ms an optional module is expected to take. 0 if the module is not optional.
+  * @param concurrent Can the module be executed by a worker thread of the module manager?
+  * @param pure Do the update methods of the module only depend on its requirements and usages?
   */
-  Module(const char* name, const char* category)
-    : ModuleBase(name, category)
+  Module(const char* name, const char* category, float expectedCost = 0.f, bool concurrent = false, bool pure = false)
+    : ModuleBase(name, category, expectedCost, concurrent, pure)
   {
     Representations::entries = &representations;
     Requirements::entries = &requirements;
+    Usages::entries = &usages;
     char buf[sizeof(B)] = {0};
     // executes assignment operators -> recording information!
     (B&) *buf = (const B&) *buf;
     Representations::entries = 0;
     Requirements::entries = 0;
+    Usages::entries = 0;
   }
 };
 
@@ -330,6 +398,7 @@ void loadModuleParameters(Streamable& parameters, const char* moduleName, const
     friend class NonExistent; /* avoid warnings about unused private fields */ \
   private: static PROCESS_WIDE_STORAGE(_Me) _this; \
     int _parameterType; /* 0: no params, 1: define them, 2: load them. */ \
+    bool _changed; /* Did the update method called last change its representation? */ \
     class _InitFirstAttribute \
     { \
     public: \
@@ -341,7 +410,14 @@ void loadModuleParameters(Streamable& parameters, const char* moduleName, const
     { \
       if(_parameterType) \
         MODIFY("parameters:" #module, *this); \
-    }
+    } \
+  protected: \
+    /** \
+    * The method can be called by an update method that did not change its representation. \
+    * The representation will keep its version. \
+    */ \
+    void keepVersion() {_changed = false;} \
+  private:
 
 #define DEFINES_PARAMETER(type, name, ...) \
   _STREAM_EXPAND(_STREAM_EXPAND(_STREAM_THIRD(__VA_ARGS__, _DEFINES_PARAMETER_WITH_CLASS, _DEFINES_PARAMETER_WITHOUT_CLASS))(type, name, __VA_ARGS__))
@@ -441,7 +517,15 @@ void loadModuleParameters(Streamable& parameters, const char* moduleName, const
 * @param representation The representation that is used.
 */
 #define USES(representation) \
-  protected: using Blackboard::the##representation;
+  protected: using Blackboard::the##representation; \
+  \
+  private: \
+  /** \
+  * The method returns the name of the representation. \
+  */ \
+  static const char* getName3##representation() {return #representation;}\
+  \
+  Usage<&_Me::getName3##representation> y##representation;
 
 /**
 * The macro defines a representation that is updated by this module.
@@ -577,15 +661,18 @@ void loadModuleParameters(Streamable& parameters, const char* moduleName, const
   /** \
   * The method is called to update the representation by this module. \
   * @param b The module. \
+  * @return Was the representation changed, i.e. did the module not call keepVersion()? \
   */ \
-  private: static void update##representation(Blackboard& b) \
+  private: static bool update##representation(Blackboard& b) \
   { \
     ((_Me&) b)._modifyParameters(); \
     const representation& r = ((_Me*) (Blackboard*) Blackboard::theInstance)->the##representation; \
     ASSERT(&r); \
     BH_TRACE; \
+    ((_Me&) b)._changed = true; \
     STOP_TIME_ON_REQUEST_WITH_PLOT(#representation, ((_Me&) b).update(const_cast<representation&>(r)); ); \
     mod \
+    return ((_Me&) b)._changed; \
   } \
   \
   /** \
@@ -678,3 +765,60 @@ void loadModuleParameters(Streamable& parameters, const char* moduleName, const
 #define MAKE_MODULE(module, category) \
   MAKE_SOLUTION(module, module, category) \
   PROCESS_WIDE_STORAGE(module##Base) module##Base::_this;
+
+/**
+* The macro creates a creator for an optional module. The module manager may skip
+* such a module if executing it would let the current frame exceed its time budget.
+* See beginning of this file.
+* It has to be part of the implementation file.
+* @param module The name of the module that can be created.
+* @param category The name of the category of this module.
+* @param expectedCost The time in ms the module is expected to take.
+*/
+#define MAKE_OPTIONAL_MODULE(module, category, expectedCost) \
+  Module<module, module##Base> the##module##Module(#module, #category, expectedCost); \
+  PROCESS_WIDE_STORAGE(module##Base) module##Base::_this;
+
+/**
+* The macro creates a creator for a module that can be executed by a worker thread
+* of the module manager in parallel to other modules. Such a module must only access
+* the blackboard through its requirements, usages, and the representations it
+* provides. It must neither keep process-wide instance pointers nor send team
+* messages. Its debug output is only available if it is executed by the process
+* itself, which the module manager ensures while debug requests are active.
+* See beginning of this file.
+* It has to be part of the implementation file.
+* @param module The name of the module that can be created.
+* @param category The name of the category of this module.
+*/
+#define MAKE_CONCURRENT_MODULE(module, category) \
+  Module<module, module##Base> the##module##Module(#module, #category, 0.f, true); \
+  PROCESS_WIDE_STORAGE(module##Base) module##Base::_this;
+
+/**
+* The macro creates a creator for a pure module, i.e. a module whose update methods
+* only depend on its requirements and usages, but neither on the previous contents
+* of the representations provided nor on any other state. The module manager does
+* not execute the update methods of such a module if none of these representations
+* got a new version since they were executed last. Their debug output is only
+* generated when they are executed, which the module manager ensures while debug
+* requests are active.
+* See beginning of this file.
+* It has to be part of the implementation file.
+* @param module The name of the module that can be created.
+* @param category The name of the category of this module.
+*/
+#define MAKE_PURE_MODULE(module, category) \
+  Module<module, module##Base> the##module##Module(#module, #category, 0.f, false, true); \
+  PROCESS_WIDE_STORAGE(module##Base) module##Base::_this;
+
+/**
+* The macro creates a creator for a pure module that can also be executed by a worker
+* thread of the module manager. See MAKE_PURE_MODULE and MAKE_CONCURRENT_MODULE.
+* It has to be part of the implementation file.
+* @param module The name of the module that can be created.
+* @param category The name of the category of this module.
+*/
+#define MAKE_PURE_CONCURRENT_MODULE(module, category) \
+  Module<module, module##Base> the##module##Module(#module, #category, 0.f, true, true); \
+  PROCESS_WIDE_STORAGE(module##Base) module##Base::_this;
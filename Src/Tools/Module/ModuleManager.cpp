@@ -6,10 +6,129 @@
 
 #include "ModuleManager.h"
 #include "Platform/BHAssert.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Tools/Debugging/DebugDataTable.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Debugging/DebugDrawings3D.h"
+#include "Tools/Debugging/DebugRequest.h"
+#include "Tools/Debugging/TimingManager.h"
+#include "Tools/MessageQueue/MessageQueue.h"
 #include "Tools/Streams/InStreams.h"
+#include "Tools/Streams/OutStreams.h"
+#include "Tools/Streams/StreamHandler.h"
+#include "Tools/Worker.h"
 #include <algorithm>
+#include <cstring>
 #include <set>
 
+PROCESS_WIDE_STORAGE(ModuleManager) ModuleManager::theInstance = 0;
+
+/**
+ * A worker thread of the module manager together with the debugging environment
+ * of the providers it executes. The debugging objects of the process are not
+ * thread-safe. Instead, the worker thread has its own ones. No debug requests are
+ * active in them. Messages and times are passed to the process after each frame.
+ */
+class ModuleManager::Executor
+{
+public:
+  MessageQueue debugOut; /**< The debug messages written in the current frame. */
+  MessageQueue teamOut; /**< The team messages written in the current frame. */
+  DebugRequestTable debugRequestTable; /**< Always empty. */
+  DebugDataTable debugDataTable; /**< Always empty. */
+  StreamHandler streamHandler;
+  DrawingManager drawingManager;
+  DrawingManager3D drawingManager3D;
+  TimingManager timingManager; /**< The times measured in the current frame. */
+  Settings* settings; /**< The settings of the process. */
+  Blackboard* blackboard; /**< The blackboard of the process. */
+  bool traceInitialized; /**< Was the trace of the worker thread already initialized? */
+  Worker worker; /**< The thread. It is stopped before the objects above are destroyed. */
+
+  Executor() : settings(0), blackboard(0), traceInitialized(false)
+  {
+    debugOut.setSize(1000000);
+    teamOut.setSize(1384);
+  }
+
+  /**
+   * The method sets the pointers in the classes Global and Blackboard of the
+   * thread calling it.
+   */
+  void setGlobals()
+  {
+    Global::theDebugOut = &debugOut.out;
+    Global::theTeamOut = &teamOut.out;
+    Global::theSettings = settings;
+    Global::theDebugRequestTable = &debugRequestTable;
+    Global::theDebugDataTable = &debugDataTable;
+    Global::theStreamHandler = &streamHandler;
+    Global::theDrawingManager = &drawingManager;
+    Global::theDrawingManager3D = &drawingManager3D;
+    Global::theTimingManager = &timingManager;
+    Blackboard::theInstance = blackboard;
+  }
+};
+
+/**
+ * The perception of one camera. Its providers are executed by a thread of its own
+ * on a blackboard of its own, so that the images of both cameras can be processed
+ * at the same time. Therefore, the pipeline also has its own instances of the
+ * modules it executes, i.e. they keep their state per camera. The inputs of each
+ * image are copied to the blackboard of the pipeline and the results the process
+ * reads are copied back. Both is done by streaming, because some representations
+ * contain pointers to their own data.
+ */
+class ModuleManager::Pipeline
+{
+public:
+  Executor executor; /**< The thread and its debugging environment. Its blackboard is the one of the pipeline. */
+  std::map<const ModuleState*, Blackboard*> instances; /**< The instances of the modules executed by the pipeline. */
+  std::vector<bool> demanded; /**< Which tasks are demanded for the current image? */
+  std::vector<char> inputs; /**< The inputs of the current image written by the process. */
+  std::vector<char> outputs; /**< The results of the current image written by the pipeline. */
+  bool created; /**< Were the representations created on the blackboard of the pipeline? */
+  bool running; /**< Was an image started that was not finished yet? */
+  bool performanceCounters; /**< Does the process measure the hardware performance counters for the current image? */
+
+  Pipeline() : created(false), running(false), performanceCounters(false)
+  {
+    executor.blackboard = new Blackboard;
+  }
+
+  ~Pipeline()
+  {
+    delete executor.blackboard;
+  }
+};
+
+/**
+ * A message handler that appends all messages to another message queue, which
+ * is only accessible through its output stream.
+ */
+class MessageForwarder : public MessageHandler
+{
+private:
+  OutMessage& out; /**< The stream the messages are appended to. */
+
+public:
+  MessageForwarder(OutMessage& out) : out(out) {}
+
+  bool handleMessage(InMessage& message)
+  {
+    char buffer[1024];
+    for(int left = message.getMessageSize(); left > 0;)
+    {
+      const int size = std::min(left, (int) sizeof(buffer));
+      message.bin.read(buffer, size);
+      out.bin.write(buffer, size);
+      left -= size;
+    }
+    out.finishMessage(message.getMessageID());
+    return true;
+  }
+};
+
 ModuleManager::Configuration::RepresentationProvider::RepresentationProvider(const std::string& representation,
                                                                              const std::string& provider)
 : representation(representation),
@@ -34,7 +153,24 @@ void DefaultModule::setRepresentations(const std::list<ModuleManager::ModuleStat
 ModuleManager::ModuleManager(const char** categories, size_t numOfCategories) :
   timeStamp(0),
   defaultModule(new DefaultModule),
-  otherDefaultModule(new DefaultModule)
+  otherDefaultModule(new DefaultModule),
+  frameStart(0),
+  remaining(0.f),
+  planned(false),
+  concurrentTasks(false),
+  lazyTasks(false),
+  pureTasks(false),
+  memoize(false),
+  modifying(false),
+  lastVersion(0),
+  pipelineTasks(false),
+  pending(0),
+  lastFinished(0),
+  processNext(0),
+  workerNext(0),
+  numOfFinished(0),
+  finished(false),
+  performanceCounters(false)
 {
   std::set<std::string> filter;
   for(int i = 0; i < (int) numOfCategories; ++i)
@@ -56,6 +192,10 @@ ModuleManager::ModuleManager(const char** categories, size_t numOfCategories) :
 ModuleManager::~ModuleManager()
 {
   destroy();
+  for(Executor* executor : executors)
+    delete executor;
+  if(theInstance == this)
+    theInstance = 0;
 }
 
 void ModuleManager::destroy()
@@ -151,6 +291,9 @@ bool ModuleManager::calcShared(const Configuration& config, const std::string& r
 
 void ModuleManager::update(In& stream, unsigned timeStamp)
 {
+  // The pipelines use the representations and the modules of the current configuration.
+  destroyPipelines();
+
   std::list<Provider> providersToDelete(providers),
                       providersToCreate,
                       providersBackup(providers);
@@ -192,7 +335,7 @@ void ModuleManager::update(In& stream, unsigned timeStamp)
         for(i = j->module->representations.begin(); i != j->module->representations.end(); ++i)
           if(rp.representation == i->name)
           {
-            Provider provider(i->name, &*j, i->update, i->create, i->free);
+            Provider provider(i->name, &*j, i->update, i->create, i->free, i->out);
             std::list<Provider>::iterator m = std::find(providers.begin(), providers.end(), provider);
             if(m == providers.end())
             {
@@ -281,6 +424,7 @@ void ModuleManager::update(In& stream, unsigned timeStamp)
       j->create();
   }
 
+  buildGraph();
   this->timeStamp = timeStamp;
 }
 
@@ -355,6 +499,227 @@ void ModuleManager::rollBack(const std::list<Provider>& providers, const std::li
   this->shared = shared;
   for(std::list<ModuleState>::iterator j = modules.begin(); j != modules.end(); ++j)
     j->required = j->requiredBackup;
+  buildGraph();
+}
+
+bool ModuleManager::reads(const ModuleState& moduleState, const std::string& representation)
+{
+  const Requirements::List& requirements = moduleState.module->requirements;
+  if(std::find(requirements.begin(), requirements.end(), representation) != requirements.end())
+    return true;
+  for(const char* usage : moduleState.module->usages)
+    if(representation == usage)
+      return true;
+  return false;
+}
+
+bool ModuleManager::isExecuted(const Provider& provider) const
+{
+  return provider.moduleState->required && provider.moduleState->module != defaultModule;
+}
+
+void ModuleManager::buildGraph()
+{
+  planned = false;
+  plan.clear();
+  tasks.clear();
+  concurrentTasks = false;
+  lazyTasks = false;
+  pureTasks = false;
+  const std::vector<std::string>& lazyRepresentations = parameters.lazyRepresentations;
+  for(Provider& provider : providers)
+    if(isExecuted(provider))
+    {
+      const ModuleBase& module = *provider.moduleState->module;
+      tasks.push_back(Task(&provider, module.concurrent && !module.expectedCost));
+      Task& task = tasks.back();
+      concurrentTasks |= task.concurrent;
+
+      // Representations received from other processes change in every frame.
+      task.pure = module.pure;
+      if(task.pure)
+      {
+        for(const Requirements::Entry& requirement : module.requirements)
+          for(const Shared& s : shared)
+            task.sharedInput |= s.in && s.representation == requirement.name;
+        for(const char* usage : module.usages)
+          for(const Shared& s : shared)
+            task.sharedInput |= s.in && s.representation == usage;
+        pureTasks = true;
+      }
+
+      // Representations sent to other processes are always demanded.
+      if(std::find(lazyRepresentations.begin(), lazyRepresentations.end(), provider.representation) != lazyRepresentations.end())
+      {
+        std::list<Shared>::const_iterator s = std::find(shared.begin(), shared.end(), provider.representation);
+        task.lazy = s == shared.end() || !s->out;
+        task.request = "representation:" + provider.representation;
+        lazyTasks |= task.lazy;
+      }
+    }
+
+  for(int j = 0; j < (int) tasks.size(); ++j)
+  {
+    const ModuleState& moduleState = *tasks[j].provider->moduleState;
+    for(int i = 0; i < j; ++i)
+    {
+      const ModuleState& other = *tasks[i].provider->moduleState;
+      if(&other == &moduleState ||
+         reads(moduleState, tasks[i].provider->representation) ||
+         reads(other, tasks[j].provider->representation))
+      {
+        tasks[i].successors.push_back(j);
+        ++tasks[j].numOfPredecessors;
+      }
+    }
+  }
+
+#ifndef NDEBUG
+  // Concurrent tasks are checked for writing representations they only read.
+  for(int j = 0; j < (int) tasks.size(); ++j)
+    if(tasks[j].concurrent)
+      for(int i = 0; i < (int) tasks.size(); ++i)
+        if(tasks[i].provider->moduleState != tasks[j].provider->moduleState &&
+           reads(*tasks[j].provider->moduleState, tasks[i].provider->representation))
+          tasks[j].readOnly.push_back(i);
+#endif
+
+  // A task may also read representations that are updated after it, i.e. in the previous frame.
+  if(lazyTasks || pureTasks)
+    for(int j = 0; j < (int) tasks.size(); ++j)
+      for(int i = 0; i < (int) tasks.size(); ++i)
+        if(i != j && reads(*tasks[j].provider->moduleState, tasks[i].provider->representation))
+          tasks[j].inputs.push_back(i);
+
+  // The providers of a module may share state, so a module is either executed completely or not at all.
+  if(lazyTasks)
+    for(int j = 0; j < (int) tasks.size(); ++j)
+      for(int i = 0; i < (int) tasks.size(); ++i)
+        if(i != j && tasks[i].provider->moduleState == tasks[j].provider->moduleState)
+          tasks[j].siblings.push_back(i);
+
+  processQueue.reserve(tasks.size());
+  workerQueue.reserve(tasks.size());
+  assignStages();
+}
+
+void ModuleManager::assignStages()
+{
+  pipelineTasks = false;
+  pipelineRepresentations.clear();
+  pipelineInputs.clear();
+  pipelineOutputs.clear();
+  if(!parameters.cameraPipelines)
+    return;
+
+  bool perception = false;
+  for(Task& task : tasks)
+  {
+    task.stage = strcmp(task.provider->moduleState->module->category, "Perception") ? afterPipeline : inPipeline;
+    perception |= task.stage == inPipeline;
+  }
+  if(!perception)
+    return;
+
+  // Since all edges of the graph point forward, one pass in each direction finds
+  // the tasks that depend on the perception and the ones the perception depends on.
+  std::vector<bool> follows(tasks.size(), false);
+  std::vector<bool> precedes(tasks.size(), false);
+  for(size_t i = 0; i < tasks.size(); ++i)
+    if(tasks[i].stage == inPipeline || follows[i])
+      for(int successor : tasks[i].successors)
+        follows[successor] = true;
+  for(size_t i = tasks.size(); i-- > 0;)
+    for(int successor : tasks[i].successors)
+      if(tasks[successor].stage == inPipeline || precedes[successor])
+        precedes[i] = true;
+  for(size_t i = 0; i < tasks.size(); ++i)
+    if(tasks[i].stage != inPipeline && precedes[i])
+      tasks[i].stage = follows[i] ? inPipeline : beforePipeline;
+
+  // A module is executed completely by either the process or the pipelines, because its providers may share state.
+  for(const Task& task : tasks)
+    for(const Task& other : tasks)
+      if(task.provider->moduleState == other.provider->moduleState && task.stage != other.stage)
+      {
+        OUTPUT_WARNING("Camera pipelines disabled: " << task.provider->moduleState->module->name
+                       << " would be executed partially in them");
+        return;
+      }
+
+  // The pipelines have all representations their tasks read or provide that exist in the process.
+  std::vector<std::string> names;
+  for(const Task& task : tasks)
+    if(task.stage == inPipeline)
+    {
+      const ModuleBase& module = *task.provider->moduleState->module;
+      names.push_back(task.provider->representation);
+      for(const Requirements::Entry& requirement : module.requirements)
+        names.push_back(requirement.name);
+      for(const char* usage : module.usages)
+        names.push_back(usage);
+    }
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+
+  for(const std::string& name : names)
+  {
+    bool provided = false;
+    bool continued = false;
+    for(const Task& task : tasks)
+      if(task.stage == inPipeline && task.provider->representation == name)
+      {
+        provided = true;
+        continued |= reads(*task.provider->moduleState, name);
+      }
+    std::list<Shared>::const_iterator s = std::find(shared.begin(), shared.end(), name);
+    if(!provided && std::find(providers.begin(), providers.end(), name) == providers.end() && (s == shared.end() || !s->in))
+      continue;
+
+    Shared representation(name);
+    bool read = false;
+    for(const Task& task : tasks)
+      read |= task.stage == afterPipeline && reads(*task.provider->moduleState, name);
+    if(!findHandlers(representation) || ((!provided || read || continued) && !representation.in))
+    {
+      OUTPUT_WARNING("Camera pipelines disabled: " << name << " cannot be copied");
+      return;
+    }
+    pipelineRepresentations.push_back(representation);
+
+    // A provider that reads its own representation continues the previous result, which may be of the other camera.
+    if(!provided || continued)
+      pipelineInputs.push_back(representation);
+    if(read || continued)
+      pipelineOutputs.push_back(representation);
+  }
+
+  // The pipeline is selected by the camera of the image.
+  if(std::find(pipelineInputs.begin(), pipelineInputs.end(), std::string("CameraInfo")) == pipelineInputs.end())
+  {
+    OUTPUT_WARNING("Camera pipelines disabled: They do not read the CameraInfo");
+    return;
+  }
+  pipelineTasks = true;
+}
+
+bool ModuleManager::findHandlers(Shared& shared)
+{
+  // All modules can handle the representations they require or provide on any blackboard.
+  for(ModuleBase* i = ModuleBase::first; i; i = i->next)
+  {
+    Representations::List::const_iterator r = std::find(i->representations.begin(), i->representations.end(), shared.representation);
+    if(r != i->representations.end())
+    {
+      shared.create = r->create;
+      shared.free = r->free;
+      shared.out = r->out;
+    }
+    Requirements::List::const_iterator q = std::find(i->requirements.begin(), i->requirements.end(), shared.representation);
+    if(q != i->requirements.end())
+      shared.in = q->in;
+  }
+  return shared.create && shared.free && shared.out;
 }
 
 void ModuleManager::load()
@@ -365,33 +730,71 @@ void ModuleManager::load()
     OUTPUT_ERROR("failed to load modules.cfg correctly.");
     ASSERT(true); // since when modules aren't loaded correctly ther come up other failures
   }
+
+  // The lazy representations must be known before the dependency graph is built.
+  InMapFile parametersStream("moduleManager.cfg");
+  if(parametersStream.exists())
+    parametersStream >> parameters;
+
   update(stream);
 }
 
-void ModuleManager::execute()
+void ModuleManager::execute(unsigned budget, const std::function<void()>& imageFinished)
 {
-  // Execute all providers in the given sequence
-  for(std::list<Provider>::iterator i = providers.begin(); i != providers.end(); ++i)
-    if(i->moduleState->required)
+  theInstance = this;
+  this->imageFinished = imageFinished;
+  frameBudget.budget = budget;
+  frameBudget.skipped.clear();
+  frameBudget.notDemanded.clear();
+  frameStart = SystemCall::getCurrentSystemTime();
+  modifying = !Global::getDebugDataTable().isEmpty();
+  memoize = pureTasks && !isDebugging();
+
+  if(!planned)
+  {
+    executeOnce();
+    compilePlan();
+    if(imageFinished)
+      imageFinished();
+  }
+  else
+  {
+    if(lazyTasks)
+      determineDemand();
+
+    if(canExecuteInPipelines())
+      executeInPipelines();
+    else
     {
-      if(!i->moduleState->instance)
-        i->moduleState->instance = i->moduleState->module->createNew(); // returns 0 if provided by "default"
-#ifdef TARGET_ROBOT
-      unsigned timeStamp = SystemCall::getCurrentSystemTime();
-#endif
-      if(i->moduleState->instance)
-        i->update(*i->moduleState->instance);
+      // The process executes everything itself again, so the image pending is finished first.
+      finishPendingImage(imageFinished);
+      lastFinished = 0;
+
+      estimateRemaining(allStages);
+      if(canExecuteInParallel())
+        executeInParallel();
+      else
+        executePlan();
+      if(imageFinished)
+        imageFinished();
+    }
+
 #ifdef TARGET_ROBOT
-      int duration = SystemCall::getTimeSince(timeStamp);
-      if(duration > 100 &&
-         ((!Global::getDebugRequestTable().isActive("representation:JPEGImage") &&
-           !Global::getDebugRequestTable().isActive("representation:Image")) ||
-          duration > 500))
-        TRACE("TIMING: providing %s took %d ms at %d s after start",
-              i->representation.c_str(), duration, timeStamp / 1000 - 10);
+    for(size_t i = 0; i < plan.size(); ++i)
+      if(durations[i] >= 0)
+      {
+        Step& step = plan[i];
+        *step.averageDuration = *step.averageDuration * 0.9f + float(durations[i]) * 0.1f;
+        if(durations[i] > 100 &&
+           (!Global::getDebugRequestTable().isActive("representation:Image") || durations[i] > 500))
+          TRACE("TIMING: providing %s took %d ms at %d s after start",
+                step.provider->representation.c_str(), durations[i], frameStart / 1000 - 10);
+      }
 #endif
-    }
+  }
   BH_TRACE;
+  frameBudget.duration = SystemCall::getTimeSince(frameStart);
+  lastFrameBudget = frameBudget; // the FrameBudgetProvider of the next frame only sees complete data
 
   DEBUG_RESPONSE_ONCE("automated requests:ModuleTable",
   {
@@ -415,6 +818,513 @@ void ModuleManager::execute()
   });
 }
 
+void ModuleManager::executeOnce()
+{
+  for(const Provider& provider : providers)
+    if(isExecuted(provider))
+    {
+      ModuleState& moduleState = *provider.moduleState;
+      if(!moduleState.instance)
+        moduleState.instance = moduleState.module->createNew();
+      provider.update(*moduleState.instance);
+    }
+}
+
+void ModuleManager::compilePlan()
+{
+  plan.clear();
+  for(const Provider& provider : providers)
+    if(isExecuted(provider))
+    {
+      ASSERT(provider.moduleState->instance);
+      // The durations measured are kept when modules are switched, so a new plan does not start without them.
+      float& averageDuration = averageDurations[std::string(provider.moduleState->module->name) + ":" + provider.representation];
+      plan.push_back(Step(provider.moduleState->instance, provider, averageDuration));
+    }
+  ASSERT(plan.size() == tasks.size());
+  durations.assign(plan.size(), -1);
+
+  // All representations were updated in executeOnce().
+  for(Task& task : tasks)
+  {
+    task.version = ++lastVersion;
+    task.lastRun = 0;
+  }
+  planned = true;
+}
+
+void ModuleManager::executePlan(Stage stage)
+{
+#ifdef TARGET_ROBOT
+  // Each step only takes a single time stamp. Its duration ends with the time stamp of the next one.
+  unsigned timeStamp = SystemCall::getCurrentSystemTime();
+#endif
+  for(size_t i = 0; i < plan.size(); ++i)
+  {
+    if(stage != allStages && tasks[i].stage != stage)
+      continue;
+    else if(!tasks[i].demanded || isUpToDate(int(i)) || (frameBudget.budget && skip(int(i))))
+    {
+#ifdef TARGET_ROBOT
+      durations[i] = -1;
+      timeStamp = SystemCall::getCurrentSystemTime();
+#endif
+      continue;
+    }
+    updateVersion(int(i), update(int(i)));
+#ifdef TARGET_ROBOT
+    const unsigned now = SystemCall::getCurrentSystemTime();
+    durations[i] = int(now - timeStamp);
+    timeStamp = now;
+#endif
+  }
+}
+
+void ModuleManager::estimateRemaining(Stage stage)
+{
+  remaining = 0.f;
+  if(frameBudget.budget)
+    for(size_t i = 0; i < plan.size(); ++i)
+      if(!plan[i].expectedCost && tasks[i].demanded && (stage == allStages || tasks[i].stage == stage))
+        remaining += *plan[i].averageDuration;
+}
+
+bool ModuleManager::skip(int index)
+{
+  const Step& step = plan[index];
+  if(step.expectedCost && float(SystemCall::getTimeSince(frameStart)) + step.expectedCost + remaining > float(frameBudget.budget))
+  {
+    // Skipped providers appear with a time of 0 in the timing data.
+    TimingManager& tm = Global::getTimingManager();
+    tm.startTiming(step.provider->name);
+    tm.stopTiming(step.provider->name);
+    frameBudget.skipped.push_back(step.provider->representation);
+    return true;
+  }
+  else if(!step.expectedCost)
+    remaining -= *step.averageDuration;
+  return false;
+}
+
+bool ModuleManager::run(int index)
+{
+#ifdef TARGET_ROBOT
+  const unsigned timeStamp = SystemCall::getCurrentSystemTime();
+  const bool changed = update(index);
+  durations[index] = SystemCall::getTimeSince(timeStamp);
+  return changed;
+#else
+  return update(index);
+#endif
+}
+
+bool ModuleManager::update(int index)
+{
+#ifdef NDEBUG
+  return plan[index].update(*plan[index].instance);
+#else
+  // The representations a concurrent task reads cannot be updated while it runs,
+  // because their providers are its predecessors or successors in the graph.
+  // So they only change if a concurrent task writes to them.
+  std::vector<unsigned> checksums;
+  for(int input : tasks[index].readOnly)
+    checksums.push_back(getChecksum(input));
+
+  const bool changed = plan[index].update(*plan[index].instance);
+
+  for(size_t i = 0; i < checksums.size(); ++i)
+    if(getChecksum(tasks[index].readOnly[i]) != checksums[i])
+    {
+      OUTPUT_ERROR(tasks[tasks[index].readOnly[i]].provider->representation << " was changed while "
+                   << plan[index].provider->moduleState->module->name << " provided "
+                   << plan[index].provider->representation << ", but it may only read it");
+      ASSERT(false);
+    }
+  return changed;
+#endif
+}
+
+#ifndef NDEBUG
+unsigned ModuleManager::getChecksum(int index) const
+{
+  unsigned checksum = 2166136261u;
+  OutBinaryChecksum stream(checksum);
+  tasks[index].provider->out(stream);
+  return checksum;
+}
+#endif
+
+bool ModuleManager::isUpToDate(int index)
+{
+  const Task& task = tasks[index];
+  if(!memoize || !task.pure || task.sharedInput)
+    return false;
+  for(int input : task.inputs)
+    if(tasks[input].version > task.lastRun)
+      return false;
+  if(frameBudget.budget && !plan[index].expectedCost)
+    remaining -= *plan[index].averageDuration;
+  return true;
+}
+
+void ModuleManager::updateVersion(int index, bool changed)
+{
+  // Inputs executed later in this frame will get versions greater than "lastRun".
+  Task& task = tasks[index];
+  task.lastRun = lastVersion;
+  if(changed || modifying)
+    task.version = ++lastVersion;
+}
+
+void ModuleManager::determineDemand()
+{
+  const DebugRequestTable& debugRequestTable = Global::getDebugRequestTable();
+  const bool all = debugRequestTable.poll || modifying;
+  std::vector<int>& demanded = processQueue; // not used before executing the tasks
+  demanded.clear();
+  for(int i = 0; i < (int) tasks.size(); ++i)
+  {
+    Task& task = tasks[i];
+    task.demanded = !task.lazy || all || debugRequestTable.isActive(task.request.c_str());
+    if(task.demanded)
+      demanded.push_back(i);
+  }
+
+  // Everything a demanded task reads is demanded as well. A lazy task is only skipped
+  // if none of the representations of its module is demanded.
+  for(size_t next = 0; next < demanded.size(); ++next)
+  {
+    const Task& task = tasks[demanded[next]];
+    for(const std::vector<int>* indices : {&task.inputs, &task.siblings})
+      for(int index : *indices)
+        if(!tasks[index].demanded)
+        {
+          tasks[index].demanded = true;
+          demanded.push_back(index);
+        }
+  }
+
+  for(const Task& task : tasks)
+    if(!task.demanded)
+      frameBudget.notDemanded.push_back(task.provider->representation);
+}
+
+bool ModuleManager::isDebugging() const
+{
+  const DebugRequestTable& debugRequestTable = Global::getDebugRequestTable();
+  return debugRequestTable.poll || debugRequestTable.currentNumberOfDebugRequests || modifying;
+}
+
+bool ModuleManager::canExecuteInParallel() const
+{
+  return parameters.numOfWorkers && concurrentTasks && !isDebugging();
+}
+
+void ModuleManager::executeInParallel()
+{
+  for(Task& task : tasks)
+    task.waitingFor = task.numOfPredecessors;
+  while(executors.size() < parameters.numOfWorkers)
+    executors.push_back(new Executor);
+
+  processQueue.clear();
+  workerQueue.clear();
+  processNext = workerNext = numOfFinished = 0;
+  finished = false;
+  performanceCounters = Global::getTimingManager().hasPerformanceCounters();
+  for(int i = 0; i < (int) tasks.size(); ++i)
+    if(!tasks[i].numOfPredecessors)
+      push(i);
+
+  for(Executor* executor : executors)
+  {
+    executor->settings = Global::theSettings;
+    executor->blackboard = Blackboard::theInstance;
+    executor->worker.start([this, executor] {runWorker(*executor);});
+  }
+
+  // The process executes its own tasks first. If there are none, it helps the worker threads.
+  for(;;)
+  {
+    int index = -1;
+    bool skipped = false;
+    {
+      SYNC;
+      if(numOfFinished == tasks.size())
+        break;
+      else if(processNext < processQueue.size())
+        index = processQueue[processNext++];
+      else if(workerNext < workerQueue.size())
+        index = workerQueue[workerNext++];
+      if(index >= 0)
+        skipped = !tasks[index].demanded || isUpToDate(index) || (frameBudget.budget && skip(index));
+    }
+    if(index < 0)
+      processSignal.wait();
+    else if(skipped)
+    {
+      durations[index] = -1;
+      finish(index, false, false);
+    }
+    else
+      finish(index, true, run(index));
+  }
+
+  {
+    SYNC;
+    finished = true;
+  }
+  for(size_t i = 0; i < executors.size(); ++i)
+    workerSignal.post();
+  for(Executor* executor : executors)
+    executor->worker.wait();
+
+  // Remove the signals of tasks the process executed itself.
+  while(workerSignal.tryWait())
+    ;
+  while(processSignal.tryWait())
+    ;
+
+  for(Executor* executor : executors)
+    collect(*executor);
+}
+
+void ModuleManager::collect(Executor& executor)
+{
+  MessageForwarder debugForwarder(Global::getDebugOut());
+  executor.debugOut.handleAllMessages(debugForwarder);
+  executor.debugOut.clear();
+  if(Global::theTeamOut)
+  {
+    MessageForwarder teamForwarder(Global::getTeamOut());
+    executor.teamOut.handleAllMessages(teamForwarder);
+  }
+  executor.teamOut.clear();
+  Global::getTimingManager().takeTimes(executor.timingManager);
+}
+
+void ModuleManager::runWorker(Executor& executor)
+{
+  if(!executor.traceInitialized)
+  {
+    BH_TRACE_INIT("ModuleWorker");
+    executor.traceInitialized = true;
+  }
+  executor.setGlobals();
+  executor.timingManager.setPerformanceCounters(performanceCounters);
+
+  for(;;)
+  {
+    workerSignal.wait();
+    int index = -1;
+    bool skipped = false;
+    {
+      SYNC;
+      if(workerNext < workerQueue.size())
+      {
+        index = workerQueue[workerNext++];
+        skipped = !tasks[index].demanded || isUpToDate(index) || (frameBudget.budget && skip(index));
+      }
+      else if(finished)
+        break;
+    }
+    if(index >= 0)
+    {
+      if(skipped)
+      {
+        durations[index] = -1;
+        finish(index, false, false);
+      }
+      else
+        finish(index, true, run(index));
+      processSignal.post();
+    }
+  }
+}
+
+bool ModuleManager::canExecuteInPipelines() const
+{
+  return pipelineTasks && !isDebugging();
+}
+
+void ModuleManager::executeInPipelines()
+{
+  while(pipelines.size() < CameraInfo::numOfCameras)
+    pipelines.push_back(new Pipeline);
+  durations.assign(plan.size(), -1);
+
+  estimateRemaining(beforePipeline);
+  executePlan(beforePipeline);
+
+  // If a camera delivers two images in a row, e.g. because the other one failed,
+  // its previous image is finished alone. This copies its results back, which
+  // would replace the inputs of the new image, so they are kept meanwhile.
+  Pipeline& pipeline = *pipelines[Blackboard::theInstance->theCameraInfo.camera];
+  if(pending == &pipeline)
+  {
+    OutBinarySize size;
+    for(const Shared& input : pipelineInputs)
+      input.out(size);
+    std::vector<char> inputs(size.getSize());
+    OutBinaryMemory out(inputs.data());
+    for(const Shared& input : pipelineInputs)
+      input.out(out);
+    finishPendingImage(imageFinished);
+    InBinaryMemory in(inputs.data(), inputs.size());
+    for(const Shared& input : pipelineInputs)
+      input.in(in);
+  }
+
+  OutBinarySize size;
+  for(const Shared& input : pipelineInputs)
+    input.out(size);
+  pipeline.inputs.resize(size.getSize());
+  OutBinaryMemory stream(pipeline.inputs.data());
+  for(const Shared& input : pipelineInputs)
+    input.out(stream);
+
+  pipeline.demanded.resize(tasks.size());
+  for(size_t i = 0; i < tasks.size(); ++i)
+    pipeline.demanded[i] = tasks[i].demanded;
+  pipeline.performanceCounters = Global::getTimingManager().hasPerformanceCounters();
+  pipeline.executor.settings = Global::theSettings;
+  if(lastFinished == &pipeline)
+    lastFinished = 0;
+  pipeline.running = true;
+  pipeline.executor.worker.start([this, &pipeline] {runPipeline(pipeline);});
+
+  if(pending)
+  {
+    // Both images are finished in the sequence they were taken.
+    Pipeline& other = *pending;
+    pending = 0;
+    finishImage(other);
+    finishImage(pipeline);
+  }
+  else
+    pending = &pipeline;
+}
+
+void ModuleManager::runPipeline(Pipeline& pipeline)
+{
+  Executor& executor = pipeline.executor;
+  if(!executor.traceInitialized)
+  {
+    BH_TRACE_INIT("CameraPipeline");
+    executor.traceInitialized = true;
+  }
+  executor.setGlobals();
+  executor.timingManager.setPerformanceCounters(pipeline.performanceCounters);
+
+  if(!pipeline.created)
+  {
+    for(const Shared& representation : pipelineRepresentations)
+      representation.create();
+    pipeline.created = true;
+  }
+
+  InBinaryMemory in(pipeline.inputs.data(), pipeline.inputs.size());
+  for(const Shared& input : pipelineInputs)
+    input.in(in);
+
+  // Memoization and the time budget only apply to the process.
+  for(size_t i = 0; i < tasks.size(); ++i)
+    if(tasks[i].stage == inPipeline && pipeline.demanded[i])
+    {
+      const Provider& provider = *tasks[i].provider;
+      Blackboard*& instance = pipeline.instances[provider.moduleState];
+      if(!instance) // the constructors of many modules already access their requirements
+        instance = provider.moduleState->module->createNew();
+      provider.update(*instance);
+    }
+
+  OutBinarySize size;
+  for(const Shared& output : pipelineOutputs)
+    output.out(size);
+  pipeline.outputs.resize(size.getSize());
+  OutBinaryMemory out(pipeline.outputs.data());
+  for(const Shared& output : pipelineOutputs)
+    output.out(out);
+}
+
+void ModuleManager::finishImage(Pipeline& pipeline)
+{
+  pipeline.executor.worker.wait();
+  pipeline.running = false;
+
+  InBinaryMemory stream(pipeline.outputs.data(), pipeline.outputs.size());
+  for(const Shared& output : pipelineOutputs)
+    output.in(stream);
+  for(Task& task : tasks)
+    if(task.stage != afterPipeline &&
+       std::find(pipelineOutputs.begin(), pipelineOutputs.end(), task.provider->representation) != pipelineOutputs.end())
+      task.version = ++lastVersion;
+  collect(pipeline.executor);
+  lastFinished = &pipeline;
+
+  estimateRemaining(afterPipeline);
+  executePlan(afterPipeline);
+  if(imageFinished)
+    imageFinished();
+}
+
+void ModuleManager::finishPendingImage(const std::function<void()>& imageFinished)
+{
+  if(pending)
+  {
+    this->imageFinished = imageFinished;
+    Pipeline& pipeline = *pending;
+    pending = 0;
+    finishImage(pipeline);
+  }
+}
+
+void ModuleManager::destroyPipelines()
+{
+  for(Pipeline* pipeline : pipelines)
+  {
+    if(pipeline->running)
+      pipeline->executor.worker.wait();
+
+    // The modules and representations are deleted by the thread that created them.
+    pipeline->executor.worker.start([this, pipeline]
+    {
+      pipeline->executor.setGlobals();
+      for(auto& instance : pipeline->instances)
+        delete instance.second;
+      if(pipeline->created)
+        for(const Shared& representation : pipelineRepresentations)
+          representation.free();
+    });
+    pipeline->executor.worker.wait();
+    delete pipeline;
+  }
+  pipelines.clear();
+  pending = lastFinished = 0;
+}
+
+void ModuleManager::push(int index)
+{
+  if(tasks[index].concurrent)
+  {
+    workerQueue.push_back(index);
+    workerSignal.post();
+  }
+  else
+    processQueue.push_back(index);
+}
+
+void ModuleManager::finish(int index, bool executed, bool changed)
+{
+  SYNC;
+  if(executed)
+    updateVersion(index, changed);
+  for(int successor : tasks[index].successors)
+    if(!--tasks[successor].waitingFor)
+      push(successor);
+  ++numOfFinished;
+}
+
 void ModuleManager::readPackage(In& stream)
 {
   unsigned timeStamp;
@@ -447,3 +1357,64 @@ std::vector<std::string> ModuleManager::getCurrentRepresentatioNames() const
   }
   return data;
 }
+
+std::vector<std::pair<std::string, std::string> > ModuleManager::getCurrentProviders() const
+{
+  std::vector<std::pair<std::string, std::string> > data;
+  for(const Provider& provider : providers)
+    if(provider.moduleState->required)
+      data.push_back(std::pair<std::string, std::string>(provider.representation, provider.moduleState->module->name));
+  return data;
+}
+
+bool ModuleManager::writeRepresentation(const std::string& representation, Out& stream) const
+{
+  std::list<Provider>::const_iterator i = std::find(providers.begin(), providers.end(), representation);
+  if(i == providers.end() || !i->out)
+    return false;
+
+  // Results of the pipelines are only copied back if the process reads them.
+  Blackboard* blackboard = Blackboard::theInstance;
+  if(lastFinished)
+    for(const Task& task : tasks)
+      if(task.provider == &*i && task.stage == inPipeline)
+        Blackboard::theInstance = lastFinished->executor.blackboard;
+  i->out(stream);
+  Blackboard::theInstance = blackboard;
+  return true;
+}
+
+const char* ModuleManager::getCategory(const std::string& module)
+{
+  for(ModuleBase* i = ModuleBase::first; i; i = i->next)
+    if(module == i->name)
+      return i->category;
+  return 0;
+}
+
+bool ModuleManager::provides(const std::string& module, const std::string& representation)
+{
+  for(ModuleBase* i = ModuleBase::first; i; i = i->next)
+    if(module == i->name)
+      return std::find(i->representations.begin(), i->representations.end(), representation) != i->representations.end();
+  return false;
+}
+
+std::vector<std::string> ModuleManager::getRequirements(const std::string& module)
+{
+  std::vector<std::string> data;
+  for(ModuleBase* i = ModuleBase::first; i; i = i->next)
+    if(module == i->name)
+    {
+      for(const auto& requirement : i->requirements)
+        data.push_back(requirement.name);
+      break;
+    }
+  return data;
+}
+
+const FrameBudget& ModuleManager::getFrameBudget()
+{
+  static FrameBudget none;
+  return theInstance ? theInstance->lastFrameBudget : none;
+}
@@ -7,7 +7,11 @@
 #pragma once
 
 #include "Module.h"
+#include "Platform/Semaphore.h"
+#include "Platform/Thread.h"
+#include "Representations/Infrastructure/FrameBudget.h"
 #include "Tools/Streams/AutoStreamable.h"
+#include <functional>
 #include <map>
 #include <vector>
 #include <string>
@@ -21,6 +25,18 @@ class DefaultModule;
 class ModuleManager
 {
 private:
+  /**
+   * The stages of a frame when the perception of both cameras is executed in
+   * camera pipelines.
+   */
+  enum Stage
+  {
+    beforePipeline, /**< Provides the inputs of the pipelines, e.g. the image. Executed by the process. */
+    inPipeline, /**< Executed by the pipeline of the camera that took the image. */
+    afterPipeline, /**< Reads the results of the pipelines. Executed by the process for each image finished. */
+    allStages /**< Selects all tasks. Not a stage of a task. */
+  };
+
   /**
    * The class represents the current state of a module.
    */
@@ -53,10 +69,12 @@ private:
   {
   public:
     std::string representation; /**< The representation that will be provided. */
+    const char* name; /**< The name of the representation as used by the stopwatch of its update handler. */
     ModuleState* moduleState; /**< The moduleState that will give access to the module that provides the information. */
-    void (*update)(Blackboard&); /**< The update handler within the module. */
+    bool (*update)(Blackboard&); /**< The update handler within the module. */
     void (*create)(); /**< The method to create a new instance of the representation. */
     void (*free)(); /**< The method to delete an instance of the representation. */
+    void (*out)(Out&); /**< The method to write the representation to a stream. */
 
     /**
      * Constructor.
@@ -65,14 +83,17 @@ private:
      * @param update The update handler within the module.
      * @param create The create handler for the representation.
      * @param free The free handler for the representation.
+     * @param out The write handler for the representation.
      */
-    Provider(const std::string& representation, ModuleState* moduleState,
-             void (*update)(Blackboard&), void (*create)(), void (*free)())
+    Provider(const char* representation, ModuleState* moduleState,
+             bool (*update)(Blackboard&), void (*create)(), void (*free)(), void (*out)(Out&))
     : representation(representation),
+      name(representation),
       moduleState(moduleState),
       update(update),
       create(create),
-      free(free) {}
+      free(free),
+      out(out) {}
 
     /**
      * Comparison operator. Only uses the representation for comparison.
@@ -89,6 +110,91 @@ private:
     bool operator==(const std::string& representation) const {return this->representation == representation;}
   };
 
+  /**
+   * The class represents a provider as a node of the dependency graph that is used
+   * to execute providers in parallel.
+   */
+  class Task
+  {
+  public:
+    Provider* provider; /**< The provider executed. */
+    bool concurrent; /**< Can the provider be executed by a worker thread? */
+    std::vector<int> successors; /**< The indices of the tasks that must wait for this one. */
+    int numOfPredecessors; /**< The number of tasks this one must wait for. */
+    int waitingFor; /**< The number of predecessors that are not finished yet in the current frame. */
+    bool lazy; /**< Is the provider only executed if its representation is demanded? */
+    bool demanded; /**< Is the representation demanded in the current frame? */
+    bool pure; /**< Does the provider only depend on the representations it reads? */
+    bool sharedInput; /**< Does the provider read a representation received from another process? */
+    Stage stage; /**< When is the provider executed if camera pipelines are used? */
+    unsigned long long version; /**< The version of the representation, i.e. the value of "lastVersion" when it was changed last. */
+    unsigned long long lastRun; /**< The value of "lastVersion" when the provider was executed last. */
+    std::vector<int> inputs; /**< The indices of the tasks that update a representation this one reads. Only filled if there are lazy or pure tasks. */
+    std::vector<int> siblings; /**< The indices of the other tasks of the same module. Only filled if there are lazy tasks. */
+    std::string request; /**< The debug request that sends the representation. Only set for lazy tasks. */
+#ifndef NDEBUG
+    std::vector<int> readOnly; /**< The indices of the tasks that update a representation this one reads. Only filled for concurrent tasks. */
+#endif
+
+    /**
+     * Constructor.
+     * @param provider The provider executed.
+     * @param concurrent Can the provider be executed by a worker thread?
+     */
+    Task(Provider* provider, bool concurrent)
+    : provider(provider),
+      concurrent(concurrent),
+      numOfPredecessors(0),
+      waitingFor(0),
+      lazy(false),
+      demanded(true),
+      pure(false),
+      sharedInput(false),
+      stage(afterPipeline),
+      version(0),
+      lastRun(0) {}
+  };
+
+  /**
+   * The class represents a step of the execution plan, i.e. a provider that is
+   * ready to be called.
+   */
+  class Step
+  {
+  public:
+    Blackboard* instance; /**< The instance of the module. */
+    bool (*update)(Blackboard&); /**< The update handler within the module. */
+    float expectedCost; /**< The time in ms an optional module is expected to take. 0 if it is not optional. */
+    float* averageDuration; /**< The smoothed time in ms the update handler took so far (only measured on the robot). Kept in "averageDurations". */
+    const Provider* provider; /**< The provider this step calls. */
+
+    /**
+     * Constructor.
+     * @param instance The instance of the module.
+     * @param provider The provider this step calls.
+     * @param averageDuration The smoothed time the provider took in previous plans.
+     */
+    Step(Blackboard* instance, const Provider& provider, float& averageDuration)
+    : instance(instance),
+      update(provider.update),
+      expectedCost(provider.moduleState->module->expectedCost),
+      averageDuration(&averageDuration),
+      provider(&provider) {}
+  };
+
+  class Executor; /**< A worker thread together with the debugging environment of the providers it executes. */
+  class Pipeline; /**< The blackboard and the thread that execute the perception of one camera. */
+
+  /**
+   * The parameters of the module manager.
+   */
+  STREAMABLE(Parameters,
+  {,
+    (unsigned)(0) numOfWorkers, /**< The number of worker threads that execute concurrent providers. 0 executes all providers sequentially. */
+    (std::vector<std::string>) lazyRepresentations, /**< The representations that are only updated if a provider executed or a debug request reads them. */
+    (bool)(false) cameraPipelines, /**< Execute the providers of the category "Perception" in a thread and on a blackboard of each camera, so that the images of both cameras are processed in parallel. */
+  });
+
   std::list<Provider> providers; /**< The list of providers that will be executed. */
   std::map<const char*, const char*> selected; /**< The providers selected. This is always the last configuration set. It may not work. */
 
@@ -153,6 +259,42 @@ private:
   unsigned timeStamp; /**< The timeStamp of the last module request. Communication is only possible if both sides use the same timestamp. */
   DefaultModule* defaultModule; /**< A module that can provide everything. */
   DefaultModule* otherDefaultModule; /**< The default module of other processes. */
+  FrameBudget frameBudget; /**< The time budget of the current frame and the providers skipped so far. */
+  FrameBudget lastFrameBudget; /**< A copy of frameBudget taken when the last frame was finished. */
+  unsigned frameStart; /**< The time when the execution of the current frame started. */
+  float remaining; /**< The time the mandatory providers not executed yet in the current frame are expected to take. */
+  Parameters parameters; /**< The parameters of the module manager. */
+  std::vector<Step> plan; /**< The providers that update a representation in the sequence of "providers". Empty until "planned". */
+  std::vector<int> durations; /**< The time in ms each step of the plan took in the current frame. -1 if it was skipped. Only measured on the robot. */
+  std::map<std::string, float> averageDurations; /**< The smoothed durations of all providers ever planned, indexed by "<module>:<representation>". Survive new plans. */
+  bool planned; /**< Was the plan compiled for the current configuration? */
+  std::vector<Task> tasks; /**< The dependency graph of the steps of the plan. It has the same indices as the plan. */
+  bool concurrentTasks; /**< Is any of the tasks allowed to be executed by a worker thread? */
+  bool lazyTasks; /**< Is any of the tasks only executed if its representation is demanded? */
+  bool pureTasks; /**< Is any of the tasks only executed if a representation it reads changed? */
+  bool memoize; /**< Are pure tasks skipped in the current frame if their inputs did not change? */
+  bool modifying; /**< Is data modified through RobotControl in the current frame? Then all representations executed get new versions. */
+  unsigned long long lastVersion; /**< The last version assigned to a representation. */
+  bool pipelineTasks; /**< Can the tasks be split into the stages of camera pipelines? */
+  std::vector<Shared> pipelineRepresentations; /**< The representations on the blackboards of the pipelines, i.e. the ones their tasks read or provide. */
+  std::vector<Shared> pipelineInputs; /**< The representations copied to a pipeline when it starts an image, i.e. the ones its tasks read, but do not provide, and the ones their providers read themselves. */
+  std::vector<Shared> pipelineOutputs; /**< The representations copied back when an image is finished, i.e. the ones the tasks after the pipelines read, and the ones their providers read themselves. */
+  std::vector<Pipeline*> pipelines; /**< The pipelines of all cameras. They are created when they are needed the first time. */
+  Pipeline* pending; /**< The pipeline executing the image of the current frame if it is finished together with the image of the other camera. 0 if there is none. */
+  Pipeline* lastFinished; /**< The pipeline that finished the last image if it did not start another one. Its results can still be read. */
+  std::function<void()> imageFinished; /**< Is called whenever the providers were executed for an image. */
+  std::vector<Executor*> executors; /**< The worker threads. They are created when they are needed the first time. */
+  std::vector<int> processQueue; /**< The indices of the tasks ready that must be executed by the process itself. */
+  std::vector<int> workerQueue; /**< The indices of the tasks ready that can be executed by any thread. */
+  size_t processNext; /**< The index of the next entry in "processQueue" that will be executed. */
+  size_t workerNext; /**< The index of the next entry in "workerQueue" that will be executed. */
+  size_t numOfFinished; /**< The number of tasks finished in the current frame. */
+  bool finished; /**< Were all tasks of the current frame finished? Tells the worker threads to stop waiting for tasks. */
+  bool performanceCounters; /**< Does the process measure the hardware performance counters? Then the worker threads measure them as well. */
+  Semaphore processSignal; /**< Is posted when a worker thread finished a task. */
+  Semaphore workerSignal; /**< Is posted when a task was added to "workerQueue" and when all tasks were finished. */
+  DECLARE_SYNC; /**< Protects the queues and the task counters while executing in parallel. */
+  static PROCESS_WIDE_STORAGE(ModuleManager) theInstance; /**< The module manager that executed modules last in this process. */
 
   /**
    * Adds all representations that need to be shared between processes to the
@@ -188,6 +330,224 @@ private:
    */
   void rollBack(const std::list<Provider>& providers, const std::list<Shared>& shared);
 
+  /**
+   * The method determines whether a module reads a representation, i.e. whether it
+   * requires or uses it.
+   * @param moduleState The module.
+   * @param representation The name of the representation.
+   * @return Does the module read the representation?
+   */
+  static bool reads(const ModuleState& moduleState, const std::string& representation);
+
+  /**
+   * The method determines whether a provider is executed, i.e. whether it is part of
+   * the plan. The default module is not, because it does nothing.
+   * @param provider The provider.
+   * @return Does the provider update its representation?
+   */
+  bool isExecuted(const Provider& provider) const;
+
+  /**
+   * The method executes all providers once in the sequence given and creates their
+   * modules when they are executed. This is done in the first frame after the
+   * configuration changed, because the constructors of many modules already access
+   * their requirements. Optional modules are not skipped in this frame.
+   */
+  void executeOnce();
+
+  /**
+   * The method compiles the plan. All modules must have been created before.
+   */
+  void compilePlan();
+
+  /**
+   * The method executes the plan sequentially.
+   * @param stage Only the steps of this stage are executed. All steps are executed if it is "allStages".
+   */
+  void executePlan(Stage stage = allStages);
+
+  /**
+   * The method builds the dependency graph of the providers. A provider depends on
+   * all providers executed before it in the sequential order that update a
+   * representation it reads, that read the representation it updates, or that
+   * belong to the same module. Therefore, executing the graph in parallel produces
+   * the same results as executing the providers sequentially.
+   */
+  void buildGraph();
+
+  /**
+   * The method determines which lazy tasks are executed in the current frame.
+   * A lazy task is demanded if a debug request sends its representation or if a
+   * demanded task reads it. All other tasks are always demanded. Everything is
+   * demanded while data is modified through RobotControl or debug requests are
+   * polled. The representations of lazy tasks that are not demanded are added
+   * to the list "notDemanded" of the frame budget.
+   */
+  void determineDemand();
+
+  /**
+   * The method assigns the tasks to the stages of the camera pipelines if they are
+   * configured. The tasks of modules of the category "Perception" are executed in
+   * the pipelines, and so are all tasks that are executed between two of them.
+   * The ones the pipelines depend on are executed before them, all others after.
+   * The method also determines the representations that must be copied between the
+   * blackboard of the process and the ones of the pipelines. A provider that continues
+   * its previous result must declare this by reading its own representation. In the
+   * pipelines, it then continues the latest result of the process, which may be the
+   * one of the other camera.
+   */
+  void assignStages();
+
+  /**
+   * The method searches the handlers of a representation in all modules.
+   * @param shared The handlers found are added to this representation.
+   * @return Were all handlers found?
+   */
+  static bool findHandlers(Shared& shared);
+
+  /**
+   * The method determines whether debug requests are active or data is modified
+   * through RobotControl in the current frame.
+   * @return Is the process being debugged?
+   */
+  bool isDebugging() const;
+
+  /**
+   * The method determines whether the providers can be executed in parallel in the
+   * current frame. The debugging environment of the process is only available to
+   * the process itself. Therefore, all providers are executed sequentially while
+   * the process is being debugged.
+   * @return Can the current frame be executed in parallel?
+   */
+  bool canExecuteInParallel() const;
+
+  /**
+   * The method executes all tasks using the process and the worker threads.
+   */
+  void executeInParallel();
+
+  /**
+   * The method determines whether the current frame can be executed in the camera
+   * pipelines. As the worker threads, they do not support debugging.
+   * @return Can the pipelines be used?
+   */
+  bool canExecuteInPipelines() const;
+
+  /**
+   * The method executes the current frame in the camera pipelines. The tasks before
+   * them are executed and the image is passed to the pipeline of its camera. If the
+   * image of the other camera is still being processed, both are finished in the
+   * sequence they were taken. Otherwise, the current image remains pending until the
+   * next frame.
+   */
+  void executeInPipelines();
+
+  /**
+   * The main method of a pipeline for each image. It reads its inputs, executes the
+   * tasks of the pipeline, and writes the results the process needs.
+   * @param pipeline The pipeline.
+   */
+  void runPipeline(Pipeline& pipeline);
+
+  /**
+   * The method waits for a pipeline, copies its results to the blackboard of the
+   * process, and executes the tasks after the pipelines for its image.
+   * @param pipeline The pipeline.
+   */
+  void finishImage(Pipeline& pipeline);
+
+  /**
+   * The method destroys all pipelines. An image pending is dropped.
+   */
+  void destroyPipelines();
+
+  /**
+   * The method passes the debug messages, team messages, and times of a thread to the process.
+   * @param executor The debugging environment of the thread.
+   */
+  void collect(Executor& executor);
+
+  /**
+   * The main method of a worker thread in each frame. It executes concurrent tasks
+   * until all tasks of the frame are finished.
+   * @param executor The worker thread.
+   */
+  void runWorker(Executor& executor);
+
+  /**
+   * The method adds a task to the queue of tasks ready.
+   * The caller must hold the lock.
+   * @param index The index of the task.
+   */
+  void push(int index);
+
+  /**
+   * The method marks a task as finished. Successors that do not wait for any other
+   * tasks anymore are added to the queues.
+   * @param index The index of the task.
+   * @param executed Was the task executed or was it skipped?
+   * @param changed Did the task change its representation?
+   */
+  void finish(int index, bool executed, bool changed);
+
+  /**
+   * The method determines whether a pure step is skipped, because none of the
+   * representations it reads got a new version since it was executed last.
+   * The caller must hold the lock while executing in parallel.
+   * @param index The index of the step in the plan.
+   * @return Is the step skipped?
+   */
+  bool isUpToDate(int index);
+
+  /**
+   * The method updates the versions of a task that was executed.
+   * The caller must hold the lock while executing in parallel.
+   * @param index The index of the task.
+   * @param changed Did the task change its representation?
+   */
+  void updateVersion(int index, bool changed);
+
+  /**
+   * The method sets "remaining" to the time the mandatory steps of a stage that are
+   * demanded are expected to take. It is 0 if there is no budget.
+   * @param stage The stage. All steps are considered if it is "allStages".
+   */
+  void estimateRemaining(Stage stage);
+
+  /**
+   * The method determines whether a step is skipped because its module is optional
+   * and executing it would exceed the time budget of the current frame.
+   * It must only be called if there is a budget and the step is demanded.
+   * @param index The index of the step in the plan.
+   * @return Is the step skipped?
+   */
+  bool skip(int index);
+
+  /**
+   * The method executes a step and measures the time it took.
+   * @param index The index of the step in the plan.
+   * @return Did the step change its representation?
+   */
+  bool run(int index);
+
+  /**
+   * The method executes a step. In debug builds, it also checks that a concurrent
+   * step did not change the representations it only reads. If worker threads are
+   * used, the step that changed them may also be one executed at the same time.
+   * @param index The index of the step in the plan.
+   * @return Did the step change its representation?
+   */
+  bool update(int index);
+
+#ifndef NDEBUG
+  /**
+   * The method computes a checksum over the representation of a task.
+   * @param index The index of the task.
+   * @return The checksum of its representation in its current state.
+   */
+  unsigned getChecksum(int index) const;
+#endif
+
 public:
   /**
    * Constructor used when framework processes are mapped to threads.
@@ -206,9 +566,20 @@ public:
 
   /**
    * The method loads the selection of solutions from a configuration file.
+   * It also loads the number of worker threads, the lazy representations, and whether
+   * camera pipelines are used from "moduleManager.cfg" if it exists.
    */
   void load();
 
+  /**
+   * The method overrides the number of worker threads loaded from "moduleManager.cfg".
+   * Note that the worker threads share the processor with the other processes and with
+   * threads started by modules, e.g. the FieldBoundaryProvider. On the Nao, which has
+   * two hardware threads, more than one worker oversubscribes the processor.
+   * @param numOfWorkers The number of worker threads. 0 executes all providers sequentially.
+   */
+  void setNumOfWorkers(unsigned numOfWorkers) {parameters.numOfWorkers = numOfWorkers;}
+
   /**
    * The method destroys all modules. It can be called to destroy the modules
    * before the constructor is called.
@@ -224,8 +595,43 @@ public:
 
   /**
    * The method executes all selected modules.
+   * Optional modules are skipped if the time already spent in this frame, their
+   * expected cost, and the average time of all mandatory providers still to come
+   * exceed the budget. If worker threads are configured, modules created with
+   * MAKE_CONCURRENT_MODULE are executed in parallel to the other ones as far as the
+   * dependency graph permits. Providers of lazy representations are only executed
+   * if their representations are demanded in the current frame. Providers of pure
+   * modules are not executed if none of their inputs got a new version since they
+   * were executed last. If camera pipelines are configured, the providers of the category
+   * "Perception" are executed for the images of both cameras in parallel, each camera on
+   * its own blackboard. The image of one camera is then finished together with the one of
+   * the other camera in the next frame.
+   * @param budget The time available for this frame in ms. 0 if optional modules should never be skipped.
+   * @param imageFinished Is called whenever the providers were executed for an image, i.e. up to twice
+   *                      per frame if camera pipelines are used.
+   */
+  void execute(unsigned budget = 0, const std::function<void()>& imageFinished = std::function<void()>());
+
+  /**
+   * The method determines whether the image of the frame executed last is still being
+   * processed by a camera pipeline. In that case, the tasks after the pipelines were
+   * not executed for it yet, i.e. the blackboard does not contain its results.
+   * @return Is an image pending?
+   */
+  bool isImagePending() const {return pending != 0;}
+
+  /**
+   * The method finishes the image pending, e.g. at the end of a log file.
+   * @param imageFinished Is called when the providers were executed for the image.
+   */
+  void finishPendingImage(const std::function<void()>& imageFinished = std::function<void()>());
+
+  /**
+   * The method enables or disables the camera pipelines loaded from "moduleManager.cfg".
+   * It must be called before the module configuration is set.
+   * @param cameraPipelines Execute the perception of both cameras in parallel?
    */
-  void execute();
+  void setCameraPipelines(bool cameraPipelines) {parameters.cameraPipelines = cameraPipelines;}
 
   /**
    * The method reads a package from a stream.
@@ -248,6 +654,54 @@ public:
    */
   std::vector<std::string> getCurrentRepresentatioNames() const;
 
+  /**
+   * Returns the names of the representations provided in this process together
+   * with the names of the modules that provide them. The list is ordered by
+   * execution order.
+   * @return Pairs of representation names and module names.
+   */
+  std::vector<std::pair<std::string, std::string> > getCurrentProviders() const;
+
+  /**
+   * The method writes a representation that is provided in this process to a stream.
+   * A representation provided by a camera pipeline is written as the pipeline finished
+   * the last image, unless it already started the next one.
+   * @param representation The name of the representation.
+   * @param stream The stream the representation is written to.
+   * @return Is the representation provided in this process, i.e. was it written?
+   */
+  bool writeRepresentation(const std::string& representation, Out& stream) const;
+
+  /**
+   * The method returns the category of a module.
+   * @param module The name of the module.
+   * @return The category or 0 if the module is unknown.
+   */
+  static const char* getCategory(const std::string& module);
+
+  /**
+   * The method determines whether a module is able to provide a representation.
+   * @param module The name of the module.
+   * @param representation The name of the representation.
+   * @return Is the module able to provide the representation?
+   */
+  static bool provides(const std::string& module, const std::string& representation);
+
+  /**
+   * The method returns the names of the representations a module requires.
+   * @param module The name of the module.
+   * @return The names of the requirements. The list is empty if the module is unknown.
+   */
+  static std::vector<std::string> getRequirements(const std::string& module);
+
+  /**
+   * The method returns the time budget of the frame executed last in this process
+   * and the providers skipped in that frame, either because of the budget or
+   * because their lazy representations were not demanded.
+   * @return The frame budget. Its budget is 0 if no modules were executed yet.
+   */
+  static const FrameBudget& getFrameBudget();
+
   friend class DefaultModule; /**< Allowed to access local class ModuleState. */
 };
 
@@ -0,0 +1,143 @@
+/**
+ * @file PooledList.h
+ *
+ * Declaration of class PooledList, a doubly linked list that keeps its elements
+ * in a contiguous pool that is reused after the list was cleared.
+ */
+
+#pragma once
+
+#include "Platform/BHAssert.h"
+#include <vector>
+
+/**
+ * @class PooledList
+ *
+ * A doubly linked list with the elements stored in a contiguous pool. Elements are
+ * addressed by their index in the pool, which stays valid until the element is
+ * erased. Neither clearing the list nor erasing elements releases memory, so a list
+ * that is refilled every frame only allocates memory when more elements are needed
+ * than ever before. Elements are not destructed when they are erased, i.e. their
+ * members (e.g. vectors) keep their capacity when the slot is reused.
+ * Iterating over the list:
+ * for(int i = list.first(); i >= 0; i = list.next(i)) ... list[i] ...
+ */
+template <class T> class PooledList
+{
+private:
+  /** An element of the pool. */
+  class Node
+  {
+  public:
+    T value;
+    int prev; /**< The index of the previous element in the list or -1. */
+    int next; /**< The index of the next element in the list or in the list of free nodes or -1. */
+  };
+
+  std::vector<Node> nodes; /**< The pool. Never shrinks. */
+  int head; /**< The index of the first element or -1. */
+  int tail; /**< The index of the last element or -1. */
+  int firstFree; /**< The index of the first erased node that can be reused or -1. */
+  int used; /**< The number of nodes of the pool handed out since the last call to clear(). */
+  int count; /**< The number of elements in the list. */
+
+public:
+  /**
+   * Constructor.
+   * @param capacity The number of elements the pool is allocated for initially.
+   */
+  PooledList(int capacity = 0) {nodes.reserve(capacity); clear();}
+
+  /** Removes all elements from the list. The memory is kept. */
+  void clear() {head = tail = firstFree = -1; used = count = 0;}
+
+  int size() const {return count;}
+  bool empty() const {return !count;}
+
+  /** @return The index of the first element or -1 if the list is empty. */
+  int first() const {return head;}
+
+  /**
+   * @param i The index of an element.
+   * @return The index of the element following it or -1 if it was the last one.
+   */
+  int next(int i) const {return nodes[i].next;}
+
+  T& operator[](int i) {return nodes[i].value;}
+  const T& operator[](int i) const {return nodes[i].value;}
+
+  /**
+   * Appends an element. Its contents are the ones it had when its node was used
+   * the last time, i.e. it must be initialized by the caller.
+   * References to elements become invalid, indices stay valid.
+   * @return The index of the new element.
+   */
+  int push_back()
+  {
+    int i;
+    if(firstFree >= 0)
+    {
+      i = firstFree;
+      firstFree = nodes[i].next;
+    }
+    else
+    {
+      if(used == (int) nodes.size())
+        nodes.push_back(Node());
+      i = used++;
+    }
+    nodes[i].prev = tail;
+    nodes[i].next = -1;
+    if(tail >= 0)
+      nodes[tail].next = i;
+    else
+      head = i;
+    tail = i;
+    ++count;
+    return i;
+  }
+
+  /**
+   * Appends a copy of an element.
+   * @param value The element. It may be an element of this list.
+   * @return The index of the new element.
+   */
+  int push_back(const T& value)
+  {
+    if(firstFree < 0 && used == (int) nodes.size())
+    {
+      // Growing the pool would invalidate value if it is an element of this list.
+      const T copy(value);
+      const int i = push_back();
+      nodes[i].value = copy;
+      return i;
+    }
+    const int i = push_back();
+    nodes[i].value = value;
+    return i;
+  }
+
+  /**
+   * Removes an element. Its node will be reused by a following push_back().
+   * @param i The index of the element.
+   * @return The index of the element that followed it or -1.
+   */
+  int erase(int i)
+  {
+    ASSERT(count > 0);
+    Node& node = nodes[i];
+    const int next = node.next;
+    if(node.prev >= 0)
+      nodes[node.prev].next = next;
+    else
+      head = next;
+    if(next >= 0)
+      nodes[next].prev = node.prev;
+    else
+      tail = node.prev;
+    node.next = firstFree;
+    firstFree = i;
+    --count;
+    return next;
+  }
+};
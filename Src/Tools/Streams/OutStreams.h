@@ -647,6 +647,40 @@ protected:
   virtual void writeToStream(const void* p, int s) {size += s;}
 };
 
+/**
+* @class OutChecksum
+*
+* A PhysicalOutStream that does not store any data. Instead, it updates a
+* FNV-1a hash with all bytes written.
+*/
+class OutChecksum : public PhysicalOutStream
+{
+private:
+  unsigned* checksum; /**< The checksum that is updated. */
+
+public:
+  /** Default constructor */
+  OutChecksum() : checksum(0) {}
+
+  /**
+  * The method sets the checksum that is updated.
+  * @param checksum The checksum. It is updated, not reset.
+  */
+  void open(unsigned& checksum) {this->checksum = &checksum;}
+
+protected:
+  /**
+  * The function adds bytes to the checksum.
+  * @param p The address the data is located at.
+  * @param s The number of bytes to be written.
+  */
+  virtual void writeToStream(const void* p, int s)
+  {
+    for(const unsigned char* c = (const unsigned char*) p, * end = c + s; c < end; ++c)
+      *checksum = (*checksum ^ *c) * 16777619u;
+  }
+};
+
 /**
 * @class OutBinaryFile
 *
@@ -721,6 +755,28 @@ public:
   virtual bool isBinary() const {return true;}
 };
 
+/**
+* @class OutBinaryChecksum
+*
+* A binary stream that only computes a checksum over the data written.
+*/
+class OutBinaryChecksum : public OutStream<OutChecksum, OutBinary>
+{
+public:
+  /**
+  * Constructor.
+  * @param checksum The checksum that is updated. It should be initialized
+  *                 with the FNV-1a offset basis 2166136261.
+  */
+  OutBinaryChecksum(unsigned& checksum) {open(checksum);}
+
+  /**
+  * The function returns whether this is a binary stream.
+  * @return Does it output data in binary format?
+  */
+  virtual bool isBinary() const {return true;}
+};
+
 /**
 * @class OutTextFile
 *
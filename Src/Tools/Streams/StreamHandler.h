@@ -41,6 +41,7 @@ private:
   * only a process is allowed to create the instance.
   */
   friend class Process;
+  friend class ModuleManager;
 
   struct RegisteringAttributes
   {
@@ -0,0 +1,75 @@
+/**
+ * @file Worker.h
+ *
+ * Declaration of class Worker, a thread that executes tasks on request while
+ * the thread that requested them continues. It allows to split the work of a
+ * single module between both hardware threads of the robot's CPU.
+ */
+
+#pragma once
+
+#include "Platform/Thread.h"
+#include "Platform/Semaphore.h"
+#include "Platform/BHAssert.h"
+#include <functional>
+
+/**
+ * @class Worker
+ *
+ * A thread that waits for tasks. A task must not use anything that is accessed
+ * through class Global (debug output, drawings, stopwatches, ...), because these
+ * are only available in the threads of the processes.
+ */
+class Worker : private Thread<Worker>
+{
+private:
+  Semaphore requested; /**< Is posted when a new task was set. */
+  Semaphore finished; /**< Is posted when a task was executed. */
+  std::function<void()> task; /**< The task that is executed next. */
+  bool busy; /**< Was a task started that was not waited for yet? */
+
+  /** The main function of the thread. Executes the tasks requested. */
+  void main()
+  {
+    while(requested.wait() && isRunning())
+    {
+      task();
+      finished.post();
+    }
+  }
+
+public:
+  Worker() : busy(false)
+  {
+    Thread<Worker>::start(this, &Worker::main);
+  }
+
+  ~Worker()
+  {
+    ASSERT(!busy);
+    announceStop();
+    requested.post();
+    stop();
+  }
+
+  /**
+   * Starts a task in the worker thread.
+   * The calling thread must call wait() before starting the next task.
+   * @param task The task.
+   */
+  void start(const std::function<void()>& task)
+  {
+    ASSERT(!busy);
+    this->task = task;
+    busy = true;
+    requested.post();
+  }
+
+  /** Waits until the task started last was executed. */
+  void wait()
+  {
+    ASSERT(busy);
+    finished.wait();
+    busy = false;
+  }
+};
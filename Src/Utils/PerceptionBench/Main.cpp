@@ -0,0 +1,120 @@
+/**
+* @file Main.cpp
+* The command line interface of the PerceptionBench. It replays a log file
+* through the perception modules and prints the time each module took
+* (mean, 95th percentile, and maximum) as well as a checksum of each percept.
+* Stopwatches within the modules are listed separately.
+* The checksums allow to check whether an optimization changed the results.
+*
+* Usage: PerceptionBench [-n <frames>] [-r <representation>]... [-c <csv file>]
+*                        [-s <checksum file>] [-v <checksum file>] [-w <workers>] [-p] [-half]
+*                        [-d <debug request>]... <log file>
+*   -n  Measure at most this number of frames.
+*   -r  Always replay this representation from the log file, even if it is
+*       provided by a perception module. Can be given more than once.
+*   -c  Also measure the hardware performance counters of each module and write
+*       the statistics including their averages per frame to a CSV file.
+*   -s  Save the checksums of all percepts to a file.
+*   -v  Verify the checksums of all percepts against a file saved with -s,
+*       e.g. by a build before an optimization. Differences are listed and
+*       the bench exits with a failure.
+*   -w  Execute the concurrent modules with this number of worker threads.
+*       Comparing the checksums with -s and -v shows whether the results
+*       are the same as with the sequential execution.
+*   -p  Execute the perception modules for the images of both cameras in parallel
+*       in camera pipelines. The modules then have a state per camera. The time
+*       all frames took shows the gain. The pipelines are not used with -d.
+*   -half  Process the images of both cameras at half resolution, independent
+*          from the frame budget.
+*   -d  Activate this debug request in all frames, e.g.
+*       "module:ScanGridProvider:benchmark". Can be given more than once.
+*       The times of the stopwatches executed on request are listed, and
+*       their performance counters are written to the CSV file.
+*/
+
+#include "PerceptionBench.h"
+#include "Modules/Infrastructure/ProcessingResolutionProvider.h"
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+static int usage()
+{
+  fprintf(stderr, "Usage: PerceptionBench [-n <frames>] [-r <representation>]... [-c <csv file>]\n"
+                  "                       [-s <checksum file>] [-v <checksum file>] [-w <workers>] [-p] [-half]\n"
+                  "                       [-d <debug request>]... <log file>\n");
+  return EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+  int maxFrames = std::numeric_limits<int>::max();
+  std::set<std::string> replayed;
+  std::vector<std::string> debugRequests;
+  std::string fileName;
+  std::string csvFileName;
+  std::string savedFileName;
+  std::string verifiedFileName;
+  unsigned numOfWorkers = 0;
+  bool cameraPipelines = false;
+  ProcessingResolution halfResolution;
+  for(int i = 1; i < argc; ++i)
+    if(!strcmp(argv[i], "-n") && i + 1 < argc)
+      maxFrames = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-r") && i + 1 < argc)
+      replayed.insert(argv[++i]);
+    else if(!strcmp(argv[i], "-c") && i + 1 < argc)
+      csvFileName = argv[++i];
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+      savedFileName = argv[++i];
+    else if(!strcmp(argv[i], "-v") && i + 1 < argc)
+      verifiedFileName = argv[++i];
+    else if(!strcmp(argv[i], "-w") && i + 1 < argc)
+      numOfWorkers = (unsigned) atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-d") && i + 1 < argc)
+      debugRequests.push_back(argv[++i]);
+    else if(!strcmp(argv[i], "-p"))
+      cameraPipelines = true;
+    else if(!strcmp(argv[i], "-half"))
+    {
+      halfResolution.upperHalf = halfResolution.lowerHalf = true;
+      ProcessingResolutionProvider::forceResolution(&halfResolution);
+    }
+    else if(*argv[i] == '-' || fileName != "")
+      return usage();
+    else
+      fileName = argv[i];
+  if(fileName == "")
+    return usage();
+
+  PerceptionBench bench;
+  if(!bench.open(fileName, replayed, numOfWorkers, cameraPipelines))
+    return EXIT_FAILURE;
+  for(const std::string& debugRequest : debugRequests)
+    bench.activateDebugRequest(debugRequest);
+  if(csvFileName != "" && !bench.measurePerformanceCounters())
+    fprintf(stderr, "Performance counters are not available. Only times are written to %s.\n", csvFileName.c_str());
+  bench.run(maxFrames);
+  bench.print(stdout);
+
+  if(csvFileName != "")
+  {
+    FILE* csvFile = fopen(csvFileName.c_str(), "w");
+    if(!csvFile)
+    {
+      fprintf(stderr, "Cannot write %s!\n", csvFileName.c_str());
+      return EXIT_FAILURE;
+    }
+    bench.printCsv(csvFile);
+    fclose(csvFile);
+  }
+
+  if(savedFileName != "" && !bench.saveChecksums(savedFileName))
+  {
+    fprintf(stderr, "Cannot write %s!\n", savedFileName.c_str());
+    return EXIT_FAILURE;
+  }
+  if(verifiedFileName != "" && !bench.verifyChecksums(verifiedFileName, stderr))
+    return EXIT_FAILURE;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,438 @@
+/**
+* @file PerceptionBench.cpp
+* Implementation of a class that replays a log file through the modules of the category
+* "Perception" as fast as possible and measures how long each of them takes.
+*/
+
+#include "PerceptionBench.h"
+#include "Modules/Infrastructure/CognitionLogDataProvider.h"
+#include "Tools/MessageQueue/MessageIDs.h"
+#include "Tools/Streams/InStreams.h"
+#include "Tools/Streams/OutStreams.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+static const char* categories[] = {"Cognition Infrastructure", "Perception"};
+
+/**
+* The function determines whether a module is executed by the bench.
+* @param module The name of the module.
+* @return Is the module part of one of the categories executed?
+*/
+static bool isLocal(const std::string& module)
+{
+  if(module == "default")
+    return true;
+  const char* category = ModuleManager::getCategory(module);
+  if(category)
+    for(const char* c : categories)
+      if(!strcmp(c, category))
+        return true;
+  return false;
+}
+
+/**
+* The function determines whether a module belongs to the category "Perception".
+* @param module The name of the module.
+* @return Is it a perception module?
+*/
+static bool isPerception(const std::string& module)
+{
+  const char* category = ModuleManager::getCategory(module);
+  return category && !strcmp(category, "Perception");
+}
+
+float PerceptionBench::Statistics::getMean() const
+{
+  unsigned long long sum = 0;
+  for(unsigned time : times)
+    sum += time;
+  return times.empty() ? 0.f : float(sum) / float(times.size());
+}
+
+unsigned PerceptionBench::Statistics::getPercentile(float percent) const
+{
+  if(times.empty())
+    return 0;
+  std::vector<unsigned> sorted(times);
+  const size_t index = std::min(sorted.size() - 1, size_t(percent / 100.f * float(sorted.size())));
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  return sorted[index];
+}
+
+unsigned PerceptionBench::Statistics::getMax() const
+{
+  return times.empty() ? 0 : *std::max_element(times.begin(), times.end());
+}
+
+PerceptionBench::PerceptionBench() :
+  Process(debugIn, debugOut),
+  logPlayer(frameQueue),
+  moduleManager(0),
+  processIdentifier('c'),
+  frames(0),
+  duration(0)
+{
+  debugOut.setSize(10000000);
+  teamOut.setSize(1384); // as in Cognition
+  Global::theTeamOut = &teamOut.out;
+  frameQueue.setSize(10000000);
+  logPlayer.setSize(std::numeric_limits<unsigned>::max()); // max. 4 GB
+}
+
+PerceptionBench::~PerceptionBench()
+{
+  delete moduleManager;
+}
+
+bool PerceptionBench::open(const std::string& fileName, const std::set<std::string>& replayed, unsigned numOfWorkers,
+                           bool cameraPipelines)
+{
+  if(!logPlayer.open(fileName.c_str()))
+  {
+    OUTPUT_ERROR("Cannot open log file " << fileName << "!");
+    return false;
+  }
+
+  // Forget everything measured with a previous log file.
+  delete moduleManager;
+  providers.clear();
+  representations.clear();
+  modules.clear();
+  stopwatches.clear();
+  percepts.clear();
+  frames = 0;
+  duration = 0;
+
+  moduleManager = new ModuleManager(categories, sizeof(categories) / sizeof(*categories));
+  moduleManager->setNumOfWorkers(numOfWorkers);
+  moduleManager->setCameraPipelines(cameraPipelines);
+  ModuleManager::Configuration config = getConfiguration(replayed);
+  OutBinarySize size;
+  size << config;
+  std::vector<char> buffer(size.getSize());
+  OutBinaryMemory out(buffer.data());
+  out << config;
+  InBinaryMemory in(buffer.data(), buffer.size());
+  moduleManager->update(in);
+
+  // The modules are created when they are executed the first time. Only then,
+  // the CognitionLogDataProvider is able to receive the data of the first frame.
+  // This execution is not measured.
+  timingManager.signalProcessStart();
+  moduleManager->execute();
+  timingManager.signalProcessStop();
+  debugOut.clear();
+  teamOut.clear();
+
+  for(const auto& provider : moduleManager->getCurrentProviders())
+  {
+    representations.insert(provider.first);
+    if(isPerception(provider.second))
+      providers[provider.first] = provider.second;
+  }
+
+  if(providers.empty())
+  {
+    OUTPUT_ERROR("No module of the category Perception is selected in modules.cfg!");
+    return false;
+  }
+  return true;
+}
+
+ModuleManager::Configuration PerceptionBench::getConfiguration(const std::set<std::string>& replayed)
+{
+  ModuleManager::Configuration config;
+  InMapFile stream("modules.cfg");
+  if(stream.exists())
+    stream >> config;
+  else
+    OUTPUT_ERROR("failed to load modules.cfg correctly.");
+
+  // Which representations are replayed by the CognitionLogDataProvider?
+  std::set<std::string> logged;
+  int frequency[numOfDataMessageIDs];
+  logPlayer.statistics(frequency);
+  for(int i = idImage; i < numOfDataMessageIDs; ++i) // idImage is the first
+    if(frequency[i])
+    {
+      std::string representation = std::string(::getName(MessageID(i))).substr(2);
+      if(representation == "JPEGImage" || representation == "LosslessImage")
+        representation = "Image";
+      if(ModuleManager::provides("CognitionLogDataProvider", representation))
+        logged.insert(representation);
+      if(representation == "Image")
+        logged.insert("FrameInfo"); // replaying an image also sets the frame info
+    }
+
+  // Which module provides which representation in this process or elsewhere?
+  std::map<std::string, std::string> provider;
+  for(const auto& rp : config.representationProviders)
+    if(isLocal(rp.provider) || provider.find(rp.representation) == provider.end())
+      provider[rp.representation] = rp.provider;
+
+  // Logged representations that are not computed by perception modules are replayed.
+  // Representations that are computed elsewhere and not replayed are unavailable.
+  std::set<std::string> replay, unavailable;
+  for(const std::string& representation : logged)
+    if(replayed.find(representation) != replayed.end() || !isPerception(provider[representation]))
+      replay.insert(representation);
+  for(const auto& p : provider)
+    if(!isLocal(p.second) && replay.find(p.first) == replay.end())
+      unavailable.insert(p.first);
+
+  // Perception modules that depend on unavailable data cannot compute their results
+  // either. Replay them if possible.
+  for(bool changed = true; changed;)
+  {
+    changed = false;
+    for(const auto& p : provider)
+      if(isLocal(p.second) && replay.find(p.first) == replay.end() && unavailable.find(p.first) == unavailable.end())
+        for(const std::string& requirement : ModuleManager::getRequirements(p.second))
+          if(unavailable.find(requirement) != unavailable.end())
+          {
+            if(logged.find(p.first) != logged.end())
+              replay.insert(p.first);
+            else
+              unavailable.insert(p.first);
+            changed = true;
+            break;
+          }
+  }
+
+  for(const std::string& representation : replay)
+  {
+    for(auto i = config.representationProviders.begin(); i != config.representationProviders.end();)
+      if(i->representation == representation && isLocal(i->provider))
+        i = config.representationProviders.erase(i);
+      else
+        ++i;
+    config.representationProviders.push_back(ModuleManager::Configuration::RepresentationProvider(representation, "CognitionLogDataProvider"));
+  }
+  return config;
+}
+
+bool PerceptionBench::handleMessage(InMessage& message)
+{
+  if(message.getMessageID() == idProcessBegin)
+  {
+    message.bin >> processIdentifier;
+    return true;
+  }
+  else
+    return CognitionLogDataProvider::handleMessage(message);
+}
+
+void PerceptionBench::activateDebugRequest(const std::string& name)
+{
+  Global::getDebugRequestTable().addRequest(DebugRequest(name));
+}
+
+int PerceptionBench::run(int maxFrames)
+{
+  ASSERT(moduleManager);
+  logPlayer.stop();
+  const unsigned startTime = SystemCall::getRealSystemTime();
+  while(frames < maxFrames)
+  {
+    const int frameNumber = logPlayer.currentFrameNumber;
+    logPlayer.stepForward();
+    if(logPlayer.currentFrameNumber == frameNumber)
+      break; // end of log file
+
+    frameQueue.handleAllMessages(*this);
+    frameQueue.clear();
+
+    // Frames of the process Motion only update the data replayed.
+    if(CognitionLogDataProvider::isFrameDataComplete() && processIdentifier != 'm')
+    {
+      processMain();
+      ++frames;
+    }
+    debugOut.clear();
+    teamOut.clear();
+  }
+
+  timingManager.signalProcessStart();
+  moduleManager->finishPendingImage([this] {imageFinished();});
+  timingManager.signalProcessStop();
+  debugOut.clear();
+  teamOut.clear();
+  duration += unsigned(SystemCall::getRealTimeSince(startTime));
+  return frames;
+}
+
+bool PerceptionBench::main()
+{
+  timingManager.signalProcessStart();
+  moduleManager->execute(0, [this] {imageFinished();});
+  timingManager.signalProcessStop();
+  return false;
+}
+
+void PerceptionBench::imageFinished()
+{
+  timingManager.signalProcessStop();
+  measure();
+  timingManager.signalProcessStart();
+}
+
+void PerceptionBench::measure()
+{
+  std::map<std::string, unsigned> frameTimes;
+  for(const auto& time : timingManager.getTimes())
+  {
+    std::map<std::string, std::string>::const_iterator i = providers.find(time.first);
+    if(i != providers.end())
+      frameTimes[i->second] += time.second;
+    else if(representations.find(time.first) == representations.end())
+      stopwatches[time.first].times.push_back(time.second);
+  }
+
+  unsigned total = 0;
+  for(const auto& frameTime : frameTimes)
+  {
+    modules[frameTime.first].times.push_back(frameTime.second);
+    total += frameTime.second;
+  }
+  modules["(total)"].times.push_back(total);
+
+  if(timingManager.hasPerformanceCounters())
+    for(const auto& counts : timingManager.getCounters())
+    {
+      std::map<std::string, std::string>::const_iterator i = providers.find(counts.first);
+      if(i != providers.end())
+        for(int j = 0; j < PerformanceCounters::numOfCounters; ++j)
+        {
+          modules[i->second].counts.counts[j] += counts.second.counts[j];
+          modules["(total)"].counts.counts[j] += counts.second.counts[j];
+        }
+      else if(representations.find(counts.first) == representations.end())
+        for(int j = 0; j < PerformanceCounters::numOfCounters; ++j)
+          stopwatches[counts.first].counts.counts[j] += counts.second.counts[j];
+    }
+
+  for(const auto& provider : providers)
+  {
+    OutBinaryChecksum stream(percepts[provider.first].checksum);
+    VERIFY(moduleManager->writeRepresentation(provider.first, stream));
+  }
+}
+
+bool PerceptionBench::measurePerformanceCounters()
+{
+  return timingManager.setPerformanceCounters(true);
+}
+
+void PerceptionBench::print(FILE* stream) const
+{
+  fprintf(stream, "%d frames in %u ms\n\n", frames, duration);
+  fprintf(stream, "%-32s %10s %10s %10s\n", "module [us]", "mean", "p95", "max");
+  for(const auto& module : modules)
+    fprintf(stream, "%-32s %10.1f %10u %10u\n", module.first.c_str(),
+            module.second.getMean(), module.second.getPercentile(95.f), module.second.getMax());
+
+  if(!stopwatches.empty())
+  {
+    fprintf(stream, "\n%-32s %10s %10s %10s\n", "stopwatch [us]", "mean", "p95", "max");
+    for(const auto& stopwatch : stopwatches)
+      fprintf(stream, "%-32s %10.1f %10u %10u\n", stopwatch.first.c_str(),
+              stopwatch.second.getMean(), stopwatch.second.getPercentile(95.f), stopwatch.second.getMax());
+  }
+
+  fprintf(stream, "\n%-32s %10s\n", "representation", "checksum");
+  for(const auto& percept : percepts)
+    fprintf(stream, "%-32s   %08x\n", percept.first.c_str(), percept.second.checksum);
+}
+
+void PerceptionBench::printCsv(FILE* stream) const
+{
+  fprintf(stream, "module,frames,mean us,p95 us,max us");
+  for(int i = 0; i < PerformanceCounters::numOfCounters; ++i)
+    fprintf(stream, ",%s", PerformanceCounters::getName(PerformanceCounters::Counter(i)));
+  fprintf(stream, ",ipc\n");
+
+  for(const std::map<std::string, Statistics>* table : {&modules, &stopwatches})
+    for(const auto& entry : *table)
+    {
+      const Statistics& statistics = entry.second;
+      const double numOfFrames = statistics.times.empty() ? 1. : double(statistics.times.size());
+      fprintf(stream, "%s,%u,%.1f,%u,%u", entry.first.c_str(), unsigned(statistics.times.size()),
+              statistics.getMean(), statistics.getPercentile(95.f), statistics.getMax());
+      for(int i = 0; i < PerformanceCounters::numOfCounters; ++i)
+        fprintf(stream, ",%.0f", double(statistics.counts.counts[i]) / numOfFrames);
+      const unsigned long long cycles = statistics.counts.counts[PerformanceCounters::cycles];
+      fprintf(stream, ",%.2f\n", cycles ? double(statistics.counts.counts[PerformanceCounters::instructions]) / double(cycles) : 0.);
+    }
+}
+
+bool PerceptionBench::saveChecksums(const std::string& fileName) const
+{
+  FILE* file = fopen(fileName.c_str(), "w");
+  if(!file)
+    return false;
+  fprintf(file, "frames %d\n", frames);
+  for(const auto& percept : percepts)
+    fprintf(file, "%s %08x\n", percept.first.c_str(), percept.second.checksum);
+  fclose(file);
+  return true;
+}
+
+bool PerceptionBench::verifyChecksums(const std::string& fileName, FILE* stream) const
+{
+  FILE* file = fopen(fileName.c_str(), "r");
+  if(!file)
+  {
+    fprintf(stream, "Cannot read %s!\n", fileName.c_str());
+    return false;
+  }
+
+  std::map<std::string, unsigned> reference;
+  int referenceFrames = -1;
+  char name[256];
+  unsigned checksum;
+  while(fscanf(file, "%255s", name) == 1)
+  {
+    if(!strcmp(name, "frames"))
+    {
+      if(fscanf(file, "%d", &referenceFrames) != 1)
+        break;
+    }
+    else if(fscanf(file, "%x", &checksum) == 1)
+      reference[name] = checksum;
+    else
+      break;
+  }
+  fclose(file);
+
+  bool equal = true;
+  if(referenceFrames != frames)
+  {
+    fprintf(stream, "%d frames were measured, but %s contains checksums over %d frames.\n", frames, fileName.c_str(), referenceFrames);
+    equal = false;
+  }
+  for(const auto& percept : percepts)
+  {
+    std::map<std::string, unsigned>::const_iterator i = reference.find(percept.first);
+    if(i == reference.end())
+    {
+      fprintf(stream, "%s is missing in %s.\n", percept.first.c_str(), fileName.c_str());
+      equal = false;
+    }
+    else if(i->second != percept.second.checksum)
+    {
+      fprintf(stream, "%s differs: %08x instead of %08x.\n", percept.first.c_str(), percept.second.checksum, i->second);
+      equal = false;
+    }
+  }
+  for(const auto& r : reference)
+    if(percepts.find(r.first) == percepts.end())
+    {
+      fprintf(stream, "%s was not computed.\n", r.first.c_str());
+      equal = false;
+    }
+  if(equal)
+    fprintf(stream, "All checksums are equal to the ones in %s.\n", fileName.c_str());
+  return equal;
+}
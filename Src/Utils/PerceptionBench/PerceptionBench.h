@@ -0,0 +1,189 @@
+/**
+* @file PerceptionBench.h
+* Declaration of a class that replays a log file through the modules of the category
+* "Perception" as fast as possible and measures how long each of them takes.
+* It runs without the simulator and without any views.
+*/
+
+#pragma once
+
+#include "Controller/LogPlayer.h"
+#include "Tools/MessageQueue/MessageQueue.h"
+#include "Tools/Module/ModuleManager.h"
+#include "Tools/ProcessFramework/Process.h"
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+* @class PerceptionBench
+* The class is a process that is not run by a process framework. Instead, it is
+* triggered for each frame of a log file and executes the modules of the categories
+* "Cognition Infrastructure" and "Perception".
+* Representations that are contained in the log file are replayed by the
+* CognitionLogDataProvider unless a module of the category "Perception" computes
+* them from data that is available.
+*/
+class PerceptionBench : public Process
+{
+public:
+  /**
+  * The statistics of a module or a representation.
+  */
+  class Statistics
+  {
+  public:
+    std::vector<unsigned> times; /**< The time in us spent in each frame. */
+    unsigned checksum; /**< The checksum over the data written in all frames. */
+    PerformanceCounters::Values counts; /**< The sums of the performance counters over all frames. */
+
+    Statistics() : checksum(2166136261u) {}
+
+    /**
+    * The method returns the average time.
+    * @return The mean of all times in us.
+    */
+    float getMean() const;
+
+    /**
+    * The method returns a percentile of the times.
+    * @param percent The percentage of times that are lower or equal to the result.
+    * @return The percentile in us.
+    */
+    unsigned getPercentile(float percent) const;
+
+    /**
+    * The method returns the maximum time.
+    * @return The maximum in us.
+    */
+    unsigned getMax() const;
+  };
+
+private:
+  MessageQueue debugIn; /**< The queue of incoming debug messages. It remains empty. */
+  MessageQueue debugOut; /**< The queue debug output of the modules is written to. It is cleared every frame. */
+  MessageQueue teamOut; /**< The queue team messages are written to, e.g. by the TeamDataSender. It is cleared every frame. */
+  MessageQueue frameQueue; /**< The queue the log player copies the messages of the current frame into. */
+  LogPlayer logPlayer; /**< The log player that contains the log file. */
+  ModuleManager* moduleManager; /**< The module manager that executes the modules. Created after the globals were set. */
+  char processIdentifier; /**< The identifier of the process that recorded the current frame ('c', 'd', or 'm'). */
+  std::map<std::string, std::string> providers; /**< The modules of the category "Perception" by the representations they provide. */
+  std::set<std::string> representations; /**< All representations provided in this process, i.e. the names of the stopwatches of their providers. */
+  std::map<std::string, Statistics> modules; /**< The statistics of all modules of the category "Perception". */
+  std::map<std::string, Statistics> stopwatches; /**< The statistics of all other stopwatches, e.g. within the modules. */
+  std::map<std::string, Statistics> percepts; /**< The checksums of all representations provided by modules of the category "Perception". */
+  int frames; /**< The number of frames measured. */
+  unsigned duration; /**< The real time in ms all frames took. */
+
+  /**
+  * The method determines the module configuration. It uses the one from "modules.cfg",
+  * but lets the CognitionLogDataProvider provide all representations that are
+  * contained in the log file and cannot be computed by a module of the category
+  * "Perception".
+  * @param replayed Representations that should always be replayed from the log file.
+  * @return The module configuration.
+  */
+  ModuleManager::Configuration getConfiguration(const std::set<std::string>& replayed);
+
+  /**
+  * The method collects the times and checksums of the image finished last.
+  * It is called for each image, i.e. up to twice per frame with camera pipelines.
+  */
+  void measure();
+
+  /**
+  * The method is called whenever the modules were executed for an image.
+  * It measures the image and restarts the timing for the next one.
+  */
+  void imageFinished();
+
+  /**
+  * The method executes the modules for the current frame and measures them.
+  * @return Always false, since the bench never waits.
+  */
+  bool main();
+
+  /**
+  * The method handles the messages of the frame currently replayed.
+  * @param message The message that can be read.
+  * @return Was the message handled?
+  */
+  bool handleMessage(InMessage& message);
+
+public:
+  /**
+  * Constructor.
+  */
+  PerceptionBench();
+
+  /**
+  * Destructor.
+  */
+  ~PerceptionBench();
+
+  /**
+  * The method opens a log file and sets up the modules.
+  * @param fileName The name of the log file.
+  * @param replayed Representations that should always be replayed from the log file.
+  * @param numOfWorkers The number of worker threads that execute concurrent modules.
+  *                     0 executes all modules sequentially.
+  * @param cameraPipelines Execute the modules of the category "Perception" for the images
+  *                        of both cameras in parallel?
+  * @return Was the log file opened and are there modules of the category "Perception" to execute?
+  */
+  bool open(const std::string& fileName, const std::set<std::string>& replayed, unsigned numOfWorkers = 0,
+            bool cameraPipelines = false);
+
+  /**
+  * The method activates a debug request for all frames replayed.
+  * @param name The name of the debug request, e.g. "module:ScanGridProvider:benchmark".
+  */
+  void activateDebugRequest(const std::string& name);
+
+  /**
+  * The method replays the log file once. An image still pending in a camera pipeline
+  * is finished at the end.
+  * @param maxFrames The maximum number of frames measured.
+  * @return The number of frames measured.
+  */
+  int run(int maxFrames);
+
+  /**
+  * The method enables measuring the hardware performance counters of the modules.
+  * It must be called by the thread that calls run().
+  * @return Are the performance counters available?
+  */
+  bool measurePerformanceCounters();
+
+  /**
+  * The method writes the statistics of all modules, stopwatches, and representations.
+  * @param stream The stream the table is written to.
+  */
+  void print(FILE* stream) const;
+
+  /**
+  * The method writes the statistics of all modules and stopwatches as comma-separated values,
+  * including the average performance counters per frame if they were measured.
+  * @param stream The stream the table is written to.
+  */
+  void printCsv(FILE* stream) const;
+
+  /**
+  * The method writes the checksums of all representations to a file.
+  * Each line contains the name of a representation and its checksum.
+  * @param fileName The name of the file.
+  * @return Could the file be written?
+  */
+  bool saveChecksums(const std::string& fileName) const;
+
+  /**
+  * The method compares the checksums of all representations with the ones
+  * stored in a file by saveChecksums.
+  * @param fileName The name of the file.
+  * @param stream The stream all differences are reported to.
+  * @return Were all checksums found and equal?
+  */
+  bool verifyChecksums(const std::string& fileName, FILE* stream) const;
+};